@@ -0,0 +1,129 @@
+/*
+Created on Mon Oct 19 15:20:41 2026
+@author: Harshil Bhatt
+*/
+
+
+/*  Chunked transfer protocol shared by sendfile-server.cpp and
+    chunked-client.cpp.
+
+    The plain port (9001) keeps the original behaviour of streaming the whole
+    file. On the chunked port (9002) the client sends newline terminated
+    requests and may pipeline several of them on one connection:
+
+        META                  ->  SIZE <bytes> CHUNK <bytes> COUNT <n>
+                                  <n lines of 16 hex digit XXH64 chunk hashes>
+                                  END
+        GET <offset> <length> ->  <length> raw bytes of the file
+
+    Any request the server cannot satisfy is answered with "ERR <reason>" and
+    the connection is closed.
+*/
+
+#ifndef CHUNK_PROTOCOL_H
+#define CHUNK_PROTOCOL_H
+
+#include <stdint.h>
+#include <string.h>
+#include <stddef.h>
+
+#define CHUNKED_PORT        9002
+#define DEFAULT_CHUNK_SIZE  (4 << 20)
+#define MAX_REQUEST_LINE    128
+
+
+// XXH64 (https://github.com/Cyan4973/xxHash), inlined so neither side needs
+// the library. Reads are done through memcpy so unaligned chunk boundaries
+// inside an mmap()ed file are fine.
+namespace xxh {
+
+static const uint64_t PRIME1 = 11400714785074694791ULL;
+static const uint64_t PRIME2 = 14029467366897019727ULL;
+static const uint64_t PRIME3 =  1609587929392839161ULL;
+static const uint64_t PRIME4 =  9650029242287828579ULL;
+static const uint64_t PRIME5 =  2870177450012600261ULL;
+
+static inline uint64_t rotl(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+static inline uint64_t read64(const uint8_t *p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint32_t read32(const uint8_t *p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint64_t round(uint64_t acc, uint64_t input) {
+    acc += input * PRIME2;
+    acc = rotl(acc, 31);
+    return acc * PRIME1;
+}
+
+static inline uint64_t mergeRound(uint64_t acc, uint64_t val) {
+    acc ^= round(0, val);
+    return acc * PRIME1 + PRIME4;
+}
+
+static inline uint64_t hash64(const void *data, size_t len, uint64_t seed = 0) {
+    const uint8_t *p = (const uint8_t *)data;
+    const uint8_t *end = p + len;
+    uint64_t h;
+
+    if (len >= 32) {
+        const uint8_t *limit = end - 32;
+        uint64_t v1 = seed + PRIME1 + PRIME2;
+        uint64_t v2 = seed + PRIME2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - PRIME1;
+        do {
+            v1 = round(v1, read64(p));
+            v2 = round(v2, read64(p + 8));
+            v3 = round(v3, read64(p + 16));
+            v4 = round(v4, read64(p + 24));
+            p += 32;
+        } while (p <= limit);
+
+        h = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+        h = mergeRound(h, v1);
+        h = mergeRound(h, v2);
+        h = mergeRound(h, v3);
+        h = mergeRound(h, v4);
+    } else {
+        h = seed + PRIME5;
+    }
+
+    h += (uint64_t)len;
+
+    while (p + 8 <= end) {
+        h ^= round(0, read64(p));
+        h = rotl(h, 27) * PRIME1 + PRIME4;
+        p += 8;
+    }
+    if (p + 4 <= end) {
+        h ^= (uint64_t)read32(p) * PRIME1;
+        h = rotl(h, 23) * PRIME2 + PRIME3;
+        p += 4;
+    }
+    while (p < end) {
+        h ^= (*p) * PRIME5;
+        h = rotl(h, 11) * PRIME1;
+        ++p;
+    }
+
+    h ^= h >> 33;
+    h *= PRIME2;
+    h ^= h >> 29;
+    h *= PRIME3;
+    h ^= h >> 32;
+    return h;
+}
+
+}   // namespace xxh
+
+#endif /* CHUNK_PROTOCOL_H */
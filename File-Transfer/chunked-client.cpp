@@ -0,0 +1,334 @@
+/*
+Created on Mon Oct 19 15:48:03 2026
+@author: Harshil Bhatt
+*/
+
+
+/*  Resumable, parallel client for the chunked port of sendfile-server.cpp.
+
+    The server advertises the file size and an XXH64 hash per chunk. The
+    output file is preallocated and mmap()ed, chunks that already hash
+    correctly (left over from an interrupted run) are skipped, and the rest
+    are fetched over several TCP connections straight into the mapping.
+    Every connection keeps a second GET in flight so the pipe stays full on
+    high latency links. A chunk that fails verification is fetched again.
+
+    Build and run
+        g++ -O2 -std=c++17 -pthread -o chunked-client chunked-client.cpp
+        ./chunked-client -o received_file [-H 127.0.0.1] [-p 9002] [-j 4]
+*/
+
+#include <bits/stdc++.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+
+#include "chunk-protocol.h"
+
+using namespace std;
+
+#define TCP_IP       "127.0.0.1"
+#define MAX_RETRIES  3
+#define PIPELINE     2      // GET requests kept in flight per connection
+
+
+class Meta {
+    public:
+        off_t size = 0;
+        off_t chunkSize = 0;
+        vector<uint64_t> hashes;
+
+        off_t chunkOffset(size_t i) const { return (off_t)i * chunkSize; }
+        size_t chunkLength(size_t i) const {
+            return (size_t)min(chunkSize, size - chunkOffset(i));
+        }
+};
+
+
+// Buffered reader for the line oriented part of the protocol; bytes it has
+// read ahead are handed to the first range that follows.
+class Stream {
+    public:
+        explicit Stream(int sock) : sock(sock) {}
+        bool readLine(string &line);
+        bool readExact(uint8_t *dst, size_t len);
+        bool writeAll(const string &s);
+
+        int sock;
+
+    private:
+        string pending;
+};
+
+bool Stream::readLine(string &line) {
+    while (true) {
+        size_t nl = pending.find('\n');
+        if (nl != string::npos) {
+            line = pending.substr(0, nl);
+            pending.erase(0, nl + 1);
+            return true;
+        }
+        char buff[4096];
+        ssize_t n = recv(sock, buff, sizeof(buff), 0);
+        if (n <= 0)
+            return false;
+        pending.append(buff, n);
+    }
+}
+
+bool Stream::readExact(uint8_t *dst, size_t len) {
+    size_t got = min(len, pending.size());
+    memcpy(dst, pending.data(), got);
+    pending.erase(0, got);
+
+    while (got < len) {
+        ssize_t n = recv(sock, dst + got, len - got, MSG_WAITALL);
+        if (n <= 0)
+            return false;
+        got += n;
+    }
+    return true;
+}
+
+bool Stream::writeAll(const string &s) {
+    size_t sent = 0;
+    while (sent < s.size()) {
+        ssize_t n = send(sock, s.data() + sent, s.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0)
+            return false;
+        sent += n;
+    }
+    return true;
+}
+
+
+int connectTo(const char *ip, int port) {
+    int sock = socket(AF_INET, SOCK_STREAM, 0);
+    if (sock < 0)
+        return -1;
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    inet_pton(AF_INET, ip, &addr.sin_addr);
+    if (connect(sock, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+        close(sock);
+        return -1;
+    }
+    return sock;
+}
+
+
+bool fetchMeta(const char *ip, int port, Meta &meta) {
+    int sock = connectTo(ip, port);
+    if (sock < 0) {
+        perror("connect");
+        return false;
+    }
+
+    Stream stream(sock);
+    string line;
+    long long size, chunk, count;
+    bool ok = stream.writeAll("META\n") && stream.readLine(line) &&
+              sscanf(line.c_str(), "SIZE %lld CHUNK %lld COUNT %lld", &size, &chunk, &count) == 3;
+    // The chunk table has to cover the file exactly before anything is
+    // mapped or offsets are derived from it
+    ok = ok && chunk > 0 && size >= 0 && count == size / chunk + (size % chunk != 0);
+    if (ok) {
+        meta.size = size;
+        meta.chunkSize = chunk;
+        for (long long i = 0; ok && i < count; ++i) {
+            ok = stream.readLine(line);
+            meta.hashes.push_back(strtoull(line.c_str(), NULL, 16));
+        }
+        ok = ok && stream.readLine(line) && line == "END";
+    }
+    if (!ok)
+        fprintf(stderr, "Bad META reply: %s\n", line.c_str());
+
+    close(sock);
+    return ok;
+}
+
+
+// Chunks still to be fetched, shared by all connections
+class WorkQueue {
+    public:
+        bool pop(size_t &chunk) {
+            lock_guard<mutex> lock(m);
+            if (pending.empty())
+                return false;
+            chunk = pending.front();
+            pending.pop_front();
+            return true;
+        }
+        void push(size_t chunk) {
+            lock_guard<mutex> lock(m);
+            pending.push_back(chunk);
+        }
+
+        deque<size_t> pending;
+        mutex m;
+};
+
+
+class Download {
+    public:
+        Download(const Meta &meta, uint8_t *out) : meta(meta), out(out), retries(meta.hashes.size()) {}
+        void worker(const char *ip, int port);
+
+        const Meta &meta;
+        uint8_t *out;
+        WorkQueue queue;
+        vector<atomic<int>> retries;
+        atomic<bool> failed{false};
+        atomic<uint64_t> fetched{0};
+};
+
+void Download::worker(const char *ip, int port) {
+    int sock = connectTo(ip, port);
+    if (sock < 0) {
+        perror("connect");
+        failed = true;
+        return;
+    }
+    Stream stream(sock);
+    deque<size_t> inflight;
+
+    auto request = [&]() {
+        size_t chunk;
+        if (!queue.pop(chunk))
+            return true;
+        inflight.push_back(chunk);
+        return stream.writeAll("GET " + to_string(meta.chunkOffset(chunk)) + " " +
+                               to_string(meta.chunkLength(chunk)) + "\n");
+    };
+
+    bool ok = true;
+    for (int i = 0; ok && i < PIPELINE; ++i)
+        ok = request();
+
+    while (ok && !inflight.empty() && !failed) {
+        size_t chunk = inflight.front();
+        inflight.pop_front();
+
+        uint8_t *dst = out + meta.chunkOffset(chunk);
+        size_t len = meta.chunkLength(chunk);
+        ok = stream.readExact(dst, len);
+        if (!ok) {
+            queue.push(chunk);
+            break;
+        }
+
+        if (xxh::hash64(dst, len) == meta.hashes[chunk]) {
+            fetched += len;
+        } else if (++retries[chunk] <= MAX_RETRIES) {
+            fprintf(stderr, "Chunk %zu failed verification, retrying\n", chunk);
+            queue.push(chunk);
+        } else {
+            fprintf(stderr, "Chunk %zu failed verification %d times\n", chunk, MAX_RETRIES);
+            failed = true;
+        }
+        ok = request();
+    }
+
+    // Hand anything we could not finish back to the other connections
+    for (size_t chunk : inflight)
+        queue.push(chunk);
+    if (!ok)
+        fprintf(stderr, "Connection lost, remaining chunks left to other streams\n");
+    close(sock);
+}
+
+
+int main(int argc, char *argv[]) {
+    const char *ip = TCP_IP;
+    int port = CHUNKED_PORT;
+    int streams = 4;
+    string filename;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "H:p:j:o:")) != -1) {
+        switch (opt) {
+            case 'H': ip = optarg; break;
+            case 'p': port = atoi(optarg); break;
+            case 'j': streams = max(1, atoi(optarg)); break;
+            case 'o': filename = optarg; break;
+            default: break;
+        }
+    }
+    if (filename.empty()) {
+        fprintf(stderr, "Usage: %s -o <file to be saved as> [-H host] [-p port] [-j streams]\n", argv[0]);
+        return 1;
+    }
+
+    Meta meta;
+    if (!fetchMeta(ip, port, meta))
+        return 1;
+
+    int fd = open(filename.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        perror(filename.c_str());
+        return 1;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        perror(filename.c_str());
+        return 1;
+    }
+    bool resume = st.st_size == meta.size;
+    if (!resume && (ftruncate(fd, meta.size) != 0 ||
+                    (meta.size > 0 && posix_fallocate(fd, 0, meta.size) != 0))) {
+        perror("preallocate");
+        return 1;
+    }
+
+    uint8_t *out = NULL;
+    if (meta.size > 0) {
+        out = (uint8_t *)mmap(NULL, meta.size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (out == MAP_FAILED) {
+            perror("mmap");
+            return 1;
+        }
+    }
+
+    Download download(meta, out);
+    size_t skipped = 0;
+    for (size_t i = 0; i < meta.hashes.size(); ++i) {
+        if (resume && xxh::hash64(out + meta.chunkOffset(i), meta.chunkLength(i)) == meta.hashes[i])
+            ++skipped;
+        else
+            download.queue.pending.push_back(i);
+    }
+    printf("File size %lld bytes, %zu chunks, %zu already present\n",
+           (long long)meta.size, meta.hashes.size(), skipped);
+
+    auto start = chrono::steady_clock::now();
+    int workers = (int)min<size_t>(streams, download.queue.pending.size());
+    vector<thread> threads;
+    for (int i = 0; i < workers; ++i)
+        threads.emplace_back(&Download::worker, &download, ip, port);
+    for (auto &t : threads)
+        t.join();
+    double secs = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    if (out != NULL) {
+        msync(out, meta.size, MS_SYNC);
+        munmap(out, meta.size);
+    }
+    close(fd);
+
+    if (download.failed || !download.queue.pending.empty()) {
+        printf("Transfer incomplete, run again to resume\n");
+        return 1;
+    }
+    printf("Successfully received the file: %llu bytes over %d streams in %.3f s (%.1f MB/s)\n",
+           (unsigned long long)download.fetched.load(), workers, secs,
+           secs > 0 ? download.fetched / secs / 1e6 : 0.0);
+    return 0;
+}
@@ -0,0 +1,511 @@
+/*
+Created on Mon Oct 19 14:05:12 2026
+@author: Harshil Bhatt
+*/
+
+
+/*  Zero-copy file transfer server.
+
+    Wire compatible with client.py: every accepted connection is sent the
+    whole file and then closed, so the client simply reads until EOF.
+    Unlike server.py (one thread per connection, 1024 byte read()/send()
+    pairs) all connections are driven from a single epoll loop and the data
+    never leaves the kernel: regular files go out through sendfile(), pipes
+    and FIFOs through splice().
+
+    A second port speaks the chunked protocol from chunk-protocol.h: the file
+    size and per-chunk XXH64 hashes are advertised once, and clients fetch
+    byte ranges over as many parallel connections as they like (see
+    chunked-client.cpp). Ranges are sent with sendfile() as well.
+
+    Build and run
+        g++ -O2 -std=c++17 -o sendfile-server sendfile-server.cpp
+        ./sendfile-server [-f intro.txt] [-b 127.0.0.1] [-p 9001] [-c 9002] [-s chunk bytes] [-v]
+*/
+
+#include <bits/stdc++.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <signal.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/sendfile.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+
+#include "chunk-protocol.h"
+
+using namespace std;
+
+#define TCP_IP      "127.0.0.1"
+#define TCP_PORT    9001
+#define MAX_EVENTS  1024
+#define CHUNK_SIZE  (1 << 20)   // upper bound for a single sendfile()/splice() call
+
+
+// Open files are kept for the lifetime of the server. sendfile() takes an
+// explicit offset, so one descriptor is shared by every concurrent download
+// of the same regular file. Pipes cannot be shared (reading consumes them),
+// so they are opened per connection and never cached.
+class FileCache {
+    public:
+        class Entry {
+            public:
+                int fd;
+                off_t size;
+                bool isPipe;
+        };
+
+        ~FileCache();
+        bool open(const string &path, Entry &entry);
+
+    private:
+        unordered_map<string, Entry> files;
+};
+
+FileCache::~FileCache() {
+    for (auto &f : files)
+        close(f.second.fd);
+}
+
+bool FileCache::open(const string &path, Entry &entry) {
+    auto it = files.find(path);
+    if (it != files.end()) {
+        entry = it->second;
+        return true;
+    }
+
+    int fd = ::open(path.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        close(fd);
+        return false;
+    }
+
+    entry.fd = fd;
+    entry.size = st.st_size;
+    entry.isPipe = S_ISFIFO(st.st_mode);
+    if (!entry.isPipe) {
+        posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+        files[path] = entry;
+    }
+    return true;
+}
+
+
+class Connection {
+    public:
+        int sock = -1;
+        uint32_t generation = 0;    // tells this connection from an earlier one on the same sock
+        int fd = -1;            // source file or pipe
+        bool isPipe = false;
+        off_t offset = 0;       // next byte to send
+        off_t end = 0;          // one past the last byte to send
+
+        // Chunked protocol only
+        bool chunked = false;
+        bool closing = false;   // close once 'out' has been flushed
+        string in;              // unparsed request bytes
+        string out;             // pending reply text
+        size_t outPos = 0;
+};
+
+
+enum Progress { BLOCKED, DONE, FAILED };
+
+
+class Server {
+    public:
+        Server(const string &path, off_t chunkSize, bool verbose)
+            : path(path), chunkSize(chunkSize), verbose(verbose) {}
+        void listenOn(const char *ip, int port, int chunkedPort);
+        void run();
+
+    private:
+        int makeListener(const char *ip, int port);
+        void acceptAll(int listener);
+        void startTransfer(int sock);
+        void startChunked(int sock);
+        // Sends file bytes in [offset, end)
+        Progress pump(Connection &c);
+        // Returns true once the connection is finished and can be closed
+        bool service(Connection &c);
+        bool serviceChunked(Connection &c);
+        void handleRequest(Connection &c, const string &line);
+        const string &metaReply(const FileCache::Entry &file);
+        void finish(Connection &c);
+        // Epoll data of c: generation above the descriptor
+        static uint64_t eventKey(const Connection &c) { return (uint64_t)c.generation << 32 | (uint32_t)c.sock; }
+        uint32_t nextGeneration() { return ++generations ? generations : ++generations; }
+
+        string path;
+        off_t chunkSize;
+        bool verbose;
+        int listenfd = -1;
+        int chunkfd = -1;
+        int epfd = -1;
+        string meta;                // cached META reply
+        FileCache cache;
+        vector<Connection> conns;   // indexed by socket descriptor
+        uint32_t generations = 0;   // connections started so far, listeners are generation 0
+        uint64_t served = 0;
+};
+
+
+int Server::makeListener(const char *ip, int port) {
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        perror("socket");
+        exit(1);
+    }
+
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if (inet_pton(AF_INET, ip, &addr.sin_addr) != 1) {
+        fprintf(stderr, "Invalid bind address %s\n", ip);
+        exit(1);
+    }
+
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+        perror("bind");
+        exit(1);
+    }
+    if (listen(fd, SOMAXCONN) != 0) {
+        perror("listen");
+        exit(1);
+    }
+
+    struct epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.u64 = (uint32_t)fd;
+    epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &ev);
+    return fd;
+}
+
+
+void Server::listenOn(const char *ip, int port, int chunkedPort) {
+    epfd = epoll_create1(EPOLL_CLOEXEC);
+    listenfd = makeListener(ip, port);
+    chunkfd = makeListener(ip, chunkedPort);
+    printf("Serving %s on %s:%d (chunked on port %d)\n", path.c_str(), ip, port, chunkedPort);
+}
+
+
+void Server::run() {
+    struct epoll_event events[MAX_EVENTS];
+
+    while (true) {
+        int n = epoll_wait(epfd, events, MAX_EVENTS, -1);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            perror("epoll_wait");
+            exit(1);
+        }
+
+        for (int i = 0; i < n; ++i) {
+            int fd = (int)(uint32_t)events[i].data.u64;
+            uint32_t generation = events[i].data.u64 >> 32;
+            if (generation == 0 && (fd == listenfd || fd == chunkfd)) {
+                acceptAll(fd);
+                continue;
+            }
+
+            // Skip events of a connection finished earlier in this batch,
+            // its descriptor may already belong to a newly accepted one.
+            // A hang-up may still leave data in a pipe, so drain before closing
+            Connection &c = conns[fd];
+            if (c.sock < 0 || c.generation != generation)
+                continue;
+            if (service(c) || (events[i].events & EPOLLERR))
+                finish(c);
+        }
+    }
+}
+
+
+void Server::acceptAll(int listener) {
+    while (true) {
+        struct sockaddr_in cli;
+        socklen_t len = sizeof(cli);
+        int sock = accept4(listener, (struct sockaddr *)&cli, &len, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (sock < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+                perror("accept4");
+            return;
+        }
+
+        if (verbose) {
+            char ip[INET_ADDRSTRLEN];
+            inet_ntop(AF_INET, &cli.sin_addr, ip, sizeof(ip));
+            printf("Got connection from %s:%d\n", ip, ntohs(cli.sin_port));
+        }
+        if (listener == chunkfd)
+            startChunked(sock);
+        else
+            startTransfer(sock);
+    }
+}
+
+
+void Server::startTransfer(int sock) {
+    FileCache::Entry file;
+    if (!cache.open(path, file)) {
+        perror(path.c_str());
+        close(sock);
+        return;
+    }
+
+    if ((size_t)sock >= conns.size())
+        conns.resize(sock + 1);
+
+    Connection &c = conns[sock];
+    c = Connection();
+    c.sock = sock;
+    c.generation = nextGeneration();
+    c.fd = file.fd;
+    c.isPipe = file.isPipe;
+    c.end = file.size;
+
+    // Most downloads fit in the socket buffer and finish right here,
+    // without ever being registered with epoll.
+    if (service(c)) {
+        finish(c);
+        return;
+    }
+
+    struct epoll_event ev;
+    ev.events = EPOLLOUT | EPOLLET;
+    ev.data.u64 = eventKey(c);
+    epoll_ctl(epfd, EPOLL_CTL_ADD, sock, &ev);
+
+    // A drained pipe leaves the socket writable, so wait for input as well
+    if (c.isPipe) {
+        ev.events = EPOLLIN | EPOLLET;
+        epoll_ctl(epfd, EPOLL_CTL_ADD, c.fd, &ev);
+    }
+}
+
+
+void Server::startChunked(int sock) {
+    if ((size_t)sock >= conns.size())
+        conns.resize(sock + 1);
+
+    Connection &c = conns[sock];
+    c = Connection();
+    c.sock = sock;
+    c.generation = nextGeneration();
+    c.chunked = true;
+
+    struct epoll_event ev;
+    ev.events = EPOLLIN | EPOLLOUT | EPOLLET;
+    ev.data.u64 = eventKey(c);
+    epoll_ctl(epfd, EPOLL_CTL_ADD, sock, &ev);
+}
+
+
+Progress Server::pump(Connection &c) {
+    while (c.isPipe || c.offset < c.end) {
+        ssize_t sent;
+        if (c.isPipe) {
+            sent = splice(c.fd, NULL, c.sock, NULL, CHUNK_SIZE, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+            if (sent == 0)
+                return DONE;    // writer closed the pipe
+        } else {
+            size_t count = (size_t)min<off_t>(c.end - c.offset, CHUNK_SIZE);
+            sent = sendfile(c.sock, c.fd, &c.offset, count);
+            if (sent == 0)
+                return FAILED;  // file was truncated underneath us
+        }
+
+        if (sent < 0) {
+            if (errno == EINTR)
+                continue;
+            return (errno == EAGAIN || errno == EWOULDBLOCK) ? BLOCKED : FAILED;
+        }
+    }
+    return DONE;
+}
+
+
+bool Server::service(Connection &c) {
+    if (c.chunked)
+        return serviceChunked(c);
+    return pump(c) != BLOCKED;
+}
+
+
+// Runs until the socket would block: flush the pending reply, send the
+// requested range, then parse the next (possibly already pipelined) request.
+bool Server::serviceChunked(Connection &c) {
+    while (true) {
+        while (c.outPos < c.out.size()) {
+            ssize_t n = send(c.sock, c.out.data() + c.outPos, c.out.size() - c.outPos, MSG_NOSIGNAL);
+            if (n < 0) {
+                if (errno == EINTR)
+                    continue;
+                return errno != EAGAIN && errno != EWOULDBLOCK;
+            }
+            c.outPos += n;
+        }
+        c.out.clear();
+        c.outPos = 0;
+        if (c.closing)
+            return true;
+
+        if (c.offset < c.end) {
+            Progress p = pump(c);
+            if (p == BLOCKED)
+                return false;
+            if (p == FAILED)
+                return true;
+        }
+
+        size_t nl = c.in.find('\n');
+        if (nl != string::npos) {
+            string line = c.in.substr(0, nl);
+            c.in.erase(0, nl + 1);
+            handleRequest(c, line);
+            continue;
+        }
+        if (c.in.size() > MAX_REQUEST_LINE)
+            return true;
+
+        char buff[4096];
+        ssize_t n = recv(c.sock, buff, sizeof(buff), 0);
+        if (n > 0) {
+            c.in.append(buff, n);
+        } else if (n == 0) {
+            return true;        // client is done
+        } else if (errno != EINTR) {
+            return errno != EAGAIN && errno != EWOULDBLOCK;
+        }
+    }
+}
+
+
+void Server::handleRequest(Connection &c, const string &line) {
+    FileCache::Entry file;
+    if (!cache.open(path, file) || file.isPipe) {
+        c.out = "ERR file is not seekable\n";
+        c.closing = true;
+        return;
+    }
+
+    unsigned long long offset, length;
+    if (line == "META") {
+        c.out = metaReply(file);
+    } else if (sscanf(line.c_str(), "GET %llu %llu", &offset, &length) == 2 &&
+               length > 0 && offset < (unsigned long long)file.size &&
+               length <= (unsigned long long)file.size - offset) {
+        c.fd = file.fd;
+        c.offset = offset;
+        c.end = offset + length;
+    } else {
+        c.out = "ERR bad request\n";
+        c.closing = true;
+    }
+}
+
+
+// Hashed once per server run; every client of the file reuses the reply
+const string &Server::metaReply(const FileCache::Entry &file) {
+    if (!meta.empty())
+        return meta;
+
+    off_t count = (file.size + chunkSize - 1) / chunkSize;
+    char line[96];
+    snprintf(line, sizeof(line), "SIZE %lld CHUNK %lld COUNT %lld\n",
+             (long long)file.size, (long long)chunkSize, (long long)count);
+    meta = line;
+
+    if (file.size > 0) {
+        void *map = mmap(NULL, file.size, PROT_READ, MAP_PRIVATE, file.fd, 0);
+        if (map == MAP_FAILED) {
+            perror("mmap");
+            exit(1);
+        }
+        const uint8_t *data = (const uint8_t *)map;
+        for (off_t off = 0; off < file.size; off += chunkSize) {
+            size_t len = (size_t)min(chunkSize, file.size - off);
+            snprintf(line, sizeof(line), "%016llx\n",
+                     (unsigned long long)xxh::hash64(data + off, len));
+            meta += line;
+        }
+        munmap(map, file.size);
+    }
+    meta += "END\n";
+    return meta;
+}
+
+
+void Server::finish(Connection &c) {
+    if (c.isPipe)
+        close(c.fd);
+    close(c.sock);      // also removes it from the epoll set
+    c.sock = -1;
+    c.fd = -1;
+    ++served;
+    if (verbose)
+        printf("Transfers completed: %llu\n", (unsigned long long)served);
+}
+
+
+// Thousands of concurrent downloads need thousands of descriptors
+static void raiseFileLimit() {
+    struct rlimit rl;
+    if (getrlimit(RLIMIT_NOFILE, &rl) == 0 && rl.rlim_cur < rl.rlim_max) {
+        rl.rlim_cur = rl.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &rl);
+    }
+}
+
+
+int main(int argc, char *argv[]) {
+    string path = "intro.txt";
+    const char *ip = TCP_IP;
+    int port = TCP_PORT;
+    int chunkedPort = CHUNKED_PORT;
+    off_t chunkSize = DEFAULT_CHUNK_SIZE;
+    bool verbose = false;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "f:b:p:c:s:v")) != -1) {
+        switch (opt) {
+            case 'f': path = optarg; break;
+            case 'b': ip = optarg; break;
+            case 'p': port = atoi(optarg); break;
+            case 'c': chunkedPort = atoi(optarg); break;
+            case 's': chunkSize = atoll(optarg); break;
+            case 'v': verbose = true; break;
+            default:
+                fprintf(stderr, "Usage: %s [-f file] [-b bind address] [-p port] "
+                                "[-c chunked port] [-s chunk bytes] [-v]\n", argv[0]);
+                return 1;
+        }
+    }
+    if (chunkSize <= 0) {
+        fprintf(stderr, "Chunk size must be positive\n");
+        return 1;
+    }
+
+    signal(SIGPIPE, SIG_IGN);
+    raiseFileLimit();
+
+    Server server(path, chunkSize, verbose);
+    server.listenOn(ip, port, chunkedPort);
+    server.run();
+    return 0;
+}
@@ -0,0 +1,220 @@
+/*
+Created on Mon Oct 19 16:30:15 2026
+@author: Harshil Bhatt
+*/
+
+
+/*  Small helpers shared by the native event-loop tools in this directory
+    (port-scanner.cpp, banner-grabber.cpp): target/port list parsing,
+    non-blocking connect, RTT based timeouts and a token bucket.
+*/
+
+#ifndef ASYNC_NET_H
+#define ASYNC_NET_H
+
+#include <bits/stdc++.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+
+using namespace std;
+
+
+inline double nowSeconds() {
+    return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+class Target {
+    public:
+        struct in_addr addr;
+        string name;
+};
+
+
+// Comma separated list of host names, dotted quads and a.b.c.d/n ranges
+inline bool parseTargets(const string &spec, vector<Target> &targets) {
+    stringstream ss(spec);
+    string item;
+    while (getline(ss, item, ',')) {
+        if (item.empty())
+            continue;
+
+        size_t slash = item.find('/');
+        if (slash != string::npos) {
+            struct in_addr base;
+            int bits = atoi(item.c_str() + slash + 1);
+            if (inet_pton(AF_INET, item.substr(0, slash).c_str(), &base) != 1 || bits < 0 || bits > 32)
+                return false;
+            uint32_t mask = bits == 0 ? 0 : 0xffffffffu << (32 - bits);
+            uint32_t first = ntohl(base.s_addr) & mask;
+            uint32_t last = first | ~mask;
+            for (uint64_t a = first; a <= last; ++a) {
+                Target t;
+                t.addr.s_addr = htonl((uint32_t)a);
+                t.name = inet_ntoa(t.addr);
+                targets.push_back(t);
+            }
+            continue;
+        }
+
+        struct addrinfo hints, *res;
+        memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_STREAM;
+        if (getaddrinfo(item.c_str(), NULL, &hints, &res) != 0)
+            return false;
+        Target t;
+        t.addr = ((struct sockaddr_in *)res->ai_addr)->sin_addr;
+        t.name = item;
+        targets.push_back(t);
+        freeaddrinfo(res);
+    }
+    return !targets.empty();
+}
+
+
+// Comma separated list of ports and lo-hi ranges, e.g. "22,80,8000-8100"
+inline bool parsePorts(const string &spec, vector<uint16_t> &ports) {
+    stringstream ss(spec);
+    string item;
+    while (getline(ss, item, ',')) {
+        if (item.empty())
+            continue;
+        int lo, hi;
+        size_t dash = item.find('-');
+        lo = atoi(item.c_str());
+        hi = dash == string::npos ? lo : atoi(item.c_str() + dash + 1);
+        if (lo < 1 || hi > 65535 || lo > hi)
+            return false;
+        for (int p = lo; p <= hi; ++p)
+            ports.push_back((uint16_t)p);
+    }
+    return !ports.empty();
+}
+
+
+// Starts a non-blocking connect. Returns the socket, or -1 on failure.
+// 'status' is 0 when the connection completed immediately (common on
+// loopback), EINPROGRESS when it is pending, or the errno it failed with.
+inline int startConnect(struct in_addr addr, uint16_t port, int &status) {
+    int sock = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (sock < 0) {
+        status = errno;
+        return -1;
+    }
+
+    struct sockaddr_in sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sin_family = AF_INET;
+    sa.sin_port = htons(port);
+    sa.sin_addr = addr;
+    status = connect(sock, (struct sockaddr *)&sa, sizeof(sa)) == 0 ? 0 : errno;
+    return sock;
+}
+
+
+inline int socketError(int sock) {
+    int err = 0;
+    socklen_t len = sizeof(err);
+    if (getsockopt(sock, SOL_SOCKET, SO_ERROR, &err, &len) != 0)
+        return errno;
+    return err;
+}
+
+
+// Close with RST instead of FIN so probed ports do not sit in TIME_WAIT
+inline void abortiveClose(int sock) {
+    struct linger lg = {1, 0};
+    setsockopt(sock, SOL_SOCKET, SO_LINGER, &lg, sizeof(lg));
+    close(sock);
+}
+
+
+// Retransmission timeout estimator from RFC 6298, used as a per host
+// connect/read timeout. Until the first sample arrives 'initial' is used.
+class RttEstimator {
+    public:
+        RttEstimator(double initial = 1.0, double minRto = 0.05, double maxRto = 5.0)
+            : rto(initial), minRto(minRto), maxRto(maxRto) {}
+
+        void sample(double rtt) {
+            if (samples++ == 0) {
+                srtt = rtt;
+                rttvar = rtt / 2;
+            } else {
+                rttvar = 0.75 * rttvar + 0.25 * fabs(srtt - rtt);
+                srtt = 0.875 * srtt + 0.125 * rtt;
+            }
+            rto = min(maxRto, max(minRto, srtt + 4 * rttvar));
+        }
+
+        double timeout() const { return rto; }
+        double smoothed() const { return srtt; }
+        uint64_t count() const { return samples; }
+
+    private:
+        double srtt = 0;
+        double rttvar = 0;
+        double rto;
+        double minRto;
+        double maxRto;
+        uint64_t samples = 0;
+};
+
+
+// Limits the rate of new connections; rate <= 0 means unlimited
+class TokenBucket {
+    public:
+        TokenBucket(double rate, double burst) : rate(rate), burst(max(1.0, burst)), tokens(this->burst) {}
+
+        bool take(double now) {
+            if (rate <= 0)
+                return true;
+            refill(now);
+            if (tokens < 1)
+                return false;
+            tokens -= 1;
+            return true;
+        }
+
+        // Seconds until the next token is available
+        double wait(double now) {
+            if (rate <= 0)
+                return 0;
+            refill(now);
+            return tokens >= 1 ? 0 : (1 - tokens) / rate;
+        }
+
+    private:
+        void refill(double now) {
+            if (last > 0)
+                tokens = min(burst, tokens + (now - last) * rate);
+            last = now;
+        }
+
+        double rate;
+        double burst;
+        double tokens;
+        double last = 0;
+};
+
+
+// Thousands of sockets in flight need thousands of descriptors; returns
+// the usable limit
+inline rlim_t raiseFileLimit() {
+    struct rlimit rl;
+    if (getrlimit(RLIMIT_NOFILE, &rl) != 0)
+        return 1024;
+    if (rl.rlim_cur < rl.rlim_max) {
+        rl.rlim_cur = rl.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &rl);
+    }
+    return rl.rlim_cur;
+}
+
+#endif /* ASYNC_NET_H */
@@ -0,0 +1,230 @@
+/*
+Created on Mon Oct 19 18:15:09 2026
+@author: Harshil Bhatt
+*/
+
+
+/*  Local stand-in service farm for banner-grabber.cpp.
+
+    Listens on a block of consecutive loopback ports and answers like a
+    small zoo of servers, cycling through the service types by port:
+
+        port % 4 == 0   SSH   identification line, then close
+        port % 4 == 1   SMTP  220 greeting, answers EHLO and QUIT
+        port % 4 == 2   HTTP  silent until a request, then a HEAD reply
+        port % 4 == 3   FTP   220 greeting, then close
+
+    Two software versions are handed out per service so the grabber's
+    index has something to deduplicate. Everything runs on one epoll loop.
+
+    Build and run
+        g++ -O2 -std=c++17 -o banner-farm banner-farm.cpp
+        ./banner-farm [-b 9100] [-n 400]
+*/
+
+#include <sys/epoll.h>
+
+#include "async-net.h"
+
+#define MAX_EVENTS 1024
+
+
+enum Service { SSH, SMTP, HTTP, FTP };
+
+
+class Listener {
+    public:
+        uint16_t port;
+        Service service;
+        int version;
+};
+
+
+class Client {
+    public:
+        Service service;
+        int version;
+        string in;
+};
+
+
+static const char *greeting(Service service, int version) {
+    static const char *text[4][2] = {
+        { "SSH-2.0-OpenSSH_8.9p1 Ubuntu-3\r\n", "SSH-2.0-dropbear_2020.81\r\n" },
+        { "220 mail.farm.local ESMTP Postfix\r\n", "220 mx.farm.local ESMTP Exim 4.94\r\n" },
+        { NULL, NULL },
+        { "220 (vsFTPd 3.0.3)\r\n", "220 ProFTPD Server ready.\r\n" },
+    };
+    return text[service][version];
+}
+
+
+class Farm {
+    public:
+        void listenOn(uint16_t base, int count);
+        void run();
+
+    private:
+        void accept(int listenfd);
+        void onReadable(int sock);
+        void reply(int sock, const string &text, bool closeAfter);
+        void drop(int sock);
+
+        int epfd = -1;
+        unordered_map<int, Listener> listeners;
+        vector<Client> clients;     // indexed by socket
+        vector<bool> open;
+        uint64_t served = 0;
+};
+
+
+void Farm::listenOn(uint16_t base, int count) {
+    epfd = epoll_create1(EPOLL_CLOEXEC);
+
+    for (int i = 0; i < count; ++i) {
+        uint16_t port = base + i;
+        int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        int one = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+        struct sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(fd, SOMAXCONN) != 0) {
+            fprintf(stderr, "Cannot listen on port %u: %s\n", port, strerror(errno));
+            close(fd);
+            continue;
+        }
+
+        listeners[fd] = {port, (Service)(port % 4), (port / 4) % 2};
+        struct epoll_event ev;
+        ev.events = EPOLLIN;
+        ev.data.fd = fd;
+        epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &ev);
+    }
+    printf("Farm listening on 127.0.0.1:%u-%u\n", base, base + count - 1);
+}
+
+
+void Farm::accept(int listenfd) {
+    const Listener &l = listeners[listenfd];
+    while (true) {
+        int sock = accept4(listenfd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (sock < 0)
+            return;
+        ++served;
+
+        if ((size_t)sock >= clients.size()) {
+            clients.resize(sock + 1);
+            open.resize(sock + 1);
+        }
+        clients[sock] = {l.service, l.version, string()};
+        open[sock] = true;
+
+        struct epoll_event ev;
+        ev.events = EPOLLIN | EPOLLRDHUP;
+        ev.data.fd = sock;
+        epoll_ctl(epfd, EPOLL_CTL_ADD, sock, &ev);
+
+        // Everything but HTTP talks first
+        if (l.service != HTTP)
+            reply(sock, greeting(l.service, l.version), l.service == SSH || l.service == FTP);
+    }
+}
+
+
+// Replies are a few dozen bytes, far below the socket buffer
+void Farm::reply(int sock, const string &text, bool closeAfter) {
+    if (send(sock, text.data(), text.size(), MSG_NOSIGNAL) < 0 || closeAfter)
+        drop(sock);
+}
+
+
+void Farm::onReadable(int sock) {
+    Client &c = clients[sock];
+    char buff[2048];
+    while (true) {
+        ssize_t n = recv(sock, buff, sizeof(buff), 0);
+        if (n > 0) {
+            c.in.append(buff, n);
+            continue;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            break;
+        drop(sock);
+        return;
+    }
+
+    if (c.service == HTTP) {
+        if (c.in.find("\r\n\r\n") != string::npos)
+            reply(sock, string("HTTP/1.0 200 OK\r\nServer: ") + (c.version ? "nginx/1.18.0" : "Apache/2.4.41") +
+                        "\r\nContent-Length: 0\r\n\r\n", true);
+        return;
+    }
+
+    if (c.service == SMTP) {
+        // Pipelined commands may arrive in one segment; answer each line
+        size_t nl;
+        while (open[sock] && (nl = c.in.find('\n')) != string::npos) {
+            string cmd = c.in.substr(0, nl);
+            c.in.erase(0, nl + 1);
+            if (strncasecmp(cmd.c_str(), "EHLO", 4) == 0)
+                reply(sock, "250-farm.local\r\n250-PIPELINING\r\n250 8BITMIME\r\n", false);
+            else if (strncasecmp(cmd.c_str(), "QUIT", 4) == 0)
+                reply(sock, "221 Bye\r\n", true);
+            else
+                reply(sock, "502 Command not implemented\r\n", false);
+        }
+    }
+}
+
+
+void Farm::drop(int sock) {
+    open[sock] = false;
+    clients[sock].in.clear();
+    close(sock);
+}
+
+
+void Farm::run() {
+    struct epoll_event events[MAX_EVENTS];
+    while (true) {
+        int n = epoll_wait(epfd, events, MAX_EVENTS, -1);
+        for (int i = 0; i < n; ++i) {
+            int fd = events[i].data.fd;
+            if (listeners.count(fd))
+                accept(fd);
+            else if ((size_t)fd < open.size() && open[fd])
+                onReadable(fd);
+        }
+    }
+}
+
+
+int main(int argc, char *argv[]) {
+    int base = 9100;
+    int count = 400;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "b:n:")) != -1) {
+        switch (opt) {
+            case 'b': base = atoi(optarg); break;
+            case 'n': count = atoi(optarg); break;
+            default:
+                fprintf(stderr, "Usage: %s [-b base port] [-n number of ports]\n", argv[0]);
+                return 1;
+        }
+    }
+    if (base < 1 || count < 1 || base + count - 1 > 65535) {
+        fprintf(stderr, "Port range out of bounds\n");
+        return 1;
+    }
+
+    raiseFileLimit();
+    Farm farm;
+    farm.listenOn((uint16_t)base, count);
+    farm.run();
+    return 0;
+}
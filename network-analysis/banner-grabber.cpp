@@ -0,0 +1,468 @@
+/*
+Created on Mon Oct 19 17:40:22 2026
+@author: Harshil Bhatt
+*/
+
+
+/*  Concurrent banner grabber.
+
+    banner-grabbing.py connects to one host/port at a time with a blocking
+    socket. Here every host x port pair is a connection multiplexed on one
+    epoll loop, each with its own read deadline, and the probe depends on
+    the service:
+
+        SSH   (22)            wait for the "SSH-" identification line
+        SMTP  (25, 587)       wait for the 220 greeting, then pipeline
+                              EHLO and QUIT in a single write
+        HTTP  (80, 8000, ...) send HEAD / right after connecting
+        other                 wait for a greeting (an ESMTP greeting
+                              switches to the SMTP probe); if the service
+                              stays silent, fall back to the HTTP probe
+
+    Identical banners are folded into one in-memory index entry listing all
+    the endpoints that returned them. banner-farm.cpp provides a local set
+    of stand-in services to measure throughput against.
+
+    Only probe hosts you are authorised to audit.
+
+    Build and run
+        g++ -O2 -std=c++17 -o banner-grabber banner-grabber.cpp
+        ./banner-grabber -H 127.0.0.1 -p 9100-9499 [-c 1024] [-r 0] [-t 2000] [-w 300] [-v]
+*/
+
+#include <sys/epoll.h>
+
+#include "async-net.h"
+
+#define MAX_EVENTS  1024
+#define MAX_BANNER  2048
+
+
+enum Service { PASSIVE, SSH, SMTP, HTTP };
+
+Service serviceFor(uint16_t port) {
+    switch (port) {
+        case 22: case 2222:
+            return SSH;
+        case 25: case 587: case 2525:
+            return SMTP;
+        case 80: case 8000: case 8008: case 8080: case 8888:
+            return HTTP;
+        default:
+            return PASSIVE;
+    }
+}
+
+
+class Connection {
+    public:
+        uint32_t host;
+        uint16_t port;
+        Service service;
+        bool connected = false;
+        bool probed = false;    // our request has been written
+        string in;
+        string out;
+        size_t outPos = 0;
+        double start = 0;
+        uint32_t seq = 0;
+};
+
+
+class Timer {
+    public:
+        double deadline;
+        int sock;
+        uint32_t seq;
+        bool operator>(const Timer &o) const { return deadline > o.deadline; }
+};
+
+
+// Banner text -> endpoints that returned it
+class BannerIndex {
+    public:
+        void add(const string &banner, const string &endpoint) {
+            auto it = index.find(banner);
+            if (it == index.end()) {
+                order.push_back(banner);
+                it = index.emplace(banner, vector<string>()).first;
+            }
+            it->second.push_back(endpoint);
+        }
+
+        void print() const {
+            for (const string &banner : order) {
+                const vector<string> &endpoints = index.at(banner);
+                printf("[+] %s\n    %zu endpoint(s):", banner.c_str(), endpoints.size());
+                for (size_t i = 0; i < endpoints.size() && i < 8; ++i)
+                    printf(" %s", endpoints[i].c_str());
+                if (endpoints.size() > 8)
+                    printf(" ...");
+                printf("\n");
+            }
+        }
+
+        size_t size() const { return order.size(); }
+
+    private:
+        unordered_map<string, vector<string>> index;
+        vector<string> order;
+};
+
+
+class Grabber {
+    public:
+        Grabber(const vector<Target> &targets, const vector<uint16_t> &ports, size_t concurrency,
+                double rate, double readTimeout, double greetWait, bool verbose)
+            : targets(targets), ports(ports), concurrency(concurrency), bucket(rate, max(1.0, rate / 100)),
+              readTimeout(readTimeout), greetWait(greetWait), verbose(verbose) {}
+
+        void run();
+
+        BannerIndex index;
+        uint64_t attempted = 0;
+        uint64_t grabbed = 0;
+
+    private:
+        bool launch();
+        void onConnected(int sock);
+        void onEvent(int sock, uint32_t events);
+        void onTimeout(int sock);
+        bool flush(Connection &c, int sock);
+        void sendProbe(Connection &c, int sock, const string &probe);
+        bool complete(const Connection &c) const;
+        void finish(int sock);
+        void arm(int sock, double timeout);
+
+        const vector<Target> &targets;
+        const vector<uint16_t> &ports;
+        size_t concurrency;
+        TokenBucket bucket;
+        double readTimeout;
+        double greetWait;
+        bool verbose;
+
+        int epfd = -1;
+        size_t next = 0;
+        vector<Connection> conns;   // indexed by socket
+        vector<bool> active;
+        size_t activeCount = 0;
+        double launchAt = 0;        // no launches before, set while out of descriptors
+        uint32_t seq = 0;
+        priority_queue<Timer, vector<Timer>, greater<Timer>> timers;
+};
+
+
+bool Grabber::launch() {
+    uint32_t host = next % targets.size();
+    uint16_t port = ports[next / targets.size()];
+
+    int status;
+    int sock = startConnect(targets[host].addr, port, status);
+    if (sock < 0) {
+        // Out of descriptors: try again once some connections have finished,
+        // or after a pause if none are open to free one
+        launchAt = activeCount > 0 ? HUGE_VAL : nowSeconds() + 0.01;
+        return false;
+    }
+    ++next;
+    ++attempted;
+
+    if ((size_t)sock >= conns.size()) {
+        conns.resize(sock + 1);
+        active.resize(sock + 1);
+    }
+    Connection &c = conns[sock];
+    c = Connection();
+    c.host = host;
+    c.port = port;
+    c.service = serviceFor(port);
+    c.start = nowSeconds();
+    c.seq = ++seq;
+    active[sock] = true;
+    ++activeCount;
+
+    if (status != 0 && status != EINPROGRESS) {
+        finish(sock);
+        return true;
+    }
+
+    struct epoll_event ev;
+    ev.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP;
+    ev.data.fd = sock;
+    epoll_ctl(epfd, EPOLL_CTL_ADD, sock, &ev);
+    arm(sock, readTimeout);
+    return true;
+}
+
+
+void Grabber::arm(int sock, double timeout) {
+    timers.push({nowSeconds() + timeout, sock, conns[sock].seq});
+}
+
+
+void Grabber::onConnected(int sock) {
+    Connection &c = conns[sock];
+    c.connected = true;
+
+    struct epoll_event ev;
+    ev.events = EPOLLIN | EPOLLRDHUP;
+    ev.data.fd = sock;
+    epoll_ctl(epfd, EPOLL_CTL_MOD, sock, &ev);
+
+    if (c.service == HTTP) {
+        sendProbe(c, sock, "HEAD / HTTP/1.0\r\nHost: " + targets[c.host].name + "\r\n\r\n");
+    } else if (c.service == PASSIVE) {
+        // Silent services get the HTTP probe once this shorter timer fires
+        c.seq = ++seq;
+        arm(sock, greetWait);
+    }
+}
+
+
+void Grabber::sendProbe(Connection &c, int sock, const string &probe) {
+    c.probed = true;
+    c.out = probe;
+    c.outPos = 0;
+    c.seq = ++seq;
+    arm(sock, readTimeout);
+    if (!flush(c, sock) && active[sock]) {
+        struct epoll_event ev;
+        ev.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP;
+        ev.data.fd = sock;
+        epoll_ctl(epfd, EPOLL_CTL_MOD, sock, &ev);
+    }
+}
+
+
+// Returns true once the whole probe has been written. A hard send error
+// finishes the connection and returns false, callers check active[sock]
+bool Grabber::flush(Connection &c, int sock) {
+    while (c.outPos < c.out.size()) {
+        ssize_t n = send(sock, c.out.data() + c.outPos, c.out.size() - c.outPos, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+                finish(sock);
+            return false;
+        }
+        c.outPos += n;
+    }
+    return true;
+}
+
+
+// Whether enough has been read to stop waiting for the server
+bool Grabber::complete(const Connection &c) const {
+    if (c.in.size() >= MAX_BANNER)
+        return true;
+    switch (c.service) {
+        case SSH:
+            return c.in.find('\n') != string::npos;
+        case HTTP:
+            return c.in.find("\r\n\r\n") != string::npos;
+        case SMTP:
+            // Final line of the EHLO reply is "250 " rather than "250-"
+            return c.probed && (c.in.find("\n250 ") != string::npos || c.in.find("\n5") != string::npos);
+        default:
+            if (c.probed)
+                return c.in.find("\r\n\r\n") != string::npos;
+            return c.in.find('\n') != string::npos;
+    }
+}
+
+
+void Grabber::onEvent(int sock, uint32_t events) {
+    Connection &c = conns[sock];
+
+    if (!c.connected) {
+        if (socketError(sock) != 0) {
+            finish(sock);
+            return;
+        }
+        onConnected(sock);
+        if (!active[sock])
+            return;
+    }
+
+    if ((events & EPOLLOUT) && c.outPos < c.out.size()) {
+        if (flush(c, sock)) {
+            struct epoll_event ev;
+            ev.events = EPOLLIN | EPOLLRDHUP;
+            ev.data.fd = sock;
+            epoll_ctl(epfd, EPOLL_CTL_MOD, sock, &ev);
+        } else if (!active[sock]) {
+            return;
+        }
+    }
+
+    if (!(events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)))
+        return;
+
+    char buff[4096];
+    while (true) {
+        ssize_t n = recv(sock, buff, sizeof(buff), 0);
+        if (n > 0) {
+            c.in.append(buff, min<size_t>(n, MAX_BANNER - min<size_t>(c.in.size(), MAX_BANNER)));
+            continue;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            break;
+        if (n < 0 && errno == EINTR)
+            continue;
+        finish(sock);       // closed by the server or reset
+        return;
+    }
+
+    // Mail servers on non-standard ports give themselves away in the greeting
+    if (c.service == PASSIVE && !c.probed && c.in.compare(0, 4, "220 ") == 0 &&
+        c.in.find("SMTP") != string::npos)
+        c.service = SMTP;
+
+    if (c.service == SMTP && !c.probed && c.in.find('\n') != string::npos)
+        sendProbe(c, sock, "EHLO banner-grabber\r\nQUIT\r\n");
+    else if (complete(c))
+        finish(sock);
+}
+
+
+void Grabber::onTimeout(int sock) {
+    Connection &c = conns[sock];
+    if (c.connected && c.service == PASSIVE && !c.probed && c.in.empty())
+        sendProbe(c, sock, "HEAD / HTTP/1.0\r\n\r\n");
+    else
+        finish(sock);
+}
+
+
+// Collapses a raw banner to the lines that identify the service
+static string normalise(const string &raw) {
+    string text;
+    stringstream ss(raw);
+    string line;
+    while (getline(ss, line)) {
+        while (!line.empty() && (line.back() == '\r' || isspace((unsigned char)line.back())))
+            line.pop_back();
+        if (line.empty())
+            continue;
+        // HTTP: keep the status line and Server header only
+        if (raw.compare(0, 5, "HTTP/") == 0 && !text.empty() && strncasecmp(line.c_str(), "server:", 7) != 0)
+            continue;
+        for (char &ch : line)
+            if (!isprint((unsigned char)ch))
+                ch = '.';
+        if (!text.empty())
+            text += " | ";
+        text += line;
+    }
+    return text;
+}
+
+
+void Grabber::finish(int sock) {
+    Connection &c = conns[sock];
+    if (!c.in.empty()) {
+        ++grabbed;
+        string banner = normalise(c.in);
+        string endpoint = targets[c.host].name + ":" + to_string(c.port);
+        if (verbose)
+            printf("[+] %s %s (%.1f ms)\n", endpoint.c_str(), banner.c_str(), (nowSeconds() - c.start) * 1000);
+        index.add(banner, endpoint);
+    }
+
+    active[sock] = false;
+    --activeCount;
+    launchAt = 0;
+    c.in.clear();
+    c.in.shrink_to_fit();
+    close(sock);
+}
+
+
+void Grabber::run() {
+    epfd = epoll_create1(EPOLL_CLOEXEC);
+    struct epoll_event events[MAX_EVENTS];
+    size_t total = targets.size() * ports.size();
+
+    while (next < total || activeCount > 0) {
+        double now = nowSeconds();
+        // A token is only spent on a connection that actually went out
+        while (next < total && activeCount < concurrency && now >= launchAt && bucket.wait(now) <= 0) {
+            if (!launch())
+                break;
+            bucket.take(now);
+        }
+
+        double wake = 1.0;
+        if (!timers.empty())
+            wake = min(wake, timers.top().deadline - now);
+        if (now < launchAt)
+            wake = min(wake, launchAt - now);
+        else if (next < total && activeCount < concurrency)
+            wake = min(wake, bucket.wait(now));
+        int ms = (int)ceil(max(0.0, wake) * 1000);
+
+        int n = epoll_wait(epfd, events, MAX_EVENTS, ms);
+        for (int i = 0; i < n; ++i) {
+            int sock = events[i].data.fd;
+            if (active[sock])
+                onEvent(sock, events[i].events);
+        }
+
+        now = nowSeconds();
+        while (!timers.empty() && timers.top().deadline <= now) {
+            Timer t = timers.top();
+            timers.pop();
+            if (active[t.sock] && conns[t.sock].seq == t.seq)
+                onTimeout(t.sock);
+        }
+    }
+    close(epfd);
+}
+
+
+int main(int argc, char *argv[]) {
+    string hostSpec, portSpec = "21,22,25,80,110,143,587,8080";
+    size_t concurrency = 1024;
+    double rate = 0;
+    double readTimeout = 2.0;
+    double greetWait = 0.3;
+    bool verbose = false;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "H:p:c:r:t:w:v")) != -1) {
+        switch (opt) {
+            case 'H': hostSpec = optarg; break;
+            case 'p': portSpec = optarg; break;
+            case 'c': concurrency = max(1, atoi(optarg)); break;
+            case 'r': rate = atof(optarg); break;
+            case 't': readTimeout = atof(optarg) / 1000; break;
+            case 'w': greetWait = atof(optarg) / 1000; break;
+            case 'v': verbose = true; break;
+            default: break;
+        }
+    }
+
+    vector<Target> targets;
+    vector<uint16_t> ports;
+    if (hostSpec.empty() || !parseTargets(hostSpec, targets) || !parsePorts(portSpec, ports)) {
+        fprintf(stderr, "Usage: %s -H <hosts> [-p ports] [-c concurrency] [-r connects/s] "
+                        "[-t read timeout ms] [-w greeting wait ms] [-v]\n", argv[0]);
+        return 1;
+    }
+
+    rlim_t limit = raiseFileLimit();
+    concurrency = min<size_t>(concurrency, limit > 64 ? limit - 64 : 1);
+
+    double start = nowSeconds();
+    Grabber grabber(targets, ports, concurrency, rate, readTimeout, greetWait, verbose);
+    grabber.run();
+    double secs = nowSeconds() - start;
+
+    grabber.index.print();
+    printf("%llu connections, %llu banners, %zu distinct, %.3f s (%.0f connections/s)\n",
+           (unsigned long long)grabber.attempted, (unsigned long long)grabber.grabbed,
+           grabber.index.size(), secs, secs > 0 ? grabber.attempted / secs : 0.0);
+    return 0;
+}
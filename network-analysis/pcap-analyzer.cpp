@@ -0,0 +1,578 @@
+/*
+Created on Mon Oct 19 19:02:48 2026
+@author: Harshil Bhatt
+*/
+
+
+/*  Multi-threaded offline pcap analyser for the ns-3 trace/ captures.
+
+    analyze-with-wireshark.py goes through dpkt/pyshark one packet at a time.
+    This reads the capture through mmap() and decodes headers in place, no
+    packet is ever copied:
+
+        link     Ethernet (+VLAN), PPP (ns-3 point-to-point), raw IP,
+                 Linux cooked, 802.11 with or without radiotap
+        network  IPv4, IPv6 (extension headers skipped)
+        l4       TCP, UDP
+
+    and reports per-flow (bidirectional 5-tuple) statistics: packets, bytes,
+    TCP retransmissions, RTT samples (data segment to covering ACK, Karn's
+    rule), and a throughput time series.
+
+    Pass 1 splits the records into one contiguous slice per thread; every
+    thread decodes its slice and buckets the compact results by flow hash.
+    Pass 2 gives every thread one flow shard and replays the buckets in
+    capture order, so per-flow state never needs a lock.
+
+    Build and run
+        g++ -O2 -std=c++17 -pthread -o pcap-analyzer pcap-analyzer.cpp
+        ./pcap-analyzer [-j threads] [-i interval s] [-s series.csv] [-n top flows] file.pcap
+*/
+
+#include <bits/stdc++.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+using namespace std;
+
+#define DLT_EN10MB              1
+#define DLT_PPP                 9
+#define DLT_RAW                 101
+#define DLT_IEEE802_11          105
+#define DLT_LINUX_SLL           113
+#define DLT_IEEE802_11_RADIO    127
+
+#define TCP_FIN 0x01
+#define TCP_SYN 0x02
+#define TCP_ACK 0x10
+
+#define MAX_OUTSTANDING 4096    // unacknowledged segments tracked per direction for RTT
+
+
+class FlowKey {
+    public:
+        uint8_t a[16], b[16];   // endpoint addresses, a <= b
+        uint16_t portA, portB;
+        uint8_t proto;
+        uint8_t v6;
+
+        string endpoint(bool first) const {
+            char ip[INET6_ADDRSTRLEN];
+            inet_ntop(v6 ? AF_INET6 : AF_INET, first ? a : b, ip, sizeof(ip));
+            return (v6 ? "[" + string(ip) + "]" : string(ip)) + ":" + to_string(first ? portA : portB);
+        }
+};
+
+
+// What pass 2 needs to know about one packet
+class PacketInfo {
+    public:
+        double ts;
+        uint64_t flow;          // hash of the canonical FlowKey
+        uint32_t seq, ack;
+        uint32_t wireLen;
+        uint32_t payload;
+        uint8_t flags;
+        uint8_t dir;            // 0: a -> b, 1: b -> a
+        uint8_t tcp;
+};
+
+
+static inline uint16_t be16(const uint8_t *p) { return (uint16_t)(p[0] << 8 | p[1]); }
+static inline uint32_t be32(const uint8_t *p) {
+    return (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 8 | p[3];
+}
+static inline uint16_t le16(const uint8_t *p) { return (uint16_t)(p[0] | p[1] << 8); }
+
+
+static uint64_t hashKey(const FlowKey &k) {
+    // FNV-1a over the key bytes
+    const uint8_t *p = (const uint8_t *)&k;
+    uint64_t h = 1469598103934665603ULL;
+    for (size_t i = 0; i < sizeof(FlowKey); ++i)
+        h = (h ^ p[i]) * 1099511628211ULL;
+    return h;
+}
+
+
+class Capture {
+    public:
+        bool open(const char *path);
+        ~Capture();
+
+        // Record offsets; walking the headers is cheap next to decoding
+        void index(vector<size_t> &offsets) const;
+        bool decode(size_t offset, PacketInfo &info, FlowKey &key) const;
+
+        int linkType = 0;
+        size_t size = 0;
+
+    private:
+        uint32_t rd32(const uint8_t *p) const {
+            uint32_t v;
+            memcpy(&v, p, 4);
+            return swapped ? __builtin_bswap32(v) : v;
+        }
+        bool decodeIp(const uint8_t *p, size_t len, uint16_t ethertype, PacketInfo &info, FlowKey &key) const;
+
+        const uint8_t *data = NULL;
+        bool swapped = false;
+        bool nanos = false;
+};
+
+
+bool Capture::open(const char *path) {
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0) {
+        perror(path);
+        return false;
+    }
+    struct stat st;
+    fstat(fd, &st);
+    size = st.st_size;
+    if (size < 24) {
+        fprintf(stderr, "%s: too short for a pcap file\n", path);
+        close(fd);
+        return false;
+    }
+    data = (const uint8_t *)mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        perror("mmap");
+        return false;
+    }
+    madvise((void *)data, size, MADV_SEQUENTIAL);
+
+    uint32_t magic;
+    memcpy(&magic, data, 4);
+    switch (magic) {
+        case 0xa1b2c3d4: break;
+        case 0xa1b23c4d: nanos = true; break;
+        case 0xd4c3b2a1: swapped = true; break;
+        case 0x4d3cb2a1: swapped = nanos = true; break;
+        default:
+            fprintf(stderr, "%s: not a pcap file (pcapng is not supported)\n", path);
+            return false;
+    }
+    linkType = rd32(data + 20) & 0xffff;
+    return true;
+}
+
+
+Capture::~Capture() {
+    if (data != NULL && data != MAP_FAILED)
+        munmap((void *)data, size);
+}
+
+
+void Capture::index(vector<size_t> &offsets) const {
+    size_t off = 24;
+    while (off + 16 <= size) {
+        uint32_t capLen = rd32(data + off + 8);
+        if (off + 16 + capLen > size)
+            break;      // truncated last record
+        offsets.push_back(off);
+        off += 16 + capLen;
+    }
+}
+
+
+bool Capture::decode(size_t offset, PacketInfo &info, FlowKey &key) const {
+    const uint8_t *rec = data + offset;
+    uint32_t capLen = rd32(rec + 8);
+    info.ts = rd32(rec) + rd32(rec + 4) * (nanos ? 1e-9 : 1e-6);
+    info.wireLen = rd32(rec + 12);
+
+    const uint8_t *p = rec + 16;
+    size_t len = capLen;
+    uint16_t ethertype = 0;
+
+    switch (linkType) {
+        case DLT_EN10MB:
+            if (len < 14)
+                return false;
+            ethertype = be16(p + 12);
+            p += 14; len -= 14;
+            while ((ethertype == 0x8100 || ethertype == 0x88a8) && len >= 4) {
+                ethertype = be16(p + 2);
+                p += 4; len -= 4;
+            }
+            break;
+
+        case DLT_PPP: {
+            // ns-3 writes only the 2 byte protocol field; real PPP adds ff 03
+            if (len >= 2 && p[0] == 0xff && p[1] == 0x03) {
+                p += 2; len -= 2;
+            }
+            if (len < 2)
+                return false;
+            uint16_t proto = be16(p);
+            ethertype = proto == 0x0021 ? 0x0800 : proto == 0x0057 ? 0x86dd : 0;
+            p += 2; len -= 2;
+            break;
+        }
+
+        case DLT_RAW:
+            if (len < 1)
+                return false;
+            ethertype = (p[0] >> 4) == 6 ? 0x86dd : 0x0800;
+            break;
+
+        case DLT_LINUX_SLL:
+            if (len < 16)
+                return false;
+            ethertype = be16(p + 14);
+            p += 16; len -= 16;
+            break;
+
+        case DLT_IEEE802_11_RADIO:
+        case DLT_IEEE802_11: {
+            if (linkType == DLT_IEEE802_11_RADIO) {
+                if (len < 4 || le16(p + 2) > len)
+                    return false;
+                size_t rtLen = le16(p + 2);
+                p += rtLen; len -= rtLen;
+            }
+            if (len < 24)
+                return false;
+            uint8_t fc = p[0], flags = p[1];
+            uint8_t type = (fc >> 2) & 3, subtype = fc >> 4;
+            if (type != 2 || (subtype & 0x4) || (flags & 0x40))
+                return false;   // not data, null function, or encrypted
+            size_t hdr = 24;
+            if ((flags & 0x03) == 0x03)
+                hdr += 6;       // four address format
+            if (subtype & 0x8) {
+                hdr += 2;       // QoS control
+                if (flags & 0x80)
+                    hdr += 4;   // HT control
+            }
+            if (len < hdr + 8 || p[hdr] != 0xaa || p[hdr + 1] != 0xaa || p[hdr + 2] != 0x03)
+                return false;
+            ethertype = be16(p + hdr + 6);
+            p += hdr + 8; len -= hdr + 8;
+            break;
+        }
+
+        default:
+            return false;
+    }
+
+    return decodeIp(p, len, ethertype, info, key);
+}
+
+
+bool Capture::decodeIp(const uint8_t *p, size_t len, uint16_t ethertype, PacketInfo &info, FlowKey &key) const {
+    const uint8_t *src, *dst;
+    size_t addrLen;
+    uint8_t proto;
+    size_t l4Len;       // from the IP header, so snaplen truncation does not matter
+
+    memset(&key, 0, sizeof(key));
+
+    if (ethertype == 0x0800) {
+        if (len < 20 || (p[0] >> 4) != 4)
+            return false;
+        size_t ihl = (p[0] & 0x0f) * 4;
+        uint16_t total = be16(p + 2);
+        if (ihl < 20 || len < ihl || total < ihl)
+            return false;
+        if (be16(p + 6) & 0x1fff)
+            return false;       // non-first fragment has no L4 header
+        proto = p[9];
+        src = p + 12; dst = p + 16; addrLen = 4;
+        l4Len = total - ihl;
+        p += ihl; len -= ihl;
+    } else if (ethertype == 0x86dd) {
+        if (len < 40 || (p[0] >> 4) != 6)
+            return false;
+        proto = p[6];
+        l4Len = be16(p + 4);
+        src = p + 8; dst = p + 24; addrLen = 16;
+        p += 40; len -= 40;
+        // Hop-by-hop, routing, destination options and fragment headers
+        while ((proto == 0 || proto == 43 || proto == 60 || proto == 44) && len >= 8) {
+            size_t ext = proto == 44 ? 8 : (p[1] + 1) * 8;
+            if (ext > len || ext > l4Len)
+                return false;
+            proto = p[0];
+            p += ext; len -= ext; l4Len -= ext;
+        }
+        key.v6 = 1;
+    } else {
+        return false;
+    }
+
+    uint16_t sport = 0, dport = 0;
+    info.tcp = 0;
+    info.seq = info.ack = info.payload = 0;
+    info.flags = 0;
+
+    if (proto == 6) {
+        if (len < 20)
+            return false;
+        size_t off = (p[12] >> 4) * 4;
+        sport = be16(p); dport = be16(p + 2);
+        info.tcp = 1;
+        info.seq = be32(p + 4);
+        info.ack = be32(p + 8);
+        info.flags = p[13];
+        info.payload = l4Len > off ? (uint32_t)(l4Len - off) : 0;
+    } else if (proto == 17) {
+        if (len < 8)
+            return false;
+        sport = be16(p); dport = be16(p + 2);
+        info.payload = l4Len > 8 ? (uint32_t)(l4Len - 8) : 0;
+    }
+
+    // Canonical order so both directions map onto one flow
+    int cmp = memcmp(src, dst, addrLen);
+    info.dir = cmp > 0 || (cmp == 0 && sport > dport);
+    const uint8_t *lo = info.dir ? dst : src, *hi = info.dir ? src : dst;
+    memcpy(key.a, lo, addrLen);
+    memcpy(key.b, hi, addrLen);
+    key.portA = info.dir ? dport : sport;
+    key.portB = info.dir ? sport : dport;
+    key.proto = proto;
+    info.flow = hashKey(key);
+    return true;
+}
+
+
+class Direction {
+    public:
+        uint64_t packets = 0;
+        uint64_t bytes = 0;
+        uint64_t retransmits = 0;
+        bool seqValid = false;
+        uint32_t highestSeq = 0;            // one past the highest byte sent
+        deque<pair<uint32_t, double>> outstanding;  // (segment end, send time)
+};
+
+
+class FlowStats {
+    public:
+        FlowKey key;
+        Direction dir[2];
+        double first = 0, last = 0;
+        uint64_t rttSamples = 0;
+        double rttSum = 0, rttMin = 1e18, rttMax = 0;
+        uint64_t firstBin = 0;
+        vector<uint64_t> series;    // bytes per interval, from firstBin
+
+        uint64_t bytes() const { return dir[0].bytes + dir[1].bytes; }
+};
+
+
+static inline bool seqAfter(uint32_t a, uint32_t b) { return (int32_t)(a - b) > 0; }
+
+
+class Analyzer {
+    public:
+        Analyzer(double start, double interval) : start(start), interval(interval) {}
+        void add(const PacketInfo &p, const unordered_map<uint64_t, FlowKey> &keys);
+
+        unordered_map<uint64_t, FlowStats> flows;
+
+    private:
+        double start;
+        double interval;
+};
+
+
+void Analyzer::add(const PacketInfo &p, const unordered_map<uint64_t, FlowKey> &keys) {
+    auto it = flows.find(p.flow);
+    if (it == flows.end()) {
+        it = flows.emplace(p.flow, FlowStats()).first;
+        it->second.key = keys.at(p.flow);
+        it->second.first = p.ts;
+        it->second.firstBin = (uint64_t)max(0.0, (p.ts - start) / interval);
+    }
+    FlowStats &f = it->second;
+    Direction &d = f.dir[p.dir];
+    f.last = p.ts;
+    ++d.packets;
+    d.bytes += p.wireLen;
+
+    uint64_t bin = (uint64_t)max(0.0, (p.ts - start) / interval);
+    if (bin >= f.firstBin) {
+        if (bin - f.firstBin >= f.series.size())
+            f.series.resize(bin - f.firstBin + 1);
+        f.series[bin - f.firstBin] += p.wireLen;
+    }
+
+    if (!p.tcp)
+        return;
+
+    uint32_t len = p.payload + ((p.flags & (TCP_SYN | TCP_FIN)) ? 1 : 0);
+    uint32_t end = p.seq + len;
+    if (len > 0) {
+        if (d.seqValid && !seqAfter(end, d.highestSeq)) {
+            ++d.retransmits;
+            // Karn: an ACK for retransmitted data is ambiguous, drop those samples
+            // (segment ends are pushed in increasing order, so walk back from the newest)
+            for (auto o = d.outstanding.rbegin(); o != d.outstanding.rend() && seqAfter(o->first, p.seq); ++o)
+                if (!seqAfter(o->first, end))
+                    o->second = -1;
+        } else {
+            d.seqValid = true;
+            d.highestSeq = end;
+            if (d.outstanding.size() < MAX_OUTSTANDING)
+                d.outstanding.emplace_back(end, p.ts);
+        }
+    }
+
+    // This ACK covers segments sent the other way
+    if (p.flags & TCP_ACK) {
+        Direction &o = f.dir[!p.dir];
+        while (!o.outstanding.empty() && !seqAfter(o.outstanding.front().first, p.ack)) {
+            double sent = o.outstanding.front().second;
+            o.outstanding.pop_front();
+            if (sent < 0)
+                continue;
+            double rtt = p.ts - sent;
+            ++f.rttSamples;
+            f.rttSum += rtt;
+            f.rttMin = min(f.rttMin, rtt);
+            f.rttMax = max(f.rttMax, rtt);
+        }
+    }
+}
+
+
+int main(int argc, char *argv[]) {
+    unsigned threads = max(1u, thread::hardware_concurrency());
+    double interval = 0.1;
+    const char *seriesPath = NULL;
+    size_t top = 20;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "j:i:s:n:")) != -1) {
+        switch (opt) {
+            case 'j': threads = max(1, atoi(optarg)); break;
+            case 'i': interval = atof(optarg); break;
+            case 's': seriesPath = optarg; break;
+            case 'n': top = atoi(optarg); break;
+            default: break;
+        }
+    }
+    if (optind >= argc || interval <= 0) {
+        fprintf(stderr, "Usage: %s [-j threads] [-i interval s] [-s series.csv] [-n top flows] file.pcap\n", argv[0]);
+        return 1;
+    }
+
+    auto t0 = chrono::steady_clock::now();
+    Capture cap;
+    if (!cap.open(argv[optind]))
+        return 1;
+
+    vector<size_t> offsets;
+    cap.index(offsets);
+    if (offsets.empty()) {
+        printf("No packets\n");
+        return 0;
+    }
+    threads = (unsigned)min<size_t>(threads, offsets.size());
+
+    // Pass 1: decode contiguous slices, bucket results by flow shard
+    vector<vector<vector<PacketInfo>>> buckets(threads, vector<vector<PacketInfo>>(threads));
+    vector<unordered_map<uint64_t, FlowKey>> keys(threads);
+    vector<uint64_t> undecoded(threads, 0);
+    vector<thread> workers;
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            size_t lo = offsets.size() * t / threads, hi = offsets.size() * (t + 1) / threads;
+            for (auto &b : buckets[t])
+                b.reserve((hi - lo) / threads + 16);
+            PacketInfo info;
+            FlowKey key;
+            for (size_t i = lo; i < hi; ++i) {
+                if (!cap.decode(offsets[i], info, key)) {
+                    ++undecoded[t];
+                    continue;
+                }
+                if (keys[t].find(info.flow) == keys[t].end())
+                    keys[t].emplace(info.flow, key);
+                buckets[t][info.flow % threads].push_back(info);
+            }
+        });
+    }
+    for (auto &w : workers)
+        w.join();
+    workers.clear();
+
+    unordered_map<uint64_t, FlowKey> allKeys;
+    for (auto &k : keys)
+        allKeys.insert(k.begin(), k.end());
+
+    // Pass 2: one flow shard per thread, slices replayed in capture order
+    PacketInfo firstInfo;
+    FlowKey firstKey;
+    double start = 0;
+    for (size_t off : offsets)
+        if (cap.decode(off, firstInfo, firstKey)) {
+            start = firstInfo.ts;
+            break;
+        }
+
+    vector<Analyzer> shards(threads, Analyzer(start, interval));
+    for (unsigned s = 0; s < threads; ++s) {
+        workers.emplace_back([&, s]() {
+            for (unsigned t = 0; t < threads; ++t)
+                for (const PacketInfo &p : buckets[t][s])
+                    shards[s].add(p, allKeys);
+        });
+    }
+    for (auto &w : workers)
+        w.join();
+
+    vector<const FlowStats *> flows;
+    for (auto &s : shards)
+        for (auto &f : s.flows)
+            flows.push_back(&f.second);
+    sort(flows.begin(), flows.end(), [](const FlowStats *x, const FlowStats *y) { return x->bytes() > y->bytes(); });
+
+    double secs = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+    uint64_t undecodedTotal = accumulate(undecoded.begin(), undecoded.end(), (uint64_t)0);
+
+    printf("%-5s %-44s %10s %12s %9s %10s %8s %24s\n", "proto", "flow (a <-> b)", "packets", "bytes",
+           "duration", "Mbit/s", "retrans", "rtt ms min/avg/max (n)");
+    for (size_t i = 0; i < flows.size() && i < top; ++i) {
+        const FlowStats &f = *flows[i];
+        double dur = f.last - f.first;
+        string name = f.key.endpoint(true) + " <-> " + f.key.endpoint(false);
+        char rtt[64] = "-";
+        if (f.rttSamples)
+            snprintf(rtt, sizeof(rtt), "%.3f/%.3f/%.3f (%llu)", f.rttMin * 1e3, f.rttSum / f.rttSamples * 1e3,
+                     f.rttMax * 1e3, (unsigned long long)f.rttSamples);
+        printf("%-5s %-44s %10llu %12llu %9.3f %10.3f %8llu %24s\n",
+               f.key.proto == 6 ? "tcp" : f.key.proto == 17 ? "udp" : to_string(f.key.proto).c_str(),
+               name.c_str(), (unsigned long long)(f.dir[0].packets + f.dir[1].packets),
+               (unsigned long long)f.bytes(), dur, dur > 0 ? f.bytes() * 8 / dur / 1e6 : 0.0,
+               (unsigned long long)(f.dir[0].retransmits + f.dir[1].retransmits), rtt);
+    }
+
+    if (seriesPath != NULL) {
+        FILE *out = fopen(seriesPath, "w");
+        if (out == NULL) {
+            perror(seriesPath);
+            return 1;
+        }
+        fprintf(out, "flow,time,bytes,mbps\n");
+        for (const FlowStats *f : flows) {
+            string name = f->key.endpoint(true) + "-" + f->key.endpoint(false);
+            for (size_t b = 0; b < f->series.size(); ++b)
+                fprintf(out, "%s,%.6f,%llu,%.6f\n", name.c_str(), (f->firstBin + b) * interval,
+                        (unsigned long long)f->series[b], f->series[b] * 8 / interval / 1e6);
+        }
+        fclose(out);
+    }
+
+    printf("\n%zu packets (%llu not decoded), %zu flows, link type %d, %.3f s, %.2f GB/s with %u threads\n",
+           offsets.size(), (unsigned long long)undecodedTotal, flows.size(), cap.linkType, secs,
+           cap.size / secs / 1e9, threads);
+    return 0;
+}
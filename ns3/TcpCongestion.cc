@@ -27,14 +27,19 @@
  *       to crank up a flow and hook the CongestionWindow attribute on the socket
  *       of the sender.
  * 
- *       So, we cook up a simple version of the on-off application that does what
- *       we want. On the plus side we don't need all of the complexity of the on-off
- *       application. On the minus side, we don't have a helper, so we have to get
- *       a little more i<nvolved in the details, but this is trivial.
+ *       The flow comes from TxDrivenSender (tx-driven-sender.h), which writes
+ *       whenever the socket has buffer space instead of running a timer per
+ *       packet. By default it is rate limited to --dataRate, like the old
+ *       timer-driven sender; --saturate lets TCP send as fast as cwnd allows.
  * 
  *       So first, we create a socket and do the trace connect on it; then we pass 
- *       this socket into the constructor of our simple application which we then 
- *       install in the source node.
+ *       this socket to the sender application which we then install in the
+ *       source node.
+ *
+ *       By default the cwnd changes and drops go to buffered binary traces
+ *       (TcpCongestion.cwnd.bin, TcpCongestion.drop.bin), which
+ *       binary-trace-convert.cpp turns back into the ascii cwnd format.
+ *       --binaryTrace=false writes the ascii cwnd trace and drop pcap directly.
  *      ===========================================================================
  */
 
@@ -45,122 +50,13 @@
 #include "ns3/point-to-point-module.h"
 #include "ns3/applications-module.h"
 
+#include "binary-trace-sink.h"
+#include "tx-driven-sender.h"
+
 using namespace ns3;
 
 NS_LOG_COMPONENT_DEFINE ("FifthScriptExample");
 
-class MyApp : public Application 
-{
-public:
-
-    MyApp ();
-    virtual ~MyApp();
-
-    static TypeId GetTypeId(void);
-    void Setup (Ptr<Socket> socket, Address address, uint32_t packetSize, uint32_t nPackets, DataRate dataRate);
-
-private:
-    virtual void StartApplication (void);
-    virtual void StopApplication (void);
-
-    void ScheduleTx (void);
-    void SendPacket (void);
-
-    Ptr<Socket>     m_socket;
-    Address         m_peer;
-    uint32_t        m_packetSize;
-    uint32_t        m_nPackets;
-    DataRate        m_dataRate;
-    EventId         m_sendEvent;
-    bool            m_running;
-    uint32_t        m_packetsSent;
-};
-
-MyApp::MyApp ()
-    : m_socket (0), 
-      m_peer (), 
-      m_packetSize (0), 
-      m_nPackets (0), 
-      m_dataRate (0), 
-      m_sendEvent (), 
-      m_running (false), 
-      m_packetsSent (0)
-{
-}
-
-MyApp::~MyApp()
-{
-    m_socket = 0;
-}
-
-TypeId MyApp::GetTypeId(void)
-{
-    static TypeId tid = TypeId("MyApp")
-        .SetParent<Application>()
-        .SetGroupName("Tutorial")
-        .AddConstructor<MyApp>()
-        ;
-    return tid;
-}
-
-void
-MyApp::Setup (Ptr<Socket> socket, Address address, uint32_t packetSize, uint32_t nPackets, DataRate dataRate)
-{
-    m_socket = socket;
-    m_peer = address;
-    m_packetSize = packetSize;
-    m_nPackets = nPackets;
-    m_dataRate = dataRate;
-}
-
-void
-MyApp::StartApplication (void)
-{
-    m_running = true;
-    m_packetsSent = 0;
-    m_socket->Bind ();
-    m_socket->Connect (m_peer);
-    SendPacket ();
-}
-
-void 
-MyApp::StopApplication (void)
-{
-    m_running = false;
-
-    if (m_sendEvent.IsRunning ())
-    {
-        Simulator::Cancel (m_sendEvent);
-    }
-
-    if (m_socket)
-    {
-        m_socket->Close ();
-    }
-}
-
-void 
-MyApp::SendPacket (void)
-{
-    Ptr<Packet> packet = Create<Packet> (m_packetSize);
-    m_socket->Send (packet);
-
-    if (++m_packetsSent < m_nPackets)
-    {
-        ScheduleTx ();
-    }
-}
-
-void 
-MyApp::ScheduleTx (void)
-{
-    if (m_running)
-    {
-        Time tNext (Seconds (m_packetSize * 8 / static_cast<double> (m_dataRate.GetBitRate ())));
-        m_sendEvent = Simulator::Schedule (tNext, &MyApp::SendPacket, this);
-    }
-}
-
 static void
 CwndChange (Ptr<OutputStreamWrapper> stream, uint32_t oldCwnd, uint32_t newCwnd)
 {
@@ -178,7 +74,18 @@ RxDrop (Ptr<PcapFileWrapper> file, Ptr<const Packet> p)
 int 
 main (int argc, char *argv[])
 {
+    bool binaryTrace = true;
+    bool saturate = false;
+    std::string dataRate = "1Mbps";
+    uint32_t packetSize = 1040;
+    uint32_t maxPackets = 1000;
+
     CommandLine cmd;
+    cmd.AddValue ("binaryTrace", "Buffer cwnd and drop traces as binary records", binaryTrace);
+    cmd.AddValue ("saturate", "Send as fast as the socket accepts, ignoring dataRate", saturate);
+    cmd.AddValue ("dataRate", "Sending rate when not saturating", dataRate);
+    cmd.AddValue ("packetSize", "Bytes per send", packetSize);
+    cmd.AddValue ("maxPackets", "Packets to send, 0 for no limit", maxPackets);
     cmd.Parse (argc, argv);
 
     NodeContainer nodes;
@@ -211,22 +118,49 @@ main (int argc, char *argv[])
 
     Ptr<Socket> ns3TcpSocket = Socket::CreateSocket (nodes.Get (0), TcpSocketFactory::GetTypeId ());
 
-    Ptr<MyApp> app = CreateObject<MyApp> ();
-    app->Setup (ns3TcpSocket, sinkAddress, 1040, 1000, DataRate ("1Mbps"));
+    Ptr<TxDrivenSender> app = CreateObject<TxDrivenSender> ();
+    app->Setup (ns3TcpSocket, sinkAddress, packetSize, uint64_t (packetSize) * maxPackets,
+                saturate ? DataRate (0) : DataRate (dataRate));
     nodes.Get (0)->AddApplication (app);
     app->SetStartTime (Seconds (1.));
     app->SetStopTime (Seconds (20.));
 
-    AsciiTraceHelper asciiTraceHelper;
-    Ptr<OutputStreamWrapper> stream = asciiTraceHelper.CreateFileStream ("trace/TcpCongestion/TcpCongestion.cwnd");
-    ns3TcpSocket->TraceConnectWithoutContext ("CongestionWindow", MakeBoundCallback (&CwndChange, stream));
+    Ptr<BinaryTraceSink> cwndSink;
+    Ptr<BinaryTraceSink> dropSink;
+    if (binaryTrace)
+    {
+        cwndSink = Create<BinaryTraceSink> ("trace/TcpCongestion/TcpCongestion.cwnd.bin", "value");
+        ns3TcpSocket->TraceConnectWithoutContext ("CongestionWindow",
+            MakeBoundCallback (&BinaryTraceSink::ValueChanged<uint32_t>, cwndSink));
+
+        dropSink = Create<BinaryTraceSink> ("trace/TcpCongestion/TcpCongestion.drop.bin", "drop");
+        devices.Get (1)->TraceConnectWithoutContext ("PhyRxDrop",
+            MakeBoundCallback (&BinaryTraceSink::PacketDropped, dropSink));
+    }
+    else
+    {
+        AsciiTraceHelper asciiTraceHelper;
+        Ptr<OutputStreamWrapper> stream = asciiTraceHelper.CreateFileStream ("trace/TcpCongestion/TcpCongestion.cwnd");
+        ns3TcpSocket->TraceConnectWithoutContext ("CongestionWindow", MakeBoundCallback (&CwndChange, stream));
 
-    PcapHelper pcapHelper;
-    Ptr<PcapFileWrapper> file = pcapHelper.CreateFile ("trace/TcpCongestion/TcpCongestion.pcap", std::ios::out, PcapHelper::DLT_PPP);
-    devices.Get (1)->TraceConnectWithoutContext ("PhyRxDrop", MakeBoundCallback (&RxDrop, file));
+        PcapHelper pcapHelper;
+        Ptr<PcapFileWrapper> file = pcapHelper.CreateFile ("trace/TcpCongestion/TcpCongestion.pcap", std::ios::out, PcapHelper::DLT_PPP);
+        devices.Get (1)->TraceConnectWithoutContext ("PhyRxDrop", MakeBoundCallback (&RxDrop, file));
+    }
 
     Simulator::Stop (Seconds (20));
     Simulator::Run ();
+
+    std::cout << "bytes sent: " << app->GetTotalBytes () << " in " << app->GetSends () << " sends, "
+              << Simulator::GetEventCount () << " events" << std::endl;
+
+    if (binaryTrace)
+    {
+        cwndSink->Close ();
+        dropSink->Close ();
+        std::cout << "cwnd changes: " << cwndSink->GetRecordsWritten () << std::endl;
+        std::cout << "drops: " << dropSink->GetRecordsWritten () << std::endl;
+    }
     Simulator::Destroy ();
 
     return 0;
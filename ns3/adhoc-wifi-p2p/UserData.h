@@ -10,4 +10,7 @@ public:
     uint32_t numpackets  = 1;
     double interval      = 1.0;     // seconds
     bool verbose         = false;
+    bool cacheLoss       = true;    // memoize the FixedRss loss per node pair
+    std::string traffic  = "Cbr";   // Cbr, Poisson, OnOff or Trace
+    std::string trafficTrace = "";  // "<seconds> <bytes>" lines for Trace
 };
\ No newline at end of file
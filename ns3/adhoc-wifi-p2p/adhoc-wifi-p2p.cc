@@ -12,6 +12,13 @@
  *      the default behavior.  The list of available command-line options
  *      can be listed with the following command:
  *      ./waf --run "wifi-simple-adhoc --help"
+ *
+ *      --cacheLoss (on by default) memoizes the loss per node pair with
+ *      CachedPropagationLossModel; the cache hit rate is printed at the end.
+ *
+ *      Traffic comes from a TrafficGenerator (--traffic=Cbr, Poisson, OnOff
+ *      or Trace with --trafficTrace=<file>) and the receiver's TrafficSink
+ *      prints packets, losses and the delay histogram at the end.
  */
 
 
@@ -26,6 +33,7 @@
 #include "ns3/yans-wifi-channel.h"
 #include "ns3/mobility-helper.h"
 #include "ns3/internet-stack-helper.h"
+#include "ns3/propagation-delay-model.h"
 #include "adhoc-wifi-p2p.h"
 
 using namespace ns3;
@@ -39,24 +47,26 @@ main (int argc, char *argv[])
 {
     Data data;
     NodeContainer nodes = init(data, argc, argv);
-    NetDeviceContainer devices = SetupWifi(data, nodes);
+    Ptr<CachedPropagationLossModel> lossCache;
+    NetDeviceContainer devices = SetupWifi(data, nodes, lossCache);
     SetupMobility (nodes);
     Internet (nodes, devices);
-    Ptr<Socket> source = SocketConnect (nodes);
+    Ptr<TrafficSink> sink = SetupTraffic (data, nodes);
 
     NS_LOG_UNCOND ("Testing " << data.numpackets  << " packet(s) sent with receiver rss " << data.rss );
-    Time interPacketInterval = Seconds (data.interval); 
-    Simulator::ScheduleWithContext (source->GetNode()->GetId(),
-                                    Seconds(1.0), &GenerateTraffic,
-                                    source, data.packetSize, data.numpackets, interPacketInterval);
     
     Simulator::Run();
+    sink->Report (std::cout);
+    if (lossCache)
+    {
+        lossCache->Report (std::cout);
+    }
     Simulator::Destroy();
 }
 
 
 NodeContainer
-init (Data data, int argc, char *argv[])
+init (Data &data, int argc, char *argv[])
 {
     CommandLine cmd;
     cmd.AddValue ("phyMode",    "Wifi Phy Mode",                   data.phyMode);
@@ -65,6 +75,9 @@ init (Data data, int argc, char *argv[])
     cmd.AddValue ("numPackets", "Number of Applicatoin Packets",   data.numpackets);
     cmd.AddValue ("interval",   "Interval between packets",        data.interval);
     cmd.AddValue ("verbose",    "Turn on all Wifi Log Components", data.verbose);
+    cmd.AddValue ("cacheLoss",  "Cache propagation loss per node pair", data.cacheLoss);
+    cmd.AddValue ("traffic",    "Traffic mode: Cbr, Poisson, OnOff or Trace", data.traffic);
+    cmd.AddValue ("trafficTrace", "\"<seconds> <bytes>\" file for --traffic=Trace", data.trafficTrace);
     cmd.Parse (argc, argv);
 
     
@@ -79,7 +92,7 @@ init (Data data, int argc, char *argv[])
 }
 
 NetDeviceContainer 
-SetupWifi (Data &data, NodeContainer nodes)
+SetupWifi (Data &data, NodeContainer nodes, Ptr<CachedPropagationLossModel> &lossCache)
 {
     WifiHelper wifi;
     if (data.verbose)
@@ -92,10 +105,17 @@ SetupWifi (Data &data, NodeContainer nodes)
     wifiPhy.Set("RxGain", DoubleValue(0));
     wifiPhy.SetPcapDataLinkType (YansWifiPhyHelper::DLT_IEEE802_11_RADIO);
 
-    YansWifiChannelHelper wifiChannel;
-    wifiChannel.SetPropagationDelay ("ns3::ConstantSpeedPropagationDelayModel");
-    wifiChannel.AddPropagationLoss ("ns3::FixedRssLossModel", "Rss", DoubleValue(data.rss));
-    wifiPhy.SetChannel(wifiChannel.Create());
+    Ptr<PropagationLossModel> loss = CreateObject<FixedRssLossModel> ();
+    loss->SetAttribute ("Rss", DoubleValue(data.rss));
+    if (data.cacheLoss)
+    {
+        lossCache = CachedPropagationLossModel::Wrap (loss);
+        loss = lossCache;
+    }
+    Ptr<YansWifiChannel> wifiChannel = CreateObject<YansWifiChannel> ();
+    wifiChannel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+    wifiChannel->SetPropagationLossModel (loss);
+    wifiPhy.SetChannel(wifiChannel);
 
     WifiMacHelper wifiMac;
     wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager",
@@ -143,45 +163,30 @@ AssignIP (Ipv4Address NetworkAddress, Ipv4Mask SubnetMask, NetDeviceContainer de
     return (interface);
 }
 
-Ptr<Socket>
-SocketConnect (NodeContainer nodes)
+Ptr<TrafficSink>
+SetupTraffic (Data &data, NodeContainer nodes)
 {
     TypeId tid = TypeId::LookupByName ("ns3::UdpSocketFactory");
     Ptr<Socket> recvSink = Socket::CreateSocket (nodes.Get(0), tid);
     int port = 80;
     InetSocketAddress local = InetSocketAddress (Ipv4Address::GetAny(), port);
     recvSink -> Bind (local);
-    recvSink -> SetRecvCallback (MakeCallback (&ReceivePacket));
+    Ptr<TrafficSink> sink = CreateObject<TrafficSink> ();
+    sink -> Setup (recvSink);
+    nodes.Get(0) -> AddApplication (sink);
 
     Ptr<Socket> source = Socket::CreateSocket (nodes.Get(1), tid);
     InetSocketAddress remote = InetSocketAddress (Ipv4Address ("255.255.255.255"), port);
     source -> SetAllowBroadcast (true);
     source -> Connect (remote);
-    return (source);
-}
-
-
-void 
-ReceivePacket (Ptr<Socket> socket)
-{
-    while (socket -> Recv())
-    {
-        NS_LOG_UNCOND ("Received one packet!");
-    }
+    Ptr<TrafficGenerator> generator = CreateObject<TrafficGenerator> ();
+    generator -> Setup (source, 1);
+    generator -> SetAttribute ("Mode",       StringValue (data.traffic));
+    generator -> SetAttribute ("PacketSize", UintegerValue (data.packetSize));
+    generator -> SetAttribute ("MaxPackets", UintegerValue (data.numpackets));
+    generator -> SetAttribute ("Interval",   TimeValue (Seconds (data.interval)));
+    generator -> SetAttribute ("TraceFile",  StringValue (data.trafficTrace));
+    generator -> SetStartTime (Seconds (1.0));
+    nodes.Get(1) -> AddApplication (generator);
+    return (sink);
 }
-
-static void
-GenerateTraffic (Ptr<Socket> socket, uint32_t pktSize, uint32_t pktCount, Time pktInterval)
-{
-    if (pktCount > 0)
-    {
-        socket -> Send (Create<Packet> (pktSize));
-        Simulator::Schedule (pktInterval, &GenerateTraffic, socket, pktSize, pktCount-1, pktInterval);
-    }
-    else
-    {
-        socket -> Close();
-    }
-    
-}
-
@@ -10,19 +10,20 @@
 #include "ns3/mobility-helper.h"
 #include "ns3/internet-stack-helper.h"
 #include "UserData.h"
+#include "../cached-propagation-loss-model.h"
+#include "../traffic-generator.h"
 
 using namespace ns3;
 
 
-NodeContainer init              (Data data, int argc, char *argv[]);
-NetDeviceContainer SetupWifi    (Data &data, NodeContainer nodes);
+NodeContainer init              (Data &data, int argc, char *argv[]);
+NetDeviceContainer SetupWifi    (Data &data, NodeContainer nodes, 
+                                Ptr<CachedPropagationLossModel> &lossCache);
 void SetupMobility              (NodeContainer nodes);
 void Internet                   (NodeContainer nodes, NetDeviceContainer devices);
 Ipv4InterfaceContainer AssignIP (Ipv4Address NetworkAddress, Ipv4Mask SubnetMask, 
                                 NetDeviceContainer devices);
-Ptr<Socket> SocketConnect       (NodeContainer nodes);
-void ReceivePacket              (Ptr<Socket> socket);
-static void GenerateTraffic     (Ptr<Socket> socket, uint32_t pktSize, uint32_t pktCount, Time pktInterval); 
+Ptr<TrafficSink> SetupTraffic   (Data &data, NodeContainer nodes);
 
 
 
@@ -0,0 +1,107 @@
+/*
+Created on Mon Oct 19 20:07:33 2026
+@author: Harshil Bhatt
+*/
+
+
+/*  Converts the files written by binary-trace-sink.h back to text.
+
+    "value" traces come out exactly like the old ascii cwnd trace of
+    TcpCongestion.cc, one "time <tab> old <tab> new" line per change,
+    with the time in seconds. "drop" traces print "time <tab> uid <tab>
+    size" per dropped packet.
+
+    Build and run
+        g++ -O2 -std=c++17 -o binary-trace-convert binary-trace-convert.cpp
+        ./binary-trace-convert trace/TcpCongestion/TcpCongestion.cwnd.bin > TcpCongestion.cwnd
+        ./binary-trace-convert -o TcpCongestion.drops trace/TcpCongestion/TcpCongestion.drop.bin
+*/
+
+#include <bits/stdc++.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "binary-trace-format.h"
+
+using namespace std;
+
+
+static bool convert(const char *path, FILE *out) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "Cannot open %s: %s\n", path, strerror(errno));
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        fprintf(stderr, "Cannot stat %s: %s\n", path, strerror(errno));
+        close(fd);
+        return false;
+    }
+    if ((size_t)st.st_size < sizeof(BinaryTraceHeader)) {
+        fprintf(stderr, "%s: too short for a binary trace\n", path);
+        close(fd);
+        return false;
+    }
+
+    void *map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        fprintf(stderr, "Cannot map %s: %s\n", path, strerror(errno));
+        return false;
+    }
+    madvise(map, st.st_size, MADV_SEQUENTIAL);
+
+    const BinaryTraceHeader *header = (const BinaryTraceHeader *)map;
+    if (strncmp(header->magic, BINARY_TRACE_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != BINARY_TRACE_VERSION || header->recordSize != sizeof(BinaryTraceRecord)) {
+        fprintf(stderr, "%s: not a version %d binary trace\n", path, BINARY_TRACE_VERSION);
+        munmap(map, st.st_size);
+        return false;
+    }
+
+    // A run that was killed can leave a partial record at the end
+    size_t count = (st.st_size - sizeof(BinaryTraceHeader)) / sizeof(BinaryTraceRecord);
+    const BinaryTraceRecord *r = (const BinaryTraceRecord *)((const char *)map + sizeof(BinaryTraceHeader));
+
+    // %g matches what an ostream prints for a double by default
+    for (size_t i = 0; i < count; ++i)
+        fprintf(out, "%g\t%llu\t%llu\n", r[i].time / 1e9,
+                (unsigned long long)r[i].oldValue, (unsigned long long)r[i].newValue);
+
+    munmap(map, st.st_size);
+    return true;
+}
+
+
+int main(int argc, char *argv[]) {
+    const char *output = NULL;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "o:")) != -1) {
+        switch (opt) {
+            case 'o': output = optarg; break;
+            default: break;
+        }
+    }
+    if (optind >= argc) {
+        fprintf(stderr, "Script Usage: %s [-o output] <trace.bin>...\n", argv[0]);
+        return 1;
+    }
+
+    FILE *out = output ? fopen(output, "w") : stdout;
+    if (out == NULL) {
+        fprintf(stderr, "Cannot create %s: %s\n", output, strerror(errno));
+        return 1;
+    }
+    static char buff[1 << 20];
+    setvbuf(out, buff, _IOFBF, sizeof(buff));
+
+    bool ok = true;
+    for (int i = optind; i < argc; ++i)
+        ok = convert(argv[i], out) && ok;
+    fclose(out);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,46 @@
+/**
+ * @author Harshil Bhatt
+ * @create date 2026-10-19 19:52:20
+ * @desc
+ *      On-disk layout of the binary trace files written by
+ *      binary-trace-sink.h and read by binary-trace-convert.cpp.
+ *      Kept free of ns-3 headers so the converter builds on its own.
+ *
+ *      A file is one BinaryTraceHeader followed by fixed-size
+ *      BinaryTraceRecords in host byte order, in the order the
+ *      events happened:
+ *
+ *          kind "value"    time, old value, new value
+ *                          (TracedValue sources, e.g. CongestionWindow)
+ *          kind "drop"     time, packet uid, packet size
+ *                          (packet sources, e.g. PhyRxDrop)
+ */
+
+#ifndef BINARY_TRACE_FORMAT_H
+#define BINARY_TRACE_FORMAT_H
+
+#include <stdint.h>
+
+
+#define BINARY_TRACE_MAGIC      "NS3BTRC"
+#define BINARY_TRACE_VERSION    1
+
+
+struct BinaryTraceHeader
+{
+    char magic[8];          // BINARY_TRACE_MAGIC, nul terminated
+    uint32_t version;       // BINARY_TRACE_VERSION
+    uint32_t recordSize;    // sizeof (BinaryTraceRecord)
+    char kind[16];          // "value" or "drop", nul terminated
+};
+
+
+struct BinaryTraceRecord
+{
+    int64_t time;           // simulation time in ns
+    uint64_t oldValue;
+    uint64_t newValue;
+};
+
+
+#endif /* BINARY_TRACE_FORMAT_H */
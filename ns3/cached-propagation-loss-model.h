@@ -0,0 +1,273 @@
+/**
+ * @author Harshil Bhatt
+ * @create date 2026-10-19 21:47:09
+ * @desc
+ *      Propagation loss model that memoizes another model's result per
+ *      (transmitter, receiver) pair.
+ *
+ *      Channels call CalcRxPower for every frame and every receiver, even
+ *      when both nodes sit on a ConstantPositionMobilityModel and the
+ *      answer cannot change. This model wraps the real loss model (or
+ *      chain of models) and keeps its last answer for each ordered pair
+ *      of mobility models. A pair's entry is reused while
+ *          - the transmit power is the same as when it was computed,
+ *          - neither node has fired CourseChange since, and
+ *          - neither node reports a non-zero velocity.
+ *      Moving nodes drift between course changes, so pairs involving one
+ *      are always passed through to the wrapped model.
+ *
+ *      There is an entry per ordered pair that has exchanged a frame, so
+ *      on a channel that delivers every frame to every node the cache
+ *      grows towards N^2 entries (about 64 bytes each). MaxPairs caps it:
+ *      when full, entries made stale by a course change are dropped, and
+ *      if that frees less than half, everything is. The default, 2^20
+ *      pairs (~64 MB), holds every pair of 1000 nodes.
+ *
+ *      Only wrap deterministic models (Friis, LogDistance, FixedRss,
+ *      ...). Random ones such as Nakagami or RandomPropagationLossModel
+ *      would return the same draw for every frame.
+ *
+ *      Usage:
+ *          Ptr<CachedPropagationLossModel> loss = CachedPropagationLossModel::Wrap (
+ *              CreateObject<FriisPropagationLossModel> ());
+ *          channel->SetPropagationLossModel (loss);
+ *          ...
+ *          Simulator::Run ();
+ *          loss->Report (std::cout);
+ */
+
+#ifndef CACHED_PROPAGATION_LOSS_MODEL_H
+#define CACHED_PROPAGATION_LOSS_MODEL_H
+
+#include <stdint.h>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+
+#include "ns3/core-module.h"
+#include "ns3/propagation-loss-model.h"
+#include "ns3/mobility-model.h"
+
+
+namespace ns3 {
+
+class CachedPropagationLossModel : public PropagationLossModel
+{
+public:
+    static TypeId GetTypeId (void)
+    {
+        static TypeId tid = TypeId ("ns3::CachedPropagationLossModel")
+            .SetParent<PropagationLossModel> ()
+            .AddConstructor<CachedPropagationLossModel> ()
+            .AddAttribute ("Model",
+                           "The propagation loss model whose results are cached.",
+                           PointerValue (),
+                           MakePointerAccessor (&CachedPropagationLossModel::m_model),
+                           MakePointerChecker<PropagationLossModel> ())
+            .AddAttribute ("MaxPairs",
+                           "Most (transmitter, receiver) pairs cached, 0 for no limit.",
+                           UintegerValue (1 << 20),
+                           MakeUintegerAccessor (&CachedPropagationLossModel::m_maxPairs),
+                           MakeUintegerChecker<uint32_t> ());
+        return tid;
+    }
+
+    CachedPropagationLossModel ()
+        : m_maxPairs (1 << 20), m_hits (0), m_misses (0), m_bypassed (0), m_evictions (0)
+    {
+    }
+
+    /**
+     * \returns a cache in front of model
+     */
+    static Ptr<CachedPropagationLossModel> Wrap (Ptr<PropagationLossModel> model)
+    {
+        Ptr<CachedPropagationLossModel> cache = CreateObject<CachedPropagationLossModel> ();
+        cache->m_model = model;
+        return cache;
+    }
+
+    /**
+     * Forget every cached result
+     */
+    void Clear (void)
+    {
+        m_cache.clear ();
+    }
+
+    uint64_t GetHits (void) const
+    {
+        return m_hits;
+    }
+
+    uint64_t GetMisses (void) const
+    {
+        return m_misses;
+    }
+
+    /**
+     * \returns calls passed straight through because a node was moving
+     */
+    uint64_t GetBypassed (void) const
+    {
+        return m_bypassed;
+    }
+
+    double GetHitRate (void) const
+    {
+        uint64_t calls = m_hits + m_misses + m_bypassed;
+        return calls ? double (m_hits) / calls : 0.0;
+    }
+
+    void Report (std::ostream &os) const
+    {
+        os << "Loss cache: " << m_hits << " hits, " << m_misses << " misses, "
+           << m_bypassed << " bypassed (moving), " << m_cache.size () << " pairs, "
+           << m_evictions << " evictions, "
+           << "hit rate " << GetHitRate () * 100 << "%" << std::endl;
+    }
+
+private:
+    struct Endpoint
+    {
+        Ptr<MobilityModel> mobility;
+        uint32_t generation;    // bumped on every course change
+    };
+
+    struct Entry
+    {
+        double txPowerDbm;
+        double rxPowerDbm;
+        uint32_t generationA;
+        uint32_t generationB;
+    };
+
+    virtual double DoCalcRxPower (double txPowerDbm, Ptr<MobilityModel> a,
+                                  Ptr<MobilityModel> b) const
+    {
+        NS_ASSERT_MSG (m_model, "CachedPropagationLossModel needs a Model to wrap");
+        if (a->GetVelocity () != Vector () || b->GetVelocity () != Vector ())
+        {
+            ++m_bypassed;
+            return m_model->CalcRxPower (txPowerDbm, a, b);
+        }
+
+        uint32_t ia = GetIndex (a);
+        uint32_t ib = GetIndex (b);
+        uint64_t key = (uint64_t (ia) << 32) | ib;
+        std::unordered_map<uint64_t, Entry>::iterator it = m_cache.find (key);
+        if (it == m_cache.end ())
+        {
+            if (m_maxPairs > 0 && m_cache.size () >= m_maxPairs)
+            {
+                Evict ();
+            }
+            it = m_cache.insert (std::make_pair (key, Entry ())).first;
+        }
+        Entry &entry = it->second;
+        uint32_t ga = m_nodes[ia].generation;
+        uint32_t gb = m_nodes[ib].generation;
+        if (entry.generationA == ga && entry.generationB == gb
+            && entry.txPowerDbm == txPowerDbm)
+        {
+            ++m_hits;
+            return entry.rxPowerDbm;
+        }
+
+        ++m_misses;
+        entry.txPowerDbm = txPowerDbm;
+        entry.rxPowerDbm = m_model->CalcRxPower (txPowerDbm, a, b);
+        entry.generationA = ga;
+        entry.generationB = gb;
+        return entry.rxPowerDbm;
+    }
+
+    virtual int64_t DoAssignStreams (int64_t stream)
+    {
+        return m_model ? m_model->AssignStreams (stream) : 0;
+    }
+
+    virtual void DoDispose (void)
+    {
+        for (uint32_t i = 0; i < m_nodes.size (); ++i)
+        {
+            m_nodes[i].mobility->TraceDisconnectWithoutContext ("CourseChange",
+                MakeBoundCallback (&CachedPropagationLossModel::CourseChanged, &m_nodes, i));
+        }
+        m_nodes.clear ();
+        m_index.clear ();
+        m_cache.clear ();
+        m_model = 0;
+        PropagationLossModel::DoDispose ();
+    }
+
+    /**
+     * \returns dense index of a mobility model, hooking its CourseChange
+     *          trace the first time it is seen
+     */
+    uint32_t GetIndex (Ptr<MobilityModel> mobility) const
+    {
+        std::unordered_map<const MobilityModel *, uint32_t>::const_iterator it
+            = m_index.find (PeekPointer (mobility));
+        if (it != m_index.end ())
+        {
+            return it->second;
+        }
+        uint32_t index = m_nodes.size ();
+        // Generations start at 1 so that fresh, zeroed entries never match
+        Endpoint node = { mobility, 1 };
+        m_nodes.push_back (node);
+        m_index[PeekPointer (mobility)] = index;
+        mobility->TraceConnectWithoutContext ("CourseChange",
+            MakeBoundCallback (&CachedPropagationLossModel::CourseChanged, &m_nodes, index));
+        return index;
+    }
+
+    /**
+     * Drop the entries a course change has made stale, or every entry if
+     * that would leave the cache more than half full
+     */
+    void Evict (void) const
+    {
+        ++m_evictions;
+        for (std::unordered_map<uint64_t, Entry>::iterator it = m_cache.begin (); it != m_cache.end (); )
+        {
+            const Entry &entry = it->second;
+            if (entry.generationA != m_nodes[it->first >> 32].generation
+                || entry.generationB != m_nodes[uint32_t (it->first)].generation)
+            {
+                it = m_cache.erase (it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+        if (m_cache.size () > m_maxPairs / 2)
+        {
+            m_cache.clear ();
+        }
+    }
+
+    static void CourseChanged (std::vector<Endpoint> *nodes, uint32_t index,
+                               Ptr<const MobilityModel> mobility)
+    {
+        ++(*nodes)[index].generation;
+    }
+
+    Ptr<PropagationLossModel> m_model;
+    uint32_t m_maxPairs;
+
+    mutable std::vector<Endpoint> m_nodes;
+    mutable std::unordered_map<const MobilityModel *, uint32_t> m_index;
+    mutable std::unordered_map<uint64_t, Entry> m_cache;    // (a << 32) | b
+    mutable uint64_t m_hits;
+    mutable uint64_t m_misses;
+    mutable uint64_t m_bypassed;
+    mutable uint64_t m_evictions;
+};
+
+} // namespace ns3
+
+
+#endif /* CACHED_PROPAGATION_LOSS_MODEL_H */
@@ -0,0 +1,207 @@
+/**
+ * @author Harshil Bhatt
+ * @create date 2026-10-19 23:58:40
+ * @desc
+ *      Runs simulations in forked children, a few at a time.
+ *
+ *      ns-3 keeps the simulator, the node list and the default values in
+ *      globals, so the benchmarks and sweeps run every configuration in
+ *      a child forked from a process that has not built anything yet:
+ *      each run starts clean, its memory use is its own, and a run that
+ *      crashes or runs out of memory only loses its own result.
+ *
+ *      Run forks a child per index, at most jobs at once. In the child,
+ *      child (index) runs the simulation and returns its result as bytes,
+ *      which go back through a pipe; the parent reads every pipe while
+ *      the children run, so a result of any size never blocks its child.
+ *      Once a child has exited, done (index, ok, bytes) runs in the
+ *      parent; ok is false if the child crashed or exited with an error.
+ *      Pack and Unpack turn plain structs into those bytes and back.
+ *
+ *      ReadStatusKb reads the calling process' memory use, e.g. VmHWM at
+ *      the end of a child's run.
+ *
+ *      Usage:
+ *          ChildRunner::Run (points.size (), jobs,
+ *              [&] (size_t i)
+ *              {
+ *                  double goodput = RunPoint (points[i]);
+ *                  return ChildRunner::Pack (&goodput, 1);
+ *              },
+ *              [&] (size_t i, bool ok, const std::string &bytes)
+ *              {
+ *                  points[i].ok = ok && ChildRunner::Unpack (bytes, &points[i].goodput, 1);
+ *              });
+ */
+
+#ifndef CHILD_RUNNER_H
+#define CHILD_RUNNER_H
+
+#include <algorithm>
+#include <cerrno>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <poll.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "ns3/core-module.h"
+
+
+using namespace ns3;
+
+
+/**
+ * \returns value of a "Key:   1234 kB" line of /proc/self/status, in kB
+ */
+inline uint64_t
+ReadStatusKb (const std::string &key)
+{
+    std::ifstream status ("/proc/self/status");
+    std::string line;
+    while (std::getline (status, line))
+    {
+        if (line.compare (0, key.size (), key) == 0 && line[key.size ()] == ':')
+        {
+            return std::stoull (line.substr (key.size () + 1));
+        }
+    }
+    return 0;
+}
+
+
+class ChildRunner
+{
+public:
+    typedef std::function<std::string (size_t)> Child;
+    typedef std::function<void (size_t, bool, const std::string &)> Done;
+
+    /**
+     * Run child (0) to child (count - 1) in forked children, jobs at a
+     * time, and hand each result to done in the parent
+     */
+    static void Run (size_t count, uint32_t jobs, Child child, Done done)
+    {
+        std::vector<Running> running;
+        size_t next = 0;
+        while (next < count || !running.empty ())
+        {
+            while (next < count && running.size () < std::max (jobs, 1u))
+            {
+                int fds[2];
+                NS_ABORT_MSG_IF (pipe (fds) != 0, "pipe failed");
+                // or the child prints the parent's buffered output again
+                std::cout.flush ();
+                pid_t pid = fork ();
+                NS_ABORT_MSG_IF (pid < 0, "fork failed");
+                if (pid == 0)
+                {
+                    close (fds[0]);
+                    std::string bytes = child (next);
+                    std::cout.flush ();
+                    _exit (WriteAll (fds[1], bytes) ? 0 : 1);
+                }
+                close (fds[1]);
+                Running r = { pid, next++, fds[0], std::string () };
+                running.push_back (r);
+            }
+
+            std::vector<struct pollfd> polls (running.size ());
+            for (size_t i = 0; i < running.size (); ++i)
+            {
+                polls[i].fd = running[i].fd;
+                polls[i].events = POLLIN;
+                polls[i].revents = 0;
+            }
+            if (poll (polls.data (), polls.size (), -1) < 0)
+            {
+                NS_ABORT_MSG_IF (errno != EINTR, "poll failed");
+                continue;
+            }
+            // backwards, so erasing keeps the remaining indices valid
+            for (size_t i = running.size (); i-- > 0;)
+            {
+                if (polls[i].revents == 0)
+                {
+                    continue;
+                }
+                char buffer[65536];
+                ssize_t got = read (running[i].fd, buffer, sizeof (buffer));
+                if (got > 0)
+                {
+                    running[i].bytes.append (buffer, got);
+                    continue;
+                }
+                if (got < 0 && errno == EINTR)
+                {
+                    continue;
+                }
+                // end of the pipe: the child is done writing and exits
+                close (running[i].fd);
+                int status;
+                waitpid (running[i].pid, &status, 0);
+                bool ok = got == 0 && WIFEXITED (status) && WEXITSTATUS (status) == 0;
+                done (running[i].index, ok, running[i].bytes);
+                running.erase (running.begin () + i);
+            }
+        }
+    }
+
+    /**
+     * \returns n values of a plain type as bytes, for a child's result
+     */
+    template <typename T>
+    static std::string Pack (const T *values, size_t n)
+    {
+        return std::string (reinterpret_cast<const char *> (values), n * sizeof (T));
+    }
+
+    /**
+     * \returns false unless bytes hold exactly n values
+     */
+    template <typename T>
+    static bool Unpack (const std::string &bytes, T *values, size_t n)
+    {
+        if (bytes.size () != n * sizeof (T))
+        {
+            return false;
+        }
+        std::copy (bytes.begin (), bytes.end (), reinterpret_cast<char *> (values));
+        return true;
+    }
+
+private:
+    struct Running
+    {
+        pid_t pid;
+        size_t index;
+        int fd;                 // read end of the child's pipe
+        std::string bytes;      // read so far
+    };
+
+    static bool WriteAll (int fd, const std::string &bytes)
+    {
+        size_t written = 0;
+        while (written < bytes.size ())
+        {
+            ssize_t n = write (fd, bytes.data () + written, bytes.size () - written);
+            if (n < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (n <= 0)
+            {
+                return false;
+            }
+            written += n;
+        }
+        return true;
+    }
+};
+
+
+#endif /* CHILD_RUNNER_H */
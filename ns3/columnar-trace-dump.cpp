@@ -0,0 +1,115 @@
+/*
+Created on Mon Oct 19 21:02:16 2026
+@author: Harshil Bhatt
+*/
+
+
+/*  Prints or summarises a columnar trace written by columnar-trace-helper.h.
+
+    By default every event is printed in the shape of an ascii trace line:
+
+        + 1.002345678 /NodeList/0/DeviceList/1 uid 12 size 1052
+
+    -c prints CSV instead (time,kind,node,device,uid,size) and -s only
+    prints event counts per location and kind, and the bytes per event.
+
+    Build and run
+        g++ -O2 -std=c++17 -o columnar-trace-dump columnar-trace-dump.cpp
+        (add -DCOLUMNAR_TRACE_ZLIB ... -lz to read compressed traces)
+        ./columnar-trace-dump [-c | -s] trace/global-routing/simple-global-routing.ctr
+*/
+
+#include <bits/stdc++.h>
+#include <sys/stat.h>
+
+#include "columnar-trace-format.h"
+
+using namespace std;
+
+
+int main(int argc, char *argv[]) {
+    bool csv = false, summary = false;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "cs")) != -1) {
+        switch (opt) {
+            case 'c': csv = true; break;
+            case 's': summary = true; break;
+            default: break;
+        }
+    }
+    if (optind != argc - 1) {
+        fprintf(stderr, "Script Usage: %s [-c | -s] <trace.ctr>\n", argv[0]);
+        return 1;
+    }
+
+    ColumnarTraceReader reader;
+    if (!reader.Open(argv[optind])) {
+        fprintf(stderr, "%s\n", reader.GetError().c_str());
+        return 1;
+    }
+
+    static char buff[1 << 20];
+    setvbuf(stdout, buff, _IOFBF, sizeof(buff));
+    if (csv)
+        printf("time,kind,node,device,uid,size\n");
+
+    // counts[location][kind]
+    vector<array<uint64_t, 256>> counts;
+    uint64_t events = 0;
+    size_t chunks = 0;
+
+    ColumnarTraceChunk chunk;
+    while (reader.NextChunk(chunk)) {
+        ++chunks;
+        events += chunk.GetN();
+        const vector<ColumnarTraceLocation> &locs = reader.GetLocations();
+
+        if (summary) {
+            if (counts.size() < locs.size())
+                counts.resize(locs.size(), array<uint64_t, 256>());
+            for (size_t i = 0; i < chunk.GetN(); ++i)
+                ++counts[chunk.location[i]][chunk.kind[i]];
+            continue;
+        }
+
+        for (size_t i = 0; i < chunk.GetN(); ++i) {
+            const ColumnarTraceLocation &l = locs[chunk.location[i]];
+            double t = chunk.time[i] / 1e9;
+            if (csv)
+                printf("%.9f,%c,%u,%u,%llu,%u\n", t, chunk.kind[i], l.node, l.device,
+                       (unsigned long long)chunk.uid[i], chunk.size[i]);
+            else
+                printf("%c %.9f /NodeList/%u/DeviceList/%u uid %llu size %u\n", chunk.kind[i], t,
+                       l.node, l.device, (unsigned long long)chunk.uid[i], chunk.size[i]);
+        }
+    }
+    if (!reader.GetError().empty()) {
+        fflush(stdout);
+        fprintf(stderr, "%s: %s\n", argv[optind], reader.GetError().c_str());
+        return 1;
+    }
+
+    if (summary) {
+        const char kinds[] = "+-dr";
+        printf("%-28s", "location");
+        for (const char *k = kinds; *k; ++k)
+            printf("%12c", *k);
+        printf("\n");
+        for (size_t i = 0; i < counts.size(); ++i) {
+            const ColumnarTraceLocation &l = reader.GetLocations()[i];
+            char name[64];
+            snprintf(name, sizeof(name), "/NodeList/%u/DeviceList/%u", l.node, l.device);
+            printf("%-28s", name);
+            for (const char *k = kinds; *k; ++k)
+                printf("%12llu", (unsigned long long)counts[i][(uint8_t)*k]);
+            printf("\n");
+        }
+
+        struct stat st;
+        stat(argv[optind], &st);
+        printf("%llu events in %zu chunks, %lld bytes (%.2f bytes/event)\n", (unsigned long long)events,
+               chunks, (long long)st.st_size, events ? (double)st.st_size / events : 0.0);
+    }
+    return 0;
+}
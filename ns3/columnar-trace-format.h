@@ -0,0 +1,426 @@
+/**
+ * @author Harshil Bhatt
+ * @create date 2026-10-19 20:21:37
+ * @desc
+ *      On-disk format and reader for the columnar packet traces written
+ *      by columnar-trace-helper.h. Kept free of ns-3 headers so analysis
+ *      tools (columnar-trace-dump.cpp) build on their own.
+ *
+ *      A trace is a file header followed by chunks of up to a few ten
+ *      thousand events. Every chunk stores its events column by column:
+ *
+ *          new locations   (node, device) pairs first seen in this chunk,
+ *                          the dictionary that the location column indexes
+ *          time            ns, zigzag varint delta to the previous event
+ *          kind            one byte per event, same letters as ascii traces
+ *          location        varint index into the location dictionary
+ *          uid             zigzag varint delta to the previous packet uid
+ *          size            varint packet size in bytes
+ *
+ *      Deltas run across chunk boundaries. Each column is prefixed with
+ *      its length in bytes. With -DCOLUMNAR_TRACE_ZLIB (and -lz) chunks
+ *      can also be deflated; the chunk header says whether one was.
+ */
+
+#ifndef COLUMNAR_TRACE_FORMAT_H
+#define COLUMNAR_TRACE_FORMAT_H
+
+#include <stdint.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#ifdef COLUMNAR_TRACE_ZLIB
+#include <zlib.h>
+#endif
+
+
+#define COLUMNAR_TRACE_MAGIC        "NS3CTRC"
+#define COLUMNAR_TRACE_VERSION      1
+#define COLUMNAR_TRACE_DEFLATED     0x1
+
+
+enum ColumnarTraceKind
+{
+    TRACE_ENQUEUE = '+',
+    TRACE_DEQUEUE = '-',
+    TRACE_DROP    = 'd',
+    TRACE_RX      = 'r',
+};
+
+
+struct ColumnarTraceFileHeader
+{
+    char magic[8];          // COLUMNAR_TRACE_MAGIC, nul terminated
+    uint32_t version;       // COLUMNAR_TRACE_VERSION
+    uint32_t reserved;
+};
+
+
+struct ColumnarTraceChunkHeader
+{
+    uint32_t events;
+    uint32_t newLocations;
+    uint32_t flags;         // COLUMNAR_TRACE_DEFLATED
+    uint32_t rawBytes;      // payload size before compression
+    uint32_t storedBytes;   // payload size in the file
+};
+
+
+struct ColumnarTraceLocation
+{
+    uint32_t node;
+    uint32_t device;
+};
+
+
+/**
+ * One chunk worth of events, one vector per column
+ */
+class ColumnarTraceChunk
+{
+public:
+    std::vector<int64_t> time;          // ns
+    std::vector<uint8_t> kind;          // ColumnarTraceKind
+    std::vector<uint32_t> location;     // index into the location dictionary
+    std::vector<uint64_t> uid;
+    std::vector<uint32_t> size;
+
+    size_t GetN (void) const
+    {
+        return time.size ();
+    }
+
+    void Clear (void)
+    {
+        time.clear ();
+        kind.clear ();
+        location.clear ();
+        uid.clear ();
+        size.clear ();
+    }
+};
+
+
+namespace ColumnarTrace {
+
+inline void
+PutVarint (std::string &out, uint64_t v)
+{
+    while (v >= 0x80)
+    {
+        out.push_back (char (v | 0x80));
+        v >>= 7;
+    }
+    out.push_back (char (v));
+}
+
+inline bool
+GetVarint (const uint8_t *&p, const uint8_t *end, uint64_t &v)
+{
+    v = 0;
+    for (int shift = 0; shift < 64 && p < end; shift += 7)
+    {
+        uint8_t b = *p++;
+        v |= uint64_t (b & 0x7f) << shift;
+        if (!(b & 0x80))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+inline uint64_t
+ZigZag (int64_t v)
+{
+    return (uint64_t (v) << 1) ^ uint64_t (v >> 63);
+}
+
+inline int64_t
+UnZigZag (uint64_t v)
+{
+    return int64_t (v >> 1) ^ -int64_t (v & 1);
+}
+
+inline void
+PutColumn (std::string &out, const std::string &column)
+{
+    PutVarint (out, column.size ());
+    out.append (column);
+}
+
+/**
+ * Encode a chunk's columns into payload. lastTime and lastUid carry the
+ * delta bases from one chunk to the next.
+ */
+inline void
+EncodeChunk (const ColumnarTraceChunk &chunk,
+             const std::vector<ColumnarTraceLocation> &newLocations,
+             int64_t &lastTime, uint64_t &lastUid, std::string &payload)
+{
+    payload.clear ();
+    for (const ColumnarTraceLocation &l : newLocations)
+    {
+        PutVarint (payload, l.node);
+        PutVarint (payload, l.device);
+    }
+
+    std::string column;
+    for (int64_t t : chunk.time)
+    {
+        PutVarint (column, ZigZag (t - lastTime));
+        lastTime = t;
+    }
+    PutColumn (payload, column);
+
+    PutColumn (payload, std::string (chunk.kind.begin (), chunk.kind.end ()));
+
+    column.clear ();
+    for (uint32_t l : chunk.location)
+    {
+        PutVarint (column, l);
+    }
+    PutColumn (payload, column);
+
+    column.clear ();
+    for (uint64_t u : chunk.uid)
+    {
+        PutVarint (column, ZigZag (int64_t (u - lastUid)));
+        lastUid = u;
+    }
+    PutColumn (payload, column);
+
+    column.clear ();
+    for (uint32_t s : chunk.size)
+    {
+        PutVarint (column, s);
+    }
+    PutColumn (payload, column);
+}
+
+} // namespace ColumnarTrace
+
+
+/**
+ * Streams a columnar trace back one chunk at a time.
+ *
+ *      ColumnarTraceReader reader;
+ *      if (!reader.Open ("x.ctr")) ... reader.GetError ()
+ *      ColumnarTraceChunk chunk;
+ *      while (reader.NextChunk (chunk))
+ *          for (size_t i = 0; i < chunk.GetN (); ++i)
+ *              ... reader.GetLocations ()[chunk.location[i]].node ...
+ *      if (!reader.GetError ().empty ()) ...
+ */
+class ColumnarTraceReader
+{
+public:
+    ColumnarTraceReader ()
+        : m_file (NULL), m_lastTime (0), m_lastUid (0)
+    {
+    }
+
+    ~ColumnarTraceReader ()
+    {
+        if (m_file)
+        {
+            fclose (m_file);
+        }
+    }
+
+    bool Open (const std::string &path)
+    {
+        m_file = fopen (path.c_str (), "rb");
+        if (m_file == NULL)
+        {
+            return Fail ("cannot open " + path + ": " + strerror (errno));
+        }
+        ColumnarTraceFileHeader header;
+        if (fread (&header, sizeof (header), 1, m_file) != 1
+            || strncmp (header.magic, COLUMNAR_TRACE_MAGIC, sizeof (header.magic)) != 0
+            || header.version != COLUMNAR_TRACE_VERSION)
+        {
+            return Fail (path + " is not a version 1 columnar trace");
+        }
+        return true;
+    }
+
+    /**
+     * \returns false at the end of the trace, or on error with
+     *          GetError () set
+     */
+    bool NextChunk (ColumnarTraceChunk &chunk)
+    {
+        chunk.Clear ();
+        if (m_file == NULL)
+        {
+            return false;
+        }
+
+        ColumnarTraceChunkHeader header;
+        size_t got = fread (&header, 1, sizeof (header), m_file);
+        if (got == 0)
+        {
+            return false;
+        }
+        if (got != sizeof (header))
+        {
+            return Fail ("truncated chunk header");
+        }
+
+        m_stored.resize (header.storedBytes);
+        if (fread (&m_stored[0], 1, header.storedBytes, m_file) != header.storedBytes)
+        {
+            return Fail ("truncated chunk");
+        }
+
+        const std::string *payload = &m_stored;
+        if (header.flags & COLUMNAR_TRACE_DEFLATED)
+        {
+#ifdef COLUMNAR_TRACE_ZLIB
+            m_raw.resize (header.rawBytes);
+            uLongf rawLen = header.rawBytes;
+            if (uncompress ((Bytef *) &m_raw[0], &rawLen, (const Bytef *) m_stored.data (),
+                            header.storedBytes) != Z_OK || rawLen != header.rawBytes)
+            {
+                return Fail ("corrupt compressed chunk");
+            }
+            payload = &m_raw;
+#else
+            return Fail ("trace is compressed, rebuild with -DCOLUMNAR_TRACE_ZLIB -lz");
+#endif
+        }
+        return Decode (header, *payload, chunk);
+    }
+
+    const std::vector<ColumnarTraceLocation> &GetLocations (void) const
+    {
+        return m_locations;
+    }
+
+    const std::string &GetError (void) const
+    {
+        return m_error;
+    }
+
+private:
+    bool Fail (const std::string &error)
+    {
+        m_error = error;
+        return false;
+    }
+
+    bool GetColumn (const uint8_t *&p, const uint8_t *end, const uint8_t *&begin, const uint8_t *&stop)
+    {
+        uint64_t len;
+        if (!ColumnarTrace::GetVarint (p, end, len) || len > uint64_t (end - p))
+        {
+            return false;
+        }
+        begin = p;
+        stop = p + len;
+        p = stop;
+        return true;
+    }
+
+    bool Decode (const ColumnarTraceChunkHeader &header, const std::string &payload, ColumnarTraceChunk &chunk)
+    {
+        using namespace ColumnarTrace;
+        const uint8_t *p = (const uint8_t *) payload.data ();
+        const uint8_t *end = p + payload.size ();
+        uint64_t a, b;
+
+        for (uint32_t i = 0; i < header.newLocations; ++i)
+        {
+            if (!GetVarint (p, end, a) || !GetVarint (p, end, b))
+            {
+                return Fail ("corrupt location dictionary");
+            }
+            ColumnarTraceLocation l = { uint32_t (a), uint32_t (b) };
+            m_locations.push_back (l);
+        }
+
+        const uint8_t *col, *stop;
+        uint32_t n = header.events;
+        chunk.time.resize (n);
+        chunk.kind.resize (n);
+        chunk.location.resize (n);
+        chunk.uid.resize (n);
+        chunk.size.resize (n);
+
+        if (!GetColumn (p, end, col, stop))
+        {
+            return Fail ("corrupt time column");
+        }
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            if (!GetVarint (col, stop, a))
+            {
+                return Fail ("corrupt time column");
+            }
+            m_lastTime += UnZigZag (a);
+            chunk.time[i] = m_lastTime;
+        }
+
+        if (!GetColumn (p, end, col, stop) || uint64_t (stop - col) != n)
+        {
+            return Fail ("corrupt kind column");
+        }
+        std::memcpy (chunk.kind.data (), col, n);
+
+        if (!GetColumn (p, end, col, stop))
+        {
+            return Fail ("corrupt location column");
+        }
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            if (!GetVarint (col, stop, a) || a >= m_locations.size ())
+            {
+                return Fail ("corrupt location column");
+            }
+            chunk.location[i] = uint32_t (a);
+        }
+
+        if (!GetColumn (p, end, col, stop))
+        {
+            return Fail ("corrupt uid column");
+        }
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            if (!GetVarint (col, stop, a))
+            {
+                return Fail ("corrupt uid column");
+            }
+            m_lastUid += uint64_t (UnZigZag (a));
+            chunk.uid[i] = m_lastUid;
+        }
+
+        if (!GetColumn (p, end, col, stop))
+        {
+            return Fail ("corrupt size column");
+        }
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            if (!GetVarint (col, stop, a))
+            {
+                return Fail ("corrupt size column");
+            }
+            chunk.size[i] = uint32_t (a);
+        }
+        return true;
+    }
+
+    FILE *m_file;
+    std::vector<ColumnarTraceLocation> m_locations;
+    int64_t m_lastTime;
+    uint64_t m_lastUid;
+    std::string m_stored;
+    std::string m_raw;
+    std::string m_error;
+};
+
+
+#endif /* COLUMNAR_TRACE_FORMAT_H */
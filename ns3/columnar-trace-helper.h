@@ -0,0 +1,311 @@
+/**
+ * @author Harshil Bhatt
+ * @create date 2026-10-19 20:44:05
+ * @desc
+ *      Columnar packet trace helper, a compact stand-in for
+ *      AsciiTraceHelper's .tr output.
+ *
+ *      Records the same enqueue (+), dequeue (-), drop (d) and receive (r)
+ *      events, but as time, kind, (node, device), packet uid and size only,
+ *      buffered in columns and written a chunk at a time in the format of
+ *      columnar-trace-format.h. Every device's trace sources are connected
+ *      straight to the writer with its location already resolved, so no
+ *      context path is built or parsed per event.
+ *
+ *          point-to-point, csma   TxQueue Enqueue/Dequeue/Drop, MacRx,
+ *                                 PhyRxDrop
+ *          wifi                   Mac MacTx (+), MacRx (r), MacTxDrop and
+ *                                 MacRxDrop (d)
+ *
+ *      Install it once, after the topology is built:
+ *          ColumnarTraceHelper trace ("trace/x.ctr");
+ *          trace.InstallAll ();
+ *      The file is flushed and closed by Simulator::Destroy ().
+ *      columnar-trace-dump.cpp prints or summarises a trace; analyses can
+ *      read it with ColumnarTraceReader. Define COLUMNAR_TRACE_ZLIB and link
+ *      zlib to be able to deflate the chunks.
+ */
+
+#ifndef COLUMNAR_TRACE_HELPER_H
+#define COLUMNAR_TRACE_HELPER_H
+
+#include <cerrno>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/wifi-net-device.h"
+#include "ns3/wifi-mac.h"
+
+#include "columnar-trace-format.h"
+
+
+using namespace ns3;
+
+
+class ColumnarTraceWriter : public SimpleRefCount<ColumnarTraceWriter>
+{
+public:
+    /**
+     * \param filename trace file to create
+     *
+     * \param chunkEvents events buffered per chunk
+     *
+     * \param deflate compress the chunks, needs COLUMNAR_TRACE_ZLIB
+     */
+    ColumnarTraceWriter (const std::string &filename, uint32_t chunkEvents, bool deflate)
+        : m_chunkEvents (chunkEvents > 0 ? chunkEvents : 1),
+          m_deflate (deflate),
+          m_lastTime (0),
+          m_lastUid (0),
+          m_events (0),
+          m_bytes (0)
+    {
+#ifndef COLUMNAR_TRACE_ZLIB
+        if (m_deflate)
+        {
+            NS_FATAL_ERROR ("Columnar trace compression needs -DCOLUMNAR_TRACE_ZLIB and zlib.");
+        }
+#endif
+        m_file = fopen (filename.c_str (), "wb");
+        if (m_file == NULL)
+        {
+            NS_FATAL_ERROR ("Cannot open " << filename << ": " << std::strerror (errno));
+        }
+        ColumnarTraceFileHeader header;
+        std::memset (&header, 0, sizeof (header));
+        std::strncpy (header.magic, COLUMNAR_TRACE_MAGIC, sizeof (header.magic) - 1);
+        header.version = COLUMNAR_TRACE_VERSION;
+        Write (&header, sizeof (header));
+
+        m_chunk.time.reserve (m_chunkEvents);
+        m_chunk.kind.reserve (m_chunkEvents);
+        m_chunk.location.reserve (m_chunkEvents);
+        m_chunk.uid.reserve (m_chunkEvents);
+        m_chunk.size.reserve (m_chunkEvents);
+    }
+
+    ~ColumnarTraceWriter ()
+    {
+        Close ();
+    }
+
+    /**
+     * \returns dictionary index for the (node, device) pair
+     */
+    uint32_t AddLocation (uint32_t node, uint32_t device)
+    {
+        ColumnarTraceLocation l = { node, device };
+        m_newLocations.push_back (l);
+        return m_nLocations++;
+    }
+
+    void Record (uint8_t kind, uint32_t location, Ptr<const Packet> p)
+    {
+        if (m_file == NULL)
+        {
+            return;
+        }
+        m_chunk.time.push_back (Simulator::Now ().GetNanoSeconds ());
+        m_chunk.kind.push_back (kind);
+        m_chunk.location.push_back (location);
+        m_chunk.uid.push_back (p->GetUid ());
+        m_chunk.size.push_back (p->GetSize ());
+        if (m_chunk.GetN () >= m_chunkEvents)
+        {
+            Flush ();
+        }
+    }
+
+    /**
+     * Encode and write the buffered events as one chunk
+     */
+    void Flush (void)
+    {
+        if (m_file == NULL || (m_chunk.GetN () == 0 && m_newLocations.empty ()))
+        {
+            return;
+        }
+        ColumnarTrace::EncodeChunk (m_chunk, m_newLocations, m_lastTime, m_lastUid, m_payload);
+
+        ColumnarTraceChunkHeader header;
+        header.events = m_chunk.GetN ();
+        header.newLocations = m_newLocations.size ();
+        header.flags = 0;
+        header.rawBytes = m_payload.size ();
+        header.storedBytes = m_payload.size ();
+
+        const std::string *stored = &m_payload;
+#ifdef COLUMNAR_TRACE_ZLIB
+        if (m_deflate)
+        {
+            uLongf len = compressBound (m_payload.size ());
+            m_deflated.resize (len);
+            if (compress2 ((Bytef *) &m_deflated[0], &len, (const Bytef *) m_payload.data (),
+                           m_payload.size (), 1) == Z_OK && len < m_payload.size ())
+            {
+                m_deflated.resize (len);
+                header.flags |= COLUMNAR_TRACE_DEFLATED;
+                header.storedBytes = len;
+                stored = &m_deflated;
+            }
+        }
+#endif
+        Write (&header, sizeof (header));
+        Write (stored->data (), stored->size ());
+
+        m_events += m_chunk.GetN ();
+        m_chunk.Clear ();
+        m_newLocations.clear ();
+    }
+
+    void Close (void)
+    {
+        Flush ();
+        if (m_file)
+        {
+            fclose (m_file);
+            m_file = NULL;
+        }
+    }
+
+    uint64_t GetEventsWritten (void) const
+    {
+        return m_events;
+    }
+
+    uint64_t GetBytesWritten (void) const
+    {
+        return m_bytes;
+    }
+
+    /**
+     * Trace sink, bound to a writer, location and event kind
+     */
+    static void PacketEvent (Ptr<ColumnarTraceWriter> writer, uint32_t location, uint8_t kind,
+                             Ptr<const Packet> p)
+    {
+        writer->Record (kind, location, p);
+    }
+
+private:
+    void Write (const void *data, size_t len)
+    {
+        if (fwrite (data, 1, len, m_file) != len)
+        {
+            NS_FATAL_ERROR ("Columnar trace write failed: " << std::strerror (errno));
+        }
+        m_bytes += len;
+    }
+
+    FILE *m_file;
+    uint32_t m_chunkEvents;
+    bool m_deflate;
+    ColumnarTraceChunk m_chunk;
+    std::vector<ColumnarTraceLocation> m_newLocations;     // not yet written
+    uint32_t m_nLocations = 0;
+    int64_t m_lastTime;
+    uint64_t m_lastUid;
+    std::string m_payload;
+    std::string m_deflated;
+    uint64_t m_events;
+    uint64_t m_bytes;
+};
+
+
+class ColumnarTraceHelper
+{
+public:
+    /**
+     * \param filename trace file to create
+     *
+     * \param deflate compress the chunks, needs COLUMNAR_TRACE_ZLIB
+     *
+     * \param chunkEvents events buffered per chunk
+     */
+    ColumnarTraceHelper (const std::string &filename, bool deflate = false,
+                         uint32_t chunkEvents = 1 << 16)
+    {
+        m_writer = Create<ColumnarTraceWriter> (filename, chunkEvents, deflate);
+        Simulator::ScheduleDestroy (&ColumnarTraceWriter::Close, m_writer);
+    }
+
+    /**
+     * Trace one device
+     */
+    void Install (Ptr<NetDevice> device)
+    {
+        uint32_t location = m_writer->AddLocation (device->GetNode ()->GetId (), device->GetIfIndex ());
+
+        Ptr<WifiNetDevice> wifi = DynamicCast<WifiNetDevice> (device);
+        if (wifi)
+        {
+            Ptr<WifiMac> mac = wifi->GetMac ();
+            Connect (mac, "MacTx", location, TRACE_ENQUEUE);
+            Connect (mac, "MacRx", location, TRACE_RX);
+            Connect (mac, "MacTxDrop", location, TRACE_DROP);
+            Connect (mac, "MacRxDrop", location, TRACE_DROP);
+            return;
+        }
+
+        PointerValue queue;
+        if (device->GetAttributeFailSafe ("TxQueue", queue))
+        {
+            Ptr<Queue<Packet> > txQueue = queue.Get<Queue<Packet> > ();
+            if (txQueue)
+            {
+                Connect (txQueue, "Enqueue", location, TRACE_ENQUEUE);
+                Connect (txQueue, "Dequeue", location, TRACE_DEQUEUE);
+                Connect (txQueue, "Drop", location, TRACE_DROP);
+            }
+        }
+        Connect (device, "MacRx", location, TRACE_RX);
+        Connect (device, "PhyRxDrop", location, TRACE_DROP);
+    }
+
+    void Install (const NetDeviceContainer &devices)
+    {
+        for (uint32_t i = 0; i < devices.GetN (); ++i)
+        {
+            Install (devices.Get (i));
+        }
+    }
+
+    /**
+     * Trace every device of every node, skipping loopback
+     */
+    void InstallAll (void)
+    {
+        for (NodeList::Iterator n = NodeList::Begin (); n != NodeList::End (); ++n)
+        {
+            for (uint32_t i = 0; i < (*n)->GetNDevices (); ++i)
+            {
+                Ptr<NetDevice> device = (*n)->GetDevice (i);
+                if (device->GetInstanceTypeId ().GetName () != "ns3::LoopbackNetDevice")
+                {
+                    Install (device);
+                }
+            }
+        }
+    }
+
+    Ptr<ColumnarTraceWriter> GetWriter (void) const
+    {
+        return m_writer;
+    }
+
+private:
+    // Sources a device type does not have are skipped
+    void Connect (Ptr<Object> object, const std::string &source, uint32_t location, uint8_t kind)
+    {
+        object->TraceConnectWithoutContext (source,
+            MakeBoundCallback (&ColumnarTraceWriter::PacketEvent, m_writer, location, kind));
+    }
+
+    Ptr<ColumnarTraceWriter> m_writer;
+};
+
+
+#endif /* COLUMNAR_TRACE_HELPER_H */
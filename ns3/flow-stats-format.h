@@ -0,0 +1,223 @@
+/**
+ * @author Harshil Bhatt
+ * @create date 2026-10-19 23:14:26
+ * @desc
+ *      On-disk layout and streaming reader of the flow statistics written
+ *      by flow-stats-streamer.h. Kept free of ns-3 headers so
+ *      flow-stats-reader.cpp builds on its own.
+ *
+ *      A file is one FlowStatsHeader followed by FlowStatsRecords in host
+ *      byte order. Every interval the streamer writes one record per flow
+ *      that sent, received or lost anything during that interval; all
+ *      counters and histograms in a record cover that interval only, so a
+ *      reader sums records to get totals and never needs more than one
+ *      record per flow in memory.
+ *
+ *      Delay and jitter histograms have FLOW_STATS_BINS log2 bins in
+ *      microseconds: bin 0 is under 1 us, bin k covers [2^(k-1), 2^k) us
+ *      and the last bin takes everything above.
+ */
+
+#ifndef FLOW_STATS_FORMAT_H
+#define FLOW_STATS_FORMAT_H
+
+#include <stdint.h>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+
+#define FLOW_STATS_MAGIC        "NS3FSTS"
+#define FLOW_STATS_VERSION      1
+#define FLOW_STATS_BINS         32
+
+
+struct FlowStatsHeader
+{
+    char magic[8];          // FLOW_STATS_MAGIC, nul terminated
+    uint32_t version;       // FLOW_STATS_VERSION
+    uint32_t recordSize;    // sizeof (FlowStatsRecord)
+    int64_t interval;       // ns between snapshots
+};
+
+
+struct FlowStatsRecord
+{
+    int64_t time;           // end of the interval, ns
+    uint32_t flowId;
+    uint32_t srcAddress;    // Ipv4 addresses, host order
+    uint32_t dstAddress;
+    uint16_t srcPort;
+    uint16_t dstPort;
+    uint8_t protocol;
+    uint8_t reserved[7];
+
+    uint64_t txPackets;
+    uint64_t txBytes;
+    uint64_t rxPackets;
+    uint64_t rxBytes;
+    uint64_t lostPackets;   // dropped in the network
+    int64_t delaySum;       // ns, over rxPackets
+    int64_t jitterSum;      // ns, over jitterSamples
+    uint64_t jitterSamples;
+    uint32_t delayBins[FLOW_STATS_BINS];
+    uint32_t jitterBins[FLOW_STATS_BINS];
+};
+
+
+namespace FlowStats {
+
+/**
+ * \returns histogram bin of a delay or jitter in ns
+ */
+inline uint32_t
+GetBin (int64_t ns)
+{
+    uint64_t us = ns > 0 ? uint64_t (ns) / 1000 : 0;
+    uint32_t bin = 0;
+    while (us > 0 && bin < FLOW_STATS_BINS - 1)
+    {
+        us >>= 1;
+        ++bin;
+    }
+    return bin;
+}
+
+/**
+ * \returns lower edge of a bin in microseconds
+ */
+inline double
+GetBinStart (uint32_t bin)
+{
+    return bin ? double (uint64_t (1) << (bin - 1)) : 0;
+}
+
+/**
+ * \returns upper edge of a bin in microseconds
+ */
+inline double
+GetBinEnd (uint32_t bin)
+{
+    return double (uint64_t (1) << bin);
+}
+
+/**
+ * \returns upper edge (us) of the bin holding the q quantile, 0 if empty
+ */
+inline double
+GetQuantile (const uint32_t *bins, double q)
+{
+    uint64_t total = 0;
+    for (uint32_t b = 0; b < FLOW_STATS_BINS; ++b)
+    {
+        total += bins[b];
+    }
+    if (total == 0)
+    {
+        return 0;
+    }
+    uint64_t target = uint64_t (q * total + 0.5);
+    uint64_t seen = 0;
+    for (uint32_t b = 0; b < FLOW_STATS_BINS; ++b)
+    {
+        seen += bins[b];
+        if (seen >= target && seen > 0)
+        {
+            return GetBinEnd (b);
+        }
+    }
+    return GetBinEnd (FLOW_STATS_BINS - 1);
+}
+
+} // namespace FlowStats
+
+
+/**
+ * Reads a flow statistics file one record at a time.
+ *
+ *      FlowStatsReader reader;
+ *      if (!reader.Open ("x.fstats")) ... reader.GetError ()
+ *      FlowStatsRecord r;
+ *      while (reader.Next (r)) ...
+ *      if (!reader.GetError ().empty ()) ...
+ */
+class FlowStatsReader
+{
+public:
+    FlowStatsReader ()
+        : m_file (NULL), m_interval (0)
+    {
+    }
+
+    ~FlowStatsReader ()
+    {
+        if (m_file)
+        {
+            fclose (m_file);
+        }
+    }
+
+    bool Open (const std::string &path)
+    {
+        m_file = fopen (path.c_str (), "rb");
+        if (m_file == NULL)
+        {
+            m_error = "cannot open " + path;
+            return false;
+        }
+        FlowStatsHeader header;
+        if (fread (&header, sizeof (header), 1, m_file) != 1
+            || strncmp (header.magic, FLOW_STATS_MAGIC, sizeof (header.magic)) != 0
+            || header.version != FLOW_STATS_VERSION
+            || header.recordSize != sizeof (FlowStatsRecord))
+        {
+            m_error = path + " is not a version 1 flow statistics file";
+            return false;
+        }
+        m_interval = header.interval;
+        return true;
+    }
+
+    /**
+     * \returns false at the end of the file, or on error with
+     *          GetError () set
+     */
+    bool Next (FlowStatsRecord &record)
+    {
+        if (m_file == NULL)
+        {
+            return false;
+        }
+        size_t got = fread (&record, 1, sizeof (record), m_file);
+        if (got == sizeof (record))
+        {
+            return true;
+        }
+        if (got != 0)
+        {
+            m_error = "truncated record";
+        }
+        return false;
+    }
+
+    /**
+     * \returns ns between snapshots
+     */
+    int64_t GetInterval (void) const
+    {
+        return m_interval;
+    }
+
+    const std::string &GetError (void) const
+    {
+        return m_error;
+    }
+
+private:
+    FILE *m_file;
+    int64_t m_interval;
+    std::string m_error;
+};
+
+
+#endif /* FLOW_STATS_FORMAT_H */
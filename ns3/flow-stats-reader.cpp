@@ -0,0 +1,146 @@
+/*
+Created on Mon Oct 19 23:48:37 2026
+@author: Harshil Bhatt
+*/
+
+
+/*  Reads the per-interval flow statistics written by flow-stats-streamer.h.
+
+    By default prints one CSV row per flow and interval, i.e. the live
+    throughput, loss and delay curves:
+
+        time,flow,src,dst,proto,tx_packets,rx_packets,lost,throughput_bps,
+        delay_mean_us,delay_p50_us,delay_p99_us,jitter_mean_us
+
+    Percentiles are the upper edge of the log2 histogram bin they fall in.
+    -s prints one line per flow over the whole run instead, -f <id> keeps
+    a single flow. Records are streamed, so memory only grows with the
+    number of flows (-s) and the file can still be growing.
+
+    Build and run
+        g++ -O2 -std=c++17 -o flow-stats-reader flow-stats-reader.cpp
+        ./flow-stats-reader trace/global-routing/simple-global-routing.fstats > curves.csv
+        ./flow-stats-reader -s trace/global-routing/simple-global-routing.fstats
+*/
+
+#include <bits/stdc++.h>
+
+#include "flow-stats-format.h"
+
+using namespace std;
+
+
+static string addr(uint32_t a) {
+    char buff[16];
+    snprintf(buff, sizeof(buff), "%u.%u.%u.%u", a >> 24, (a >> 16) & 0xff, (a >> 8) & 0xff, a & 0xff);
+    return buff;
+}
+
+
+struct Total {
+    FlowStatsRecord sum;
+    int64_t first, last;
+};
+
+
+static void add(FlowStatsRecord &sum, const FlowStatsRecord &r) {
+    sum.txPackets += r.txPackets;
+    sum.txBytes += r.txBytes;
+    sum.rxPackets += r.rxPackets;
+    sum.rxBytes += r.rxBytes;
+    sum.lostPackets += r.lostPackets;
+    sum.delaySum += r.delaySum;
+    sum.jitterSum += r.jitterSum;
+    sum.jitterSamples += r.jitterSamples;
+    for (int b = 0; b < FLOW_STATS_BINS; ++b) {
+        sum.delayBins[b] += r.delayBins[b];
+        sum.jitterBins[b] += r.jitterBins[b];
+    }
+}
+
+
+int main(int argc, char *argv[]) {
+    bool summary = false;
+    long flow = -1;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "sf:")) != -1) {
+        switch (opt) {
+            case 's': summary = true; break;
+            case 'f': flow = atol(optarg); break;
+            default: break;
+        }
+    }
+    if (optind != argc - 1) {
+        fprintf(stderr, "Script Usage: %s [-s] [-f flow] <stats.fstats>\n", argv[0]);
+        return 1;
+    }
+
+    FlowStatsReader reader;
+    if (!reader.Open(argv[optind])) {
+        fprintf(stderr, "%s\n", reader.GetError().c_str());
+        return 1;
+    }
+    double interval = reader.GetInterval() / 1e9;
+
+    static char buff[1 << 20];
+    setvbuf(stdout, buff, _IOFBF, sizeof(buff));
+    if (!summary)
+        printf("time,flow,src,dst,proto,tx_packets,rx_packets,lost,throughput_bps,"
+               "delay_mean_us,delay_p50_us,delay_p99_us,jitter_mean_us\n");
+
+    map<uint32_t, Total> totals;
+    FlowStatsRecord r;
+    while (reader.Next(r)) {
+        if (flow >= 0 && r.flowId != (uint32_t)flow)
+            continue;
+
+        if (summary) {
+            auto it = totals.find(r.flowId);
+            if (it == totals.end()) {
+                Total t;
+                memset(&t, 0, sizeof(t));
+                t.sum = r;
+                t.first = r.time;
+                t.last = r.time;
+                totals[r.flowId] = t;
+            } else {
+                add(it->second.sum, r);
+                it->second.last = r.time;
+            }
+            continue;
+        }
+
+        printf("%.6f,%u,%s:%u,%s:%u,%u,%llu,%llu,%llu,%.0f,%.1f,%.0f,%.0f,%.1f\n",
+               r.time / 1e9, r.flowId, addr(r.srcAddress).c_str(), r.srcPort,
+               addr(r.dstAddress).c_str(), r.dstPort, r.protocol,
+               (unsigned long long)r.txPackets, (unsigned long long)r.rxPackets,
+               (unsigned long long)r.lostPackets, r.rxBytes * 8 / interval,
+               r.rxPackets ? r.delaySum / 1e3 / r.rxPackets : 0.0,
+               FlowStats::GetQuantile(r.delayBins, 0.5), FlowStats::GetQuantile(r.delayBins, 0.99),
+               r.jitterSamples ? r.jitterSum / 1e3 / r.jitterSamples : 0.0);
+    }
+    if (!reader.GetError().empty()) {
+        fflush(stdout);
+        fprintf(stderr, "%s: %s\n", argv[optind], reader.GetError().c_str());
+        return 1;
+    }
+
+    if (summary) {
+        printf("%6s %-22s %-22s %5s %10s %10s %8s %12s %10s %10s %10s\n", "flow", "source", "destination",
+               "proto", "tx", "rx", "lost", "goodput bps", "delay us", "p99 us", "jitter us");
+        for (auto &kv : totals) {
+            const FlowStatsRecord &s = kv.second.sum;
+            // the first record covers the interval before its time
+            double span = (kv.second.last - kv.second.first) / 1e9 + interval;
+            string src = addr(s.srcAddress) + ":" + to_string(s.srcPort);
+            string dst = addr(s.dstAddress) + ":" + to_string(s.dstPort);
+            printf("%6u %-22s %-22s %5u %10llu %10llu %8llu %12.0f %10.1f %10.0f %10.1f\n", kv.first,
+                   src.c_str(), dst.c_str(), s.protocol, (unsigned long long)s.txPackets,
+                   (unsigned long long)s.rxPackets, (unsigned long long)s.lostPackets, s.rxBytes * 8 / span,
+                   s.rxPackets ? s.delaySum / 1e3 / s.rxPackets : 0.0, FlowStats::GetQuantile(s.delayBins, 0.99),
+                   s.jitterSamples ? s.jitterSum / 1e3 / s.jitterSamples : 0.0);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,379 @@
+/**
+ * @author Harshil Bhatt
+ * @create date 2026-10-19 23:31:02
+ * @desc
+ *      Streaming per-flow statistics, a constant-memory stand-in for
+ *      FlowMonitor's end-of-run XML.
+ *
+ *      Flows are told apart by their 5-tuple with FlowMonitor's
+ *      Ipv4FlowClassifier. Every IPv4 packet a node originates gets a
+ *      FlowStatsTag (flow id, send time); the destination's LocalDeliver
+ *      and any Ipv4 / device queue / queue disc drop along the way read it
+ *      back. Nothing is stored per packet, the tag carries it.
+ *
+ *      Per flow the streamer keeps one FlowStatsRecord for the current
+ *      interval (counters plus fixed-size log2 delay and jitter
+ *      histograms). Every Interval the records of the flows that did
+ *      anything are appended to the file and reset, so memory depends on
+ *      the number of flows only, never on the run length, and the file
+ *      can be read while the simulation is still going.
+ *
+ *      Install it once addresses are assigned (queue discs are attached
+ *      by Ipv4AddressHelper::Assign):
+ *          Ptr<FlowStatsStreamer> stats = Create<FlowStatsStreamer> ("x.fstats", Seconds (1));
+ *          stats->InstallAll ();
+ *      The last partial interval is written and the file closed by
+ *      Simulator::Destroy (). Snapshots stop being scheduled once nothing
+ *      else is left in the event queue. flow-stats-reader.cpp turns the
+ *      file into CSV curves or a per-flow summary.
+ */
+
+#ifndef FLOW_STATS_STREAMER_H
+#define FLOW_STATS_STREAMER_H
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/traffic-control-module.h"
+#include "ns3/ipv4-flow-classifier.h"
+
+#include "flow-stats-format.h"
+
+
+using namespace ns3;
+
+
+class FlowStatsTag : public Tag
+{
+public:
+    static TypeId GetTypeId (void)
+    {
+        static TypeId tid = TypeId ("FlowStatsTag")
+            .SetParent<Tag> ()
+            .AddConstructor<FlowStatsTag> ();
+        return tid;
+    }
+
+    FlowStatsTag ()
+        : m_flowId (0), m_txTime (0)
+    {
+    }
+
+    FlowStatsTag (uint32_t flowId, int64_t txTime)
+        : m_flowId (flowId), m_txTime (txTime)
+    {
+    }
+
+    uint32_t GetFlowId (void) const     { return m_flowId; }
+    int64_t GetTxTime (void) const      { return m_txTime; }
+
+    virtual TypeId GetInstanceTypeId (void) const
+    {
+        return GetTypeId ();
+    }
+
+    virtual uint32_t GetSerializedSize (void) const
+    {
+        return 12;
+    }
+
+    virtual void Serialize (TagBuffer i) const
+    {
+        i.WriteU32 (m_flowId);
+        i.WriteU64 (m_txTime);
+    }
+
+    virtual void Deserialize (TagBuffer i)
+    {
+        m_flowId = i.ReadU32 ();
+        m_txTime = i.ReadU64 ();
+    }
+
+    virtual void Print (std::ostream &os) const
+    {
+        os << "flow=" << m_flowId << " tx=" << m_txTime << "ns";
+    }
+
+private:
+    uint32_t m_flowId;
+    int64_t m_txTime;       // ns
+};
+
+
+class FlowStatsStreamer : public SimpleRefCount<FlowStatsStreamer>
+{
+public:
+    /**
+     * \param filename file to create, truncated if it exists
+     *
+     * \param interval time between snapshots
+     */
+    FlowStatsStreamer (const std::string &filename, Time interval)
+        : m_interval (interval), m_records (0)
+    {
+        NS_ABORT_MSG_IF (!interval.IsStrictlyPositive (), "Flow stats interval must be positive");
+        m_classifier = Create<Ipv4FlowClassifier> ();
+        m_file = fopen (filename.c_str (), "wb");
+        if (m_file == NULL)
+        {
+            NS_FATAL_ERROR ("Cannot open " << filename << ": " << std::strerror (errno));
+        }
+        setvbuf (m_file, NULL, _IOFBF, 1 << 20);
+
+        FlowStatsHeader header;
+        std::memset (&header, 0, sizeof (header));
+        std::strncpy (header.magic, FLOW_STATS_MAGIC, sizeof (header.magic) - 1);
+        header.version = FLOW_STATS_VERSION;
+        header.recordSize = sizeof (FlowStatsRecord);
+        header.interval = interval.GetNanoSeconds ();
+        Write (&header, sizeof (header));
+
+        m_snapshot = Simulator::Schedule (m_interval, &FlowStatsStreamer::Snapshot, this);
+        Simulator::ScheduleDestroy (&FlowStatsStreamer::Close, Ptr<FlowStatsStreamer> (this));
+    }
+
+    ~FlowStatsStreamer ()
+    {
+        Close ();
+    }
+
+    /**
+     * Watch the packets one node sends, receives and drops
+     */
+    void Install (Ptr<Node> node)
+    {
+        Ptr<FlowStatsStreamer> self (this);
+        Ptr<Ipv4L3Protocol> ipv4 = node->GetObject<Ipv4L3Protocol> ();
+        if (ipv4 == 0)
+        {
+            return;
+        }
+        ipv4->TraceConnectWithoutContext ("SendOutgoing", MakeBoundCallback (&FlowStatsStreamer::Sent, self));
+        ipv4->TraceConnectWithoutContext ("LocalDeliver", MakeBoundCallback (&FlowStatsStreamer::Delivered, self));
+        ipv4->TraceConnectWithoutContext ("Drop", MakeBoundCallback (&FlowStatsStreamer::IpDropped, self));
+
+        Ptr<TrafficControlLayer> tc = node->GetObject<TrafficControlLayer> ();
+        for (uint32_t i = 0; i < node->GetNDevices (); ++i)
+        {
+            Ptr<NetDevice> device = node->GetDevice (i);
+            PointerValue queue;
+            if (device->GetAttributeFailSafe ("TxQueue", queue) && queue.Get<Queue<Packet> > ())
+            {
+                queue.Get<Queue<Packet> > ()->TraceConnectWithoutContext ("Drop",
+                    MakeBoundCallback (&FlowStatsStreamer::PacketDropped, self));
+            }
+            Ptr<QueueDisc> disc = tc ? tc->GetRootQueueDiscOnDevice (device) : 0;
+            if (disc)
+            {
+                disc->TraceConnectWithoutContext ("Drop",
+                    MakeBoundCallback (&FlowStatsStreamer::ItemDropped, self));
+            }
+        }
+    }
+
+    void Install (const NodeContainer &nodes)
+    {
+        for (uint32_t i = 0; i < nodes.GetN (); ++i)
+        {
+            Install (nodes.Get (i));
+        }
+    }
+
+    void InstallAll (void)
+    {
+        Install (NodeContainer::GetGlobal ());
+    }
+
+    void Close (void)
+    {
+        if (m_file == NULL)
+        {
+            return;
+        }
+        Simulator::Cancel (m_snapshot);
+        WriteSnapshot ();
+        fclose (m_file);
+        m_file = NULL;
+    }
+
+    uint64_t GetRecordsWritten (void) const
+    {
+        return m_records;
+    }
+
+    uint32_t GetNFlows (void) const
+    {
+        return m_flows.size ();
+    }
+
+private:
+    struct Flow
+    {
+        FlowStatsRecord record;     // current interval
+        int64_t lastDelay;          // ns, for jitter
+        bool hasDelay;
+        bool active;                // anything happened this interval
+    };
+
+    void Snapshot (void)
+    {
+        WriteSnapshot ();
+        if (!Simulator::IsFinished ())
+        {
+            m_snapshot = Simulator::Schedule (m_interval, &FlowStatsStreamer::Snapshot, this);
+        }
+    }
+
+    /**
+     * Write and reset the records of every flow active since the last
+     * snapshot
+     */
+    void WriteSnapshot (void)
+    {
+        int64_t now = Simulator::Now ().GetNanoSeconds ();
+        for (Flow &flow : m_flows)
+        {
+            if (!flow.active)
+            {
+                continue;
+            }
+            flow.record.time = now;
+            Write (&flow.record, sizeof (flow.record));
+            ++m_records;
+            ResetInterval (flow.record);
+            flow.active = false;
+        }
+        // Readers can follow the file while the run goes on
+        fflush (m_file);
+    }
+
+    static void Sent (Ptr<FlowStatsStreamer> stats, const Ipv4Header &header,
+                      Ptr<const Packet> packet, uint32_t interface)
+    {
+        uint32_t flowId, packetId;
+        if (!stats->m_classifier->Classify (header, packet, &flowId, &packetId))
+        {
+            return;
+        }
+        FlowStatsTag tag (flowId, Simulator::Now ().GetNanoSeconds ());
+        if (!ConstCast<Packet> (packet)->ReplacePacketTag (tag))
+        {
+            packet->AddPacketTag (tag);
+        }
+
+        Flow &flow = stats->GetFlow (flowId);
+        ++flow.record.txPackets;
+        flow.record.txBytes += packet->GetSize () + header.GetSerializedSize ();
+        flow.active = true;
+    }
+
+    static void Delivered (Ptr<FlowStatsStreamer> stats, const Ipv4Header &header,
+                           Ptr<const Packet> packet, uint32_t interface)
+    {
+        FlowStatsTag tag;
+        if (!packet->PeekPacketTag (tag))
+        {
+            return;
+        }
+        Flow &flow = stats->GetFlow (tag.GetFlowId ());
+        int64_t delay = Simulator::Now ().GetNanoSeconds () - tag.GetTxTime ();
+        FlowStatsRecord &r = flow.record;
+        ++r.rxPackets;
+        r.rxBytes += packet->GetSize () + header.GetSerializedSize ();
+        r.delaySum += delay;
+        ++r.delayBins[FlowStats::GetBin (delay)];
+        if (flow.hasDelay)
+        {
+            int64_t jitter = std::llabs (delay - flow.lastDelay);
+            r.jitterSum += jitter;
+            ++r.jitterSamples;
+            ++r.jitterBins[FlowStats::GetBin (jitter)];
+        }
+        flow.lastDelay = delay;
+        flow.hasDelay = true;
+        flow.active = true;
+    }
+
+    static void IpDropped (Ptr<FlowStatsStreamer> stats, const Ipv4Header &header, Ptr<const Packet> packet,
+                           Ipv4L3Protocol::DropReason reason, Ptr<Ipv4> ipv4, uint32_t interface)
+    {
+        stats->Lost (packet);
+    }
+
+    static void PacketDropped (Ptr<FlowStatsStreamer> stats, Ptr<const Packet> packet)
+    {
+        stats->Lost (packet);
+    }
+
+    static void ItemDropped (Ptr<FlowStatsStreamer> stats, Ptr<const QueueDiscItem> item)
+    {
+        stats->Lost (item->GetPacket ());
+    }
+
+    void Lost (Ptr<const Packet> packet)
+    {
+        FlowStatsTag tag;
+        if (packet->PeekPacketTag (tag))
+        {
+            Flow &flow = GetFlow (tag.GetFlowId ());
+            ++flow.record.lostPackets;
+            flow.active = true;
+        }
+    }
+
+    /**
+     * \returns state of a flow, created with its 5-tuple on first use;
+     *          the classifier numbers flows 1, 2, 3, ...
+     */
+    Flow &GetFlow (uint32_t flowId)
+    {
+        while (m_flows.size () < flowId)
+        {
+            Flow flow;
+            std::memset (&flow, 0, sizeof (flow));
+            uint32_t id = m_flows.size () + 1;
+            Ipv4FlowClassifier::FiveTuple t = m_classifier->FindFlow (id);
+            flow.record.flowId = id;
+            flow.record.srcAddress = t.sourceAddress.Get ();
+            flow.record.dstAddress = t.destinationAddress.Get ();
+            flow.record.srcPort = t.sourcePort;
+            flow.record.dstPort = t.destinationPort;
+            flow.record.protocol = t.protocol;
+            m_flows.push_back (flow);
+        }
+        return m_flows[flowId - 1];
+    }
+
+    static void ResetInterval (FlowStatsRecord &r)
+    {
+        r.txPackets = r.txBytes = r.rxPackets = r.rxBytes = r.lostPackets = 0;
+        r.delaySum = r.jitterSum = 0;
+        r.jitterSamples = 0;
+        std::memset (r.delayBins, 0, sizeof (r.delayBins));
+        std::memset (r.jitterBins, 0, sizeof (r.jitterBins));
+    }
+
+    void Write (const void *data, size_t len)
+    {
+        if (m_file && fwrite (data, 1, len, m_file) != len)
+        {
+            NS_FATAL_ERROR ("Flow stats write failed: " << std::strerror (errno));
+        }
+    }
+
+    FILE *m_file;
+    Time m_interval;
+    EventId m_snapshot;
+    Ptr<Ipv4FlowClassifier> m_classifier;
+    std::vector<Flow> m_flows;          // by flow id - 1
+    uint64_t m_records;
+};
+
+
+#endif /* FLOW_STATS_STREAMER_H */
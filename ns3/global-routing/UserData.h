@@ -7,4 +7,22 @@ public:
     int packetSize         = 210;
     std::string dataRate   = "448kb/s";
     bool EnableFlowMonitor = false;    
+    bool EnableTracing     = true;
+    bool EnablePcap        = false;
+    bool EnableFlowStats   = true;
+    double FlowStatsInterval = 0.5;    // seconds between snapshots
+    std::string BottleneckRate  = "1.5Mbps";
+    std::string BottleneckDelay = "10ms";
+    std::string QueueDisc  = "PfifoFast";   // PfifoFast, Pfifo, FqCoDel, CoDel, Pie or Red
+    int QueueLimit         = 0;             // packets, 0 keeps the disc's default
+    std::string DeviceQueue = "100p";       // below the disc; keep it small for AQM
+    bool EnableQueueStats  = true;
+    double QueueSampleInterval = 0.01;      // seconds between occupancy samples
+    double TcpStart        = 1.2;
+    double TcpStop         = 10.0;
+    double StopTime        = 11.0;
+    std::string Failures   = "";            // "<down>[-<up>]@<a>-<b>,...", seconds and node ids
+    std::string BackupLink = "";            // "<a>-<b>", standby link that failures reroute over
+    int BackupMetric       = 10;            // routing metric of the backup link, the others have 1
+    double DetectDelay     = 0.05;          // seconds from a link change to recomputed routes
 };
\ No newline at end of file
@@ -14,17 +14,39 @@
  *		
  *		 - all links are point-to-point links with indicated one-way BW/delay
  *		 - CBR/UDP flows from n0 to n3, and from n3 to n1
- *		 - FTP/TCP flow from n0 to n3, starting at time 1.2 to time 1.35 sec.
+ *		 - Bulk TCP flow from n0 to n3 from --tcpStart (1.2 s) to --tcpStop
+ *		   (10 s), the load that fills the bottleneck queue
  *		 - UDP packet size of 210 bytes, with per-packet interval 0.00375 sec.
  *		   (i.e., DataRate of 448,000 bps)
- *		 - DropTail queues 
- *		 - Tracing of queues and packet receptions to file "simple-global-routing.tr"
+ *		 - --queueDisc (PfifoFast, Pfifo, FqCoDel, CoDel, Pie or Red) on both
+ *		   ends of n2-n3, DropTail --deviceQueue below it; keep that small
+ *		   (e.g. 5p) or it hides the AQM
+ *		 - --queuestats reports sojourn time and occupancy of the bottleneck
+ *		   discs, and per flow the delay before the TCP flow starts (idle)
+ *		   against the delay after it (loaded): latency under load
+ *		 - Tracing of queues and packet receptions to the columnar trace
+ *		   "simple-global-routing.ctr" (read it with columnar-trace-dump)
+ *		 - Per-flow throughput, loss, delay and jitter every
+ *		   --flowstatsInterval seconds to "simple-global-routing.fstats"
+ *		   (read it with flow-stats-reader); --flowmonitor still writes the
+ *		   end-of-run FlowMonitor XML
+ *		 - --failures takes links down and up ("3-6@0-2": n0-n2 down at
+ *		   3 s, up at 6 s) and recomputes the routes --detectDelay later,
+ *		   reporting the wall-clock time of each recomputation and, per
+ *		   flow, loss and time to recover. --backupLink adds a standby
+ *		   5 Mb/s, 2ms link (metric --backupMetric) to reroute over, e.g.
+ *		   --backupLink=0-3. A flow whose destination address sits on a
+ *		   failed link stays cut off: addresses belong to interfaces
  */
 
+#include <cstdio>
 #include <iostream>
 #include <fstream>
 #include <string>
 #include <cassert>
+#include <iomanip>
+#include <map>
+#include <sstream>
 
 
 #include "global-routing.h"
@@ -44,25 +66,84 @@ main (int argc, char *argv[])
 
 	NodeContainer n0n2 = CreateContainer (nodes, 0, 2, data);
 	NodeContainer n1n2 = CreateContainer (nodes, 1, 2, data);
-	NodeContainer n3n2 = CreateContainer (nodes, 3, 1, data);
+	NodeContainer n3n2 = CreateContainer (nodes, 3, 2, data);
 
 	Ipv4InterfaceContainer i0i2 = Internet (nodes, n0n2, "10.1.1.0", "255.255.255.0");
 	Ipv4InterfaceContainer i1i2 = Internet (nodes, n1n2, "10.1.2.0", "255.255.255.0");
-	Ipv4InterfaceContainer i3i2 = Internet (nodes, n3n2, "10.1.3.0", "255.255.255.0");
+	QueueDiscContainer bottleneckDiscs;
+	Ipv4InterfaceContainer i3i2 = Bottleneck (data, n3n2, "10.1.3.0", "255.255.255.0", bottleneckDiscs);
+
+	std::map<std::string, Ipv4InterfaceContainer> links = {
+		{ "0-2", i0i2 },
+		{ "1-2", i1i2 },
+		{ "2-3", i3i2 },
+	};
+	if (!data.BackupLink.empty ())
+	{
+		links[data.BackupLink] = Backup (data, nodes, "10.1.4.0", "255.255.255.0");
+	}
 
 	Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
 
-	OnOffApp(data, nodes, 0, 3, i3i2, 1.0, 10.0);
-	OnOffApp(data, nodes, 3, 1, i1i2, 1.0, 10.0);
+	Tracing (data);
+
+	Ptr<OutageMonitor> outages = Create<OutageMonitor> ();
+	ApplicationContainer apps = OnOffApp(data, nodes, 0, 3, i3i2, 1.0, 10.0);
+	outages->Watch (apps.Get (0), apps.Get (1), "n0->n3 UDP");
+	apps = OnOffApp(data, nodes, 3, 1, i1i2, 1.0, 10.0);
+	outages->Watch (apps.Get (0), apps.Get (1), "n3->n1 UDP");
+	if (data.TcpStop > data.TcpStart)
+	{
+		apps = TcpApp(data, nodes, 0, 3, i3i2, data.TcpStart, data.TcpStop);
+		outages->Watch (apps.Get (0), apps.Get (1), "n0->n3 TCP");
+	}
+	Ptr<LinkFailureSchedule> failures = Failures (data, links, outages);
 
 	FlowMonitorHelper flowmonHelper;
-	if (data.EnableFlowMonitor)
+	Ptr<FlowMonitor> monitor;
+	if (data.EnableFlowMonitor || data.EnableQueueStats)
 	{
-		flowmonHelper.InstallAll ();
+		// 0.1 ms delay bins, the default 1 ms hides most of the idle delay
+		flowmonHelper.SetMonitorAttribute ("DelayBinWidth", DoubleValue (0.0001));
+		monitor = flowmonHelper.InstallAll ();
+	}
+	Ptr<QueueMonitor> queues;
+	FlowMonitor::FlowStatsContainer idle;
+	if (data.EnableQueueStats)
+	{
+		queues = Create<QueueMonitor> (Seconds (data.QueueSampleInterval));
+		queues->Install (bottleneckDiscs.Get (0), "n3->n2");
+		queues->Install (bottleneckDiscs.Get (1), "n2->n3");
+		queues->Start (Seconds (0));
+		Simulator::Schedule (Seconds (data.TcpStart), &SnapshotFlows, monitor, &idle);
+	}
+	if (data.EnableFlowStats)
+	{
+		Ptr<FlowStatsStreamer> stats = Create<FlowStatsStreamer> ("trace/global-routing/simple-global-routing.fstats",
+		                                                          Seconds (data.FlowStatsInterval));
+		stats->InstallAll ();
 	}
 
+	Simulator::Stop (Seconds (data.StopTime));
 	Simulator::Run();
 
+	if (data.EnableQueueStats)
+	{
+		std::cout << "Bottleneck " << data.BottleneckRate << " " << data.BottleneckDelay
+		          << ", " << data.QueueDisc << std::endl;
+		queues->Report (std::cout);
+		std::cout << std::endl;
+		LatencyUnderLoad (data, monitor, DynamicCast<Ipv4FlowClassifier> (flowmonHelper.GetClassifier ()), idle);
+	}
+
+	if (failures)
+	{
+		std::cout << std::endl << "Link changes" << std::endl;
+		failures->Report (std::cout);
+		std::cout << std::endl;
+		outages->Report (std::cout);
+	}
+
 	if (data.EnableFlowMonitor)
     {
       flowmonHelper.SerializeToXmlFile ("simple-global-routing.flowmon", false, false);
@@ -73,13 +154,31 @@ main (int argc, char *argv[])
 
 
 NodeContainer
-Init (Data data, int argc, char *argv[])
+Init (Data &data, int argc, char *argv[])
 {
 	Config::SetDefault ("ns3::OnOffApplication::PacketSize", UintegerValue (data.packetSize));
 	Config::SetDefault ("ns3::OnOffApplication::DataRate", StringValue (data.dataRate));
 
 	CommandLine cmd;
 	cmd.AddValue ("flowmonitor", "Enable Flow Monitor", data.EnableFlowMonitor);
+	cmd.AddValue ("tracing", "Enable columnar packet tracing", data.EnableTracing);
+	cmd.AddValue ("pcap", "Enable pcap tracing", data.EnablePcap);
+	cmd.AddValue ("flowstats", "Stream per-flow statistics snapshots", data.EnableFlowStats);
+	cmd.AddValue ("flowstatsInterval", "Seconds between flow statistics snapshots", data.FlowStatsInterval);
+	cmd.AddValue ("bottleneckRate", "Data rate of the n2-n3 link", data.BottleneckRate);
+	cmd.AddValue ("bottleneckDelay", "Delay of the n2-n3 link", data.BottleneckDelay);
+	cmd.AddValue ("queueDisc", "Bottleneck queue disc: PfifoFast, Pfifo, FqCoDel, CoDel, Pie or Red", data.QueueDisc);
+	cmd.AddValue ("queueLimit", "Queue disc limit in packets, 0 keeps the disc's default", data.QueueLimit);
+	cmd.AddValue ("deviceQueue", "Bottleneck device queue size below the disc, e.g. 5p", data.DeviceQueue);
+	cmd.AddValue ("queuestats", "Report bottleneck queue and latency under load", data.EnableQueueStats);
+	cmd.AddValue ("queueSampleInterval", "Seconds between queue occupancy samples", data.QueueSampleInterval);
+	cmd.AddValue ("tcpStart", "Start of the bulk TCP flow in seconds", data.TcpStart);
+	cmd.AddValue ("tcpStop", "End of the bulk TCP flow, not after tcpStart disables it", data.TcpStop);
+	cmd.AddValue ("stopTime", "Simulation end in seconds", data.StopTime);
+	cmd.AddValue ("failures", "Link changes, <down>[-<up>]@<a>-<b> in seconds and node ids, comma separated", data.Failures);
+	cmd.AddValue ("backupLink", "Standby link <a>-<b> to reroute over", data.BackupLink);
+	cmd.AddValue ("backupMetric", "Routing metric of the backup link", data.BackupMetric);
+	cmd.AddValue ("detectDelay", "Seconds from a link change to recomputed routes", data.DetectDelay);
 	cmd.Parse(argc, argv);
 
 	NS_LOG_INFO ("Creating Nodes.");
@@ -92,7 +191,7 @@ Init (Data data, int argc, char *argv[])
 NodeContainer
 CreateContainer (NodeContainer nodes, int a, int b, Data data)
 {
-	if ((a >= data.numNodes) || (b >= data.numNodes) || (a=b))
+	if ((a >= data.numNodes) || (b >= data.numNodes) || (a == b))
 	{
 		NS_LOG_ERROR ("Cannot create node container.");
 	} 
@@ -102,7 +201,7 @@ CreateContainer (NodeContainer nodes, int a, int b, Data data)
 
 
 NetDeviceContainer
-CreateChannel (NodeContainer nanb, std::string dataRate, std::string delay)
+CreateChannel (NodeContainer nanb, std::string dataRate, std::string delay, std::string queueSize)
 {
 	static bool firstCall = true;
 	if (firstCall)
@@ -113,10 +212,8 @@ CreateChannel (NodeContainer nanb, std::string dataRate, std::string delay)
 	PointToPointHelper p2p;
 	p2p.SetDeviceAttribute ("DataRate", StringValue(dataRate));
 	p2p.SetChannelAttribute ("Delay", StringValue(delay));
+	p2p.SetQueue ("ns3::DropTailQueue<Packet>", "MaxSize", StringValue(queueSize));
 	NetDeviceContainer dadb = p2p.Install (nanb);
-	AsciiTraceHelper ascii;
-	p2p.EnableAsciiAll (ascii.CreateFileStream ("trace/global-routing/simple-global-routing.tr"));
-	p2p.EnablePcapAll ("trace/global-routing/simple-global-routing");
 	return dadb;
 }
 
@@ -156,7 +253,77 @@ Internet (NodeContainer nodes, NodeContainer nanb, Ipv4Address NetworkAddress, I
 }
 
 
-void
+QueueDiscContainer
+InstallQueueDisc (Data data, NetDeviceContainer dadb)
+{
+	std::map<std::string, std::string> types = {
+		{ "PfifoFast", "PfifoFastQueueDisc" },
+		{ "Pfifo", "FifoQueueDisc" },
+		{ "FqCoDel", "FqCoDelQueueDisc" },
+		{ "CoDel", "CoDelQueueDisc" },
+		{ "Pie", "PieQueueDisc" },
+		{ "Red", "RedQueueDisc" },
+	};
+	std::map<std::string, std::string>::iterator it = types.find (data.QueueDisc);
+	NS_ABORT_MSG_IF (it == types.end (), "Unknown queue disc " << data.QueueDisc);
+	std::string type = "ns3::" + it->second;
+
+	if (data.QueueLimit > 0)
+	{
+		Config::SetDefault (type + "::MaxSize", StringValue (std::to_string (data.QueueLimit) + "p"));
+	}
+	if (data.QueueDisc == "Red")
+	{
+		// RED sizes its averaging from the link it sits on
+		Config::SetDefault ("ns3::RedQueueDisc::LinkBandwidth", StringValue (data.BottleneckRate));
+		Config::SetDefault ("ns3::RedQueueDisc::LinkDelay", StringValue (data.BottleneckDelay));
+	}
+
+	TrafficControlHelper tch;
+	tch.SetRootQueueDisc (type);
+	QueueDiscContainer discs = tch.Install (dadb);
+	return discs;
+}
+
+
+Ipv4InterfaceContainer
+Bottleneck (Data data, NodeContainer nanb, Ipv4Address NetworkAddress, Ipv4Mask SubnetMask, QueueDiscContainer &discs)
+{
+	// The internet stack is already on every node, Internet () installed it
+	NetDeviceContainer dadb = CreateChannel (nanb, data.BottleneckRate, data.BottleneckDelay, data.DeviceQueue);
+
+	// Before AssignIP, which would otherwise attach the default pfifo_fast
+	discs = InstallQueueDisc (data, dadb);
+
+	Ipv4InterfaceContainer iaib = AssignIP (dadb, NetworkAddress, SubnetMask);
+
+	return iaib;
+}
+
+
+// Standby link between the nodes named by data.BackupLink, costlier than
+// the rest so routes only take it once a failure leaves no other way
+Ipv4InterfaceContainer
+Backup (Data data, NodeContainer nodes, Ipv4Address NetworkAddress, Ipv4Mask SubnetMask)
+{
+	int a = -1;
+	int b = -1;
+	NS_ABORT_MSG_IF (sscanf (data.BackupLink.c_str (), "%d-%d", &a, &b) != 2, "Bad backup link " << data.BackupLink);
+	NS_ABORT_MSG_IF (a < 0 || b < 0, "Bad backup link " << data.BackupLink);
+	NodeContainer nanb = CreateContainer (nodes, a, b, data);
+
+	NetDeviceContainer dadb = CreateChannel (nanb, "5Mbps", "2ms");
+	Ipv4InterfaceContainer iaib = AssignIP (dadb, NetworkAddress, SubnetMask);
+	for (uint32_t i = 0; i < iaib.GetN (); ++i)
+	{
+		std::pair<Ptr<Ipv4>, uint32_t> end = iaib.Get (i);
+		end.first->SetMetric (end.second, data.BackupMetric);
+	}
+	return iaib;
+}
+
+
+ApplicationContainer
 OnOffApp (Data data, NodeContainer nodes, int numSource, int numSink, Ipv4InterfaceContainer iaib, double appStart, double appStop)
 {
 	static bool firstCall = true;
@@ -172,13 +339,188 @@ OnOffApp (Data data, NodeContainer nodes, int numSource, int numSink, Ipv4Interf
 	onoff.SetConstantRate (DataRate (data.dataRate));
 	ApplicationContainer apps = onoff.Install (nodes.Get(numSource));
 	apps.Start (Seconds(appStart));						
-	apps.Start (Seconds(appStop));						
+	apps.Stop (Seconds(appStop));						
 	
 	PacketSinkHelper sink ("ns3::UdpSocketFactory", 
 							Address (InetSocketAddress (Ipv4Address::GetAny(), port)));
-	apps = sink.Install (nodes.Get(numSink));
-	apps.Start (Seconds(appStart));						
-	apps.Start (Seconds(appStop));						
+	ApplicationContainer sinkApps = sink.Install (nodes.Get(numSink));
+	sinkApps.Start (Seconds(appStart));						
+	sinkApps.Stop (Seconds(appStop));						
+
+	// Source then sink
+	apps.Add (sinkApps);
+	return apps;
+}
+
+
+ApplicationContainer
+TcpApp (Data data, NodeContainer nodes, int numSource, int numSink, Ipv4InterfaceContainer iaib, double appStart, double appStop)
+{
+	uint16_t port = 50000;
+	BulkSendHelper bulk ("ns3::TcpSocketFactory",
+						Address (InetSocketAddress (iaib.GetAddress(0), port)));
+	bulk.SetAttribute ("MaxBytes", UintegerValue (0));
+	ApplicationContainer apps = bulk.Install (nodes.Get(numSource));
+	apps.Start (Seconds(appStart));
+	apps.Stop (Seconds(appStop));
+
+	// The sink outlives the sender so the tail of the transfer is counted
+	PacketSinkHelper sink ("ns3::TcpSocketFactory",
+							Address (InetSocketAddress (Ipv4Address::GetAny(), port)));
+	ApplicationContainer sinkApps = sink.Install (nodes.Get(numSink));
+	sinkApps.Start (Seconds(appStart));
+
+	// Source then sink
+	apps.Add (sinkApps);
+	return apps;
+}
+
+
+// Schedules data.Failures on the named links; null when there are none
+Ptr<LinkFailureSchedule>
+Failures (Data data, const std::map<std::string, Ipv4InterfaceContainer> &links, Ptr<OutageMonitor> outages)
+{
+	std::vector<FailureSpec> specs = LinkFailureSchedule::ParseSpec (data.Failures);
+	if (specs.empty ())
+	{
+		return 0;
+	}
+
+	Ptr<LinkFailureSchedule> failures = Create<LinkFailureSchedule> (true, Seconds (data.DetectDelay));
+	failures->SetOutageMonitor (outages);
+	for (const FailureSpec &f : specs)
+	{
+		std::map<std::string, Ipv4InterfaceContainer>::const_iterator it = links.find (f.target);
+		if (it == links.end ())
+		{
+			// Either end first
+			size_t dash = f.target.find ('-');
+			if (dash != std::string::npos)
+			{
+				it = links.find (f.target.substr (dash + 1) + "-" + f.target.substr (0, dash));
+			}
+		}
+		NS_ABORT_MSG_IF (it == links.end (), "No link " << f.target);
+
+		NetDeviceContainer dadb;
+		for (uint32_t i = 0; i < it->second.GetN (); ++i)
+		{
+			std::pair<Ptr<Ipv4>, uint32_t> end = it->second.Get (i);
+			dadb.Add (end.first->GetNetDevice (end.second));
+		}
+		failures->Add (it->first, dadb, Seconds (f.down), Seconds (f.up));
+	}
+	return failures;
+}
+
+
+// Installed once the whole topology exists, not per link
+void
+Tracing (Data data)
+{
+	if (data.EnableTracing)
+	{
+		ColumnarTraceHelper trace ("trace/global-routing/simple-global-routing.ctr");
+		trace.InstallAll ();
+	}
+	if (data.EnablePcap)
+	{
+		PointToPointHelper p2p;
+		p2p.EnablePcapAll ("trace/global-routing/simple-global-routing");
+	}
+}
+
+
+// Flow statistics just before the TCP load starts, the idle baseline
+void
+SnapshotFlows (Ptr<FlowMonitor> monitor, FlowMonitor::FlowStatsContainer *idle)
+{
+	monitor->CheckForLostPackets ();
+	*idle = monitor->GetFlowStats ();
+}
+
+
+// Upper edge of the bin holding the q quantile of total minus idle, in ms
+static double
+LoadedDelayQuantile (Histogram total, Histogram idle, double q)
+{
+	std::vector<uint32_t> counts (total.GetNBins ());
+	uint64_t sum = 0;
+	for (uint32_t i = 0; i < counts.size (); ++i)
+	{
+		counts[i] = total.GetBinCount (i) - (i < idle.GetNBins () ? idle.GetBinCount (i) : 0);
+		sum += counts[i];
+	}
+	uint64_t seen = 0;
+	for (uint32_t i = 0; i < counts.size (); ++i)
+	{
+		seen += counts[i];
+		if (sum > 0 && seen >= q * sum)
+		{
+			return (total.GetBinEnd (i) * 1e3);
+		}
+	}
+	return (0);
+}
+
+
+void
+LatencyUnderLoad (Data data, Ptr<FlowMonitor> monitor, Ptr<Ipv4FlowClassifier> classifier,
+                  const FlowMonitor::FlowStatsContainer &idle)
+{
+	monitor->CheckForLostPackets ();
+	const FlowMonitor::FlowStatsContainer &stats = monitor->GetFlowStats ();
+
+	std::cout << "Latency under load: idle before " << data.TcpStart << " s, loaded after (ms)" << std::endl;
+	std::cout << std::setw (5) << "flow" << std::setw (6) << "proto" << "  " << std::left << std::setw (34) << "source -> destination"
+	          << std::right << std::setw (10) << "idle" << std::setw (10) << "loaded" << std::setw (10) << "p99"
+	          << std::setw (10) << "added" << std::setw (9) << "loss %" << std::setw (12) << "kbit/s" << std::endl;
+	for (FlowMonitor::FlowStatsContainer::const_iterator it = stats.begin (); it != stats.end (); ++it)
+	{
+		Ipv4FlowClassifier::FiveTuple t = classifier->FindFlow (it->first);
+		const FlowMonitor::FlowStats &s = it->second;
+		FlowMonitor::FlowStatsContainer::const_iterator base = idle.find (it->first);
+
+		uint32_t idleRx = 0;
+		Time idleDelay;
+		Histogram idleHistogram;
+		if (base != idle.end ())
+		{
+			idleRx = base->second.rxPackets;
+			idleDelay = base->second.delaySum;
+			idleHistogram = base->second.delayHistogram;
+		}
+		uint32_t loadedRx = s.rxPackets - idleRx;
+		double idleMs = idleRx ? idleDelay.GetSeconds () * 1e3 / idleRx : 0;
+		double loadedMs = loadedRx ? (s.delaySum - idleDelay).GetSeconds () * 1e3 / loadedRx : 0;
+		double seconds = (s.timeLastRxPacket - s.timeFirstRxPacket).GetSeconds ();
+
+		std::ostringstream endpoints;
+		endpoints << t.sourceAddress << ":" << t.sourcePort << " -> " << t.destinationAddress << ":" << t.destinationPort;
+		std::cout << std::setw (5) << it->first << std::setw (6) << (t.protocol == 6 ? "TCP" : t.protocol == 17 ? "UDP" : "?")
+		          << "  " << std::left << std::setw (34) << endpoints.str () << std::right << std::fixed << std::setprecision (2);
+		if (idleRx)
+		{
+			std::cout << std::setw (10) << idleMs;
+		}
+		else
+		{
+			std::cout << std::setw (10) << "-";
+		}
+		std::cout << std::setw (10) << loadedMs
+		          << std::setw (10) << LoadedDelayQuantile (s.delayHistogram, idleHistogram, 0.99);
+		if (idleRx && loadedRx)
+		{
+			std::cout << std::setw (10) << loadedMs - idleMs;
+		}
+		else
+		{
+			std::cout << std::setw (10) << "-";
+		}
+		std::cout << std::setw (9) << (s.txPackets ? 100.0 * s.lostPackets / s.txPackets : 0.0)
+		          << std::setw (12) << (seconds > 0 ? s.rxBytes * 8 / seconds / 1e3 : 0.0) << std::endl;
+		std::cout.unsetf (std::ios::floatfield);
+	}
 }
 
 
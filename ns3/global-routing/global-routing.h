@@ -3,19 +3,38 @@
 #include "ns3/internet-module.h"
 #include "ns3/point-to-point-module.h"
 #include "ns3/applications-module.h"
+#include "ns3/traffic-control-module.h"
 #include "ns3/flow-monitor-helper.h"
+#include "ns3/ipv4-flow-classifier.h"
 #include "ns3/ipv4-global-routing-helper.h"
 #include "UserData.h"
+#include "../columnar-trace-helper.h"
+#include "../flow-stats-streamer.h"
+#include "../queue-monitor.h"
+#include "../link-failure.h"
 
 
 using namespace ns3;
 
 
-NodeContainer Init               (Data data, int argc, char *argv[]);
+NodeContainer Init               (Data &data, int argc, char *argv[]);
 NodeContainer CreateContainer    (NodeContainer nodes, int a, int b, Data data);
-NetDeviceContainer CreateChannel (NodeContainer nanb, std::string dataRate, std::string delay);
+NetDeviceContainer CreateChannel (NodeContainer nanb, std::string dataRate, std::string delay,
+                                 std::string queueSize = "100p");
+QueueDiscContainer InstallQueueDisc (Data data, NetDeviceContainer dadb);
 Ipv4InterfaceContainer AssignIP  (NetDeviceContainer dadb, Ipv4Address NetworkAddress, Ipv4Mask SubnetMask);
 Ipv4InterfaceContainer Internet  (NodeContainer nodes, NodeContainer nanb, 
                                  Ipv4Address NetworkAddress, Ipv4Mask SubnetMask);
-void OnOffApp                    (Data data, NodeContainer nodes, int numSource, int numSink, 
+Ipv4InterfaceContainer Bottleneck (Data data, NodeContainer nanb, Ipv4Address NetworkAddress, 
+                                 Ipv4Mask SubnetMask, QueueDiscContainer &discs);
+Ipv4InterfaceContainer Backup    (Data data, NodeContainer nodes, Ipv4Address NetworkAddress, Ipv4Mask SubnetMask);
+ApplicationContainer OnOffApp    (Data data, NodeContainer nodes, int numSource, int numSink, 
                                  Ipv4InterfaceContainer iaib, double appStart, double appStop);
+ApplicationContainer TcpApp      (Data data, NodeContainer nodes, int numSource, int numSink, 
+                                 Ipv4InterfaceContainer iaib, double appStart, double appStop);
+Ptr<LinkFailureSchedule> Failures (Data data, const std::map<std::string, Ipv4InterfaceContainer> &links,
+                                 Ptr<OutageMonitor> outages);
+void Tracing                     (Data data);
+void SnapshotFlows               (Ptr<FlowMonitor> monitor, FlowMonitor::FlowStatsContainer *idle);
+void LatencyUnderLoad            (Data data, Ptr<FlowMonitor> monitor, Ptr<Ipv4FlowClassifier> classifier, 
+                                 const FlowMonitor::FlowStatsContainer &idle);
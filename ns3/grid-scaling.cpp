@@ -0,0 +1,152 @@
+/*
+Created on Tue Oct 20 00:41:27 2026
+@author: Harshil Bhatt
+*/
+
+
+/*  Strong-scaling benchmark of the distributed p2p-grid.
+
+    Runs the same grid (p2p-grid --distributed, see p2p-grid/grid-benchmark.cc)
+    under mpirun with 1, 2, 4 and 8 ranks (or the -n list), one run after
+    the other so they never compete for cores, and reads the "name: value"
+    lines rank 0 prints. The fastest of -r repeats counts. Prints per rank
+    count
+
+        ranks  remote links  run s  speedup  efficiency  build s  route s  peak MB  received
+
+    with speedup and efficiency against the first count of the list. The
+    received packets have to match across counts: partitioning may change
+    how fast the grid runs, never what happens in it, so a mismatch is
+    flagged.
+
+    Build and run from inside "./waf shell", like sweep-runner.cpp:
+        ./waf configure --enable-mpi && ./waf build && ./waf shell
+        g++ -O2 -std=c++17 -o grid-scaling scratch/grid-scaling.cpp
+        ./grid-scaling -x "build/scratch/p2p-grid/p2p-grid --sizes=100 --packets=200" -r 3
+        ./grid-scaling -x "build/scratch/p2p-grid/p2p-grid --sizes=316 --nullmsg" \
+            -m "mpirun --oversubscribe -np" -n 1,2,4,8,16
+*/
+
+#include <bits/stdc++.h>
+
+using namespace std;
+
+
+struct Result {
+    bool ok = false;
+    map<string, double> metrics;
+};
+
+
+static Result runOnce(const string &launcher, unsigned ranks, const string &program) {
+    string command = launcher + " " + to_string(ranks) + " " + program + " --distributed 2>&1";
+    Result result;
+    FILE *out = popen(command.c_str(), "r");
+    if (!out)
+        return result;
+    char line[4096];
+    while (fgets(line, sizeof(line), out)) {
+        char *colon = strchr(line, ':');
+        if (!colon)
+            continue;
+        char *end;
+        double value = strtod(colon + 1, &end);
+        if (end == colon + 1)
+            continue;
+        result.metrics[string(line, colon)] = value;
+    }
+    result.ok = pclose(out) == 0 && result.metrics.count("Run seconds");
+    return result;
+}
+
+
+int main(int argc, char *argv[]) {
+    string program;
+    string launcher = "mpirun -np";
+    string rankList = "1,2,4,8";
+    int repeats = 1;
+    const char *output = NULL;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "x:m:n:r:o:")) != -1) {
+        switch (opt) {
+            case 'x': program = optarg; break;
+            case 'm': launcher = optarg; break;
+            case 'n': rankList = optarg; break;
+            case 'r': repeats = max(1, atoi(optarg)); break;
+            case 'o': output = optarg; break;
+            default: break;
+        }
+    }
+    if (program.empty()) {
+        fprintf(stderr, "Script Usage: %s -x <p2p-grid binary [fixed args]> [-m launcher, ranks appended] "
+                        "[-n 1,2,4,8] [-r repeats] [-o results.tsv]\n", argv[0]);
+        return 1;
+    }
+
+    vector<unsigned> counts;
+    stringstream list(rankList);
+    string item;
+    while (getline(list, item, ','))
+        if (atoi(item.c_str()) > 0)
+            counts.push_back(atoi(item.c_str()));
+    if (counts.empty()) {
+        fprintf(stderr, "No rank counts in '%s'\n", rankList.c_str());
+        return 1;
+    }
+
+    FILE *tsv = output ? fopen(output, "w") : NULL;
+    if (output && !tsv) {
+        fprintf(stderr, "Cannot write %s\n", output);
+        return 1;
+    }
+    if (tsv)
+        fprintf(tsv, "ranks\tremote_links\trun_s\tspeedup\tefficiency\tbuild_s\troute_s\tpeak_mb\treceived\n");
+
+    printf("%6s %13s %10s %8s %11s %9s %9s %9s %10s\n", "ranks", "remote links", "run s", "speedup",
+           "efficiency", "build s", "route s", "peak MB", "received");
+    double baseSecs = 0;
+    unsigned baseRanks = 0;
+    double baseReceived = -1;
+    int failed = 0;
+    for (unsigned ranks : counts) {
+        Result best;
+        for (int i = 0; i < repeats; ++i) {
+            Result r = runOnce(launcher, ranks, program);
+            if (r.ok && (!best.ok || r.metrics["Run seconds"] < best.metrics["Run seconds"]))
+                best = r;
+        }
+        if (!best.ok) {
+            printf("%6u   failed, run \"%s %u %s --distributed\" by hand to see why\n", ranks,
+                   launcher.c_str(), ranks, program.c_str());
+            ++failed;
+            continue;
+        }
+
+        map<string, double> &m = best.metrics;
+        if (baseRanks == 0) {
+            baseSecs = m["Run seconds"];
+            baseRanks = ranks;
+            baseReceived = m["Packets received"];
+        }
+        // Speedup against the first count, scaled so perfect scaling from
+        // e.g. 2 ranks still reads as efficiency 1
+        double speedup = baseSecs / m["Run seconds"] * baseRanks;
+        double efficiency = speedup / ranks;
+        bool same = m["Packets received"] == baseReceived;
+        printf("%6u %13.0f %10.3f %8.2f %11.2f %9.3f %9.3f %9.1f %10.0f%s\n", ranks, m["Remote links"],
+               m["Run seconds"], speedup, efficiency, m["Build seconds"], m["Routing seconds"], m["Peak MB"],
+               m["Packets received"], same ? "" : "  differs!");
+        if (tsv)
+            fprintf(tsv, "%u\t%.0f\t%.3f\t%.3f\t%.3f\t%.3f\t%.3f\t%.1f\t%.0f\n", ranks, m["Remote links"],
+                    m["Run seconds"], speedup, efficiency, m["Build seconds"], m["Routing seconds"],
+                    m["Peak MB"], m["Packets received"]);
+        if (!same)
+            ++failed;
+        fflush(stdout);
+    }
+
+    if (tsv)
+        fclose(tsv);
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,367 @@
+/**
+ * @author Harshil Bhatt
+ * @create date 2026-10-19 23:52:47
+ * @desc
+ *      Poptrie longest prefix match for Ipv4 (Asai and Ohara, SIGCOMM
+ *      2015). Kept free of ns-3 headers so trie-lookup-bench.cpp builds on
+ *      its own; Ipv4TrieRouting (ipv4-trie-routing.h) sits on top of it.
+ *
+ *      Prefixes are inserted into a plain binary trie; Build () compiles
+ *      that into the lookup structure:
+ *          - a direct-pointing array indexed by the top 16 address bits
+ *            (8 for tables under SMALL_TABLE prefixes), each entry either
+ *            a leaf value or an internal node
+ *          - internal nodes of 6-bit stride, each 64-bit "vector" marks the
+ *            children that are internal nodes and "leafvec" marks where a
+ *            run of equal leaves starts; a node's children and leaves are
+ *            contiguous, so popcount of the bits up to a slot gives its
+ *            offset from base1 / base0
+ *      A lookup is one direct array read plus at most 3 node steps (16 +
+ *      3 * 6 covers 32 bits; 4 for a small table), all in small arrays
+ *      that stay in cache. The 256 KB direct array of a full table would
+ *      dwarf the few routes of a simulated host, so those get 1 KB.
+ *
+ *      Values are opaque 31-bit numbers, 0 meaning no route; the caller
+ *      keeps whatever they stand for (a set of next hops, say). Insert and
+ *      Remove only touch the binary trie and need a Build () before the
+ *      next Lookup, which makes this a structure for tables that are
+ *      mostly read: batch the changes, then rebuild once.
+ *
+ *      LookupReference walks the binary trie bit by bit, for checking.
+ */
+
+#ifndef IPV4_POPTRIE_H
+#define IPV4_POPTRIE_H
+
+#include <stdint.h>
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+
+class Ipv4Poptrie
+{
+public:
+    static const uint32_t NO_ROUTE = 0;
+    static const uint32_t MAX_VALUE = 0x7fffffff;
+
+    Ipv4Poptrie ()
+    {
+        Clear ();
+    }
+
+    void Clear (void)
+    {
+        m_binary.assign (1, BinaryNode ());
+        m_prefixes = 0;
+        m_directBits = MIN_DIRECT_BITS;
+        m_direct.assign (1u << m_directBits, LEAF | NO_ROUTE);
+        m_nodes.clear ();
+        m_leaves.clear ();
+        m_built = true;
+    }
+
+    /**
+     * Add or replace the value of prefix/length; bits of prefix past
+     * length are ignored
+     *
+     * \param value 1 .. MAX_VALUE
+     */
+    void Insert (uint32_t prefix, uint32_t length, uint32_t value)
+    {
+        int32_t node = 0;
+        for (uint32_t depth = 0; depth < length; ++depth)
+        {
+            uint32_t bit = (prefix >> (31 - depth)) & 1;
+            if (m_binary[node].child[bit] < 0)
+            {
+                m_binary[node].child[bit] = m_binary.size ();
+                m_binary.push_back (BinaryNode ());
+            }
+            node = m_binary[node].child[bit];
+        }
+        if (m_binary[node].value == NO_ROUTE)
+        {
+            ++m_prefixes;
+        }
+        m_binary[node].value = value & MAX_VALUE;
+        m_built = false;
+    }
+
+    /**
+     * \returns false if prefix/length was not there
+     */
+    bool Remove (uint32_t prefix, uint32_t length)
+    {
+        int32_t node = 0;
+        for (uint32_t depth = 0; depth < length && node >= 0; ++depth)
+        {
+            node = m_binary[node].child[(prefix >> (31 - depth)) & 1];
+        }
+        if (node < 0 || m_binary[node].value == NO_ROUTE)
+        {
+            return false;
+        }
+        // Empty branches are skipped by Build, no need to unlink them
+        m_binary[node].value = NO_ROUTE;
+        --m_prefixes;
+        m_built = false;
+        return true;
+    }
+
+    /**
+     * Compile the binary trie into the lookup arrays
+     */
+    void Build (void)
+    {
+        m_live.assign (m_binary.size (), false);
+        MarkLive (0);
+        m_nodes.clear ();
+        m_leaves.clear ();
+        m_directBits = m_prefixes < SMALL_TABLE ? MIN_DIRECT_BITS : MAX_DIRECT_BITS;
+        std::vector<uint32_t> (1u << m_directBits, LEAF | NO_ROUTE).swap (m_direct);
+        Direct (0, 0, 0, NO_ROUTE);
+        std::vector<bool> ().swap (m_live);
+        m_built = true;
+    }
+
+    bool IsBuilt (void) const
+    {
+        return m_built;
+    }
+
+    /**
+     * \returns value of the longest prefix holding address, NO_ROUTE if
+     *          none; only valid after Build
+     */
+    uint32_t Lookup (uint32_t address) const
+    {
+        uint32_t entry = m_direct[address >> (32 - m_directBits)];
+        if (entry & LEAF)
+        {
+            return entry & MAX_VALUE;
+        }
+        const Node *node = &m_nodes[entry];
+        uint32_t offset = m_directBits;
+        uint32_t v = Chunk (address, offset);
+        while (node->vector & (1ull << v))
+        {
+            node = &m_nodes[node->base1 + Popcount (node->vector & ((2ull << v) - 1)) - 1];
+            offset += STRIDE;
+            v = Chunk (address, offset);
+        }
+        return m_leaves[node->base0 + Popcount (node->leafvec & ((2ull << v) - 1)) - 1];
+    }
+
+    /**
+     * \returns same as Lookup, by walking the binary trie
+     */
+    uint32_t LookupReference (uint32_t address) const
+    {
+        uint32_t best = m_binary[0].value;
+        int32_t node = 0;
+        for (uint32_t depth = 0; depth < 32; ++depth)
+        {
+            node = m_binary[node].child[(address >> (31 - depth)) & 1];
+            if (node < 0)
+            {
+                break;
+            }
+            if (m_binary[node].value != NO_ROUTE)
+            {
+                best = m_binary[node].value;
+            }
+        }
+        return best;
+    }
+
+    size_t GetPrefixCount (void) const
+    {
+        return m_prefixes;
+    }
+
+    size_t GetNodeCount (void) const
+    {
+        return m_nodes.size ();
+    }
+
+    size_t GetLeafCount (void) const
+    {
+        return m_leaves.size ();
+    }
+
+    /**
+     * \returns bytes of the lookup arrays, not counting the binary trie
+     */
+    size_t GetMemory (void) const
+    {
+        return m_direct.size () * sizeof (uint32_t) + m_nodes.size () * sizeof (Node)
+               + m_leaves.size () * sizeof (uint32_t);
+    }
+
+private:
+    static const uint32_t MIN_DIRECT_BITS = 8;
+    static const uint32_t MAX_DIRECT_BITS = 16;
+    static const size_t SMALL_TABLE = 4096;     // prefixes, below it MIN_DIRECT_BITS
+    static const uint32_t STRIDE = 6;
+    static const uint32_t LEAF = 0x80000000;
+
+    struct BinaryNode
+    {
+        BinaryNode ()
+            : value (NO_ROUTE)
+        {
+            child[0] = -1;
+            child[1] = -1;
+        }
+        int32_t child[2];
+        uint32_t value;
+    };
+
+    struct Node
+    {
+        uint64_t vector;        // bit v: slot v is an internal node
+        uint64_t leafvec;       // bit v: slot v starts a run of equal leaves
+        uint32_t base0;         // first leaf in m_leaves
+        uint32_t base1;         // first child in m_nodes
+    };
+
+    static uint32_t Popcount (uint64_t x)
+    {
+        return __builtin_popcountll (x);
+    }
+
+    /**
+     * \returns the 6 address bits from offset, zero padded past bit 31
+     */
+    static uint32_t Chunk (uint32_t address, uint32_t offset)
+    {
+        return offset + STRIDE <= 32 ? (address >> (32 - STRIDE - offset)) & 63
+                                     : (address << (offset + STRIDE - 32)) & 63;
+    }
+
+    // m_live[i]: node i or something below it holds a prefix
+    bool MarkLive (int32_t node)
+    {
+        bool live = m_binary[node].value != NO_ROUTE;
+        for (int i = 0; i < 2; ++i)
+        {
+            if (m_binary[node].child[i] >= 0 && MarkLive (m_binary[node].child[i]))
+            {
+                live = true;
+            }
+        }
+        m_live[node] = live;
+        return live;
+    }
+
+    bool HasLiveChild (int32_t node) const
+    {
+        const BinaryNode &b = m_binary[node];
+        return (b.child[0] >= 0 && m_live[b.child[0]]) || (b.child[1] >= 0 && m_live[b.child[1]]);
+    }
+
+    /**
+     * Fill the direct array entries under index, the top depth bits
+     */
+    void Direct (int32_t node, uint32_t depth, uint32_t index, uint32_t inherited)
+    {
+        if (node >= 0 && m_binary[node].value != NO_ROUTE)
+        {
+            inherited = m_binary[node].value;
+        }
+        if (node < 0 || !HasLiveChild (node))
+        {
+            uint32_t first = index << (m_directBits - depth);
+            std::fill (m_direct.begin () + first, m_direct.begin () + first + (1u << (m_directBits - depth)),
+                       LEAF | inherited);
+            return;
+        }
+        if (depth == m_directBits)
+        {
+            uint32_t self = m_nodes.size ();
+            m_nodes.push_back (Node ());
+            m_direct[index] = self;
+            Compile (self, node, inherited);
+            return;
+        }
+        Direct (m_binary[node].child[0], depth + 1, index << 1, inherited);
+        Direct (m_binary[node].child[1], depth + 1, (index << 1) | 1, inherited);
+    }
+
+    /**
+     * Fill m_nodes[self] from the binary subtree at node, whose longest
+     * prefix on the way down is inherited
+     */
+    void Compile (uint32_t self, int32_t node, uint32_t inherited)
+    {
+        int32_t children[64];
+        uint32_t values[64];
+        uint64_t vector = 0;
+        for (uint32_t v = 0; v < 64; ++v)
+        {
+            int32_t b = node;
+            uint32_t value = inherited;
+            for (int bit = STRIDE - 1; bit >= 0 && b >= 0; --bit)
+            {
+                b = m_binary[b].child[(v >> bit) & 1];
+                if (b >= 0 && m_binary[b].value != NO_ROUTE)
+                {
+                    value = m_binary[b].value;
+                }
+            }
+            children[v] = b;
+            values[v] = value;
+            if (b >= 0 && HasLiveChild (b))
+            {
+                vector |= 1ull << v;
+            }
+        }
+
+        // Leaves in slot order, a new one only where the value changes
+        uint64_t leafvec = 0;
+        uint32_t base0 = m_leaves.size ();
+        for (uint32_t v = 0; v < 64; ++v)
+        {
+            if (vector & (1ull << v))
+            {
+                continue;
+            }
+            if (m_leaves.size () == base0 || m_leaves.back () != values[v])
+            {
+                leafvec |= 1ull << v;
+                m_leaves.push_back (values[v]);
+            }
+        }
+
+        // Children take a contiguous block, filled in afterwards
+        uint32_t base1 = m_nodes.size ();
+        m_nodes.resize (base1 + Popcount (vector));
+        m_nodes[self].vector = vector;
+        m_nodes[self].leafvec = leafvec;
+        m_nodes[self].base0 = base0;
+        m_nodes[self].base1 = base1;
+
+        uint32_t k = 0;
+        for (uint32_t v = 0; v < 64; ++v)
+        {
+            if (vector & (1ull << v))
+            {
+                Compile (base1 + k++, children[v], values[v]);
+            }
+        }
+    }
+
+    std::vector<BinaryNode> m_binary;
+    std::vector<bool> m_live;           // only during Build
+    size_t m_prefixes;
+    bool m_built;
+
+    uint32_t m_directBits;              // address bits the direct array covers
+    std::vector<uint32_t> m_direct;     // LEAF | value, or index into m_nodes
+    std::vector<Node> m_nodes;
+    std::vector<uint32_t> m_leaves;
+};
+
+
+#endif /* IPV4_POPTRIE_H */
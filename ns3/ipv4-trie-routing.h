@@ -0,0 +1,451 @@
+/**
+ * @author Harshil Bhatt
+ * @create date 2026-10-19 23:59:31
+ * @desc
+ *      Static Ipv4 routing with a Poptrie longest prefix match.
+ *
+ *      Ipv4StaticRouting scans every network route for each packet, which
+ *      is what dominates a run once a router holds tens of thousands of
+ *      prefixes. Ipv4TrieRouting takes the same kind of routes (host,
+ *      network, default; gateway, interface, metric) and answers lookups
+ *      from an Ipv4Poptrie (ipv4-poptrie.h), a handful of memory reads
+ *      whatever the table size.
+ *
+ *      Each prefix maps to the routes of lowest metric among the ones
+ *      added for it and whose interface is up; several of them are equal
+ *      cost and one is picked per (source, destination) pair, so a flow
+ *      keeps its path. The trie is rebuilt at the first lookup after any
+ *      change, so add a large table in one go before the simulation
+ *      starts rather than route by route while it runs. Like
+ *      Ipv4StaticRouting it adds a network route for each interface
+ *      address, so directly connected networks need nothing.
+ *
+ *      A socket bound to a device (RouteOutput with an oif) is answered
+ *      by scanning the routes of that interface, that is the rare path.
+ *      No multicast; put it in an Ipv4ListRoutingHelper next to
+ *      Ipv4StaticRouting if some is needed:
+ *
+ *          Ipv4StaticRoutingHelper staticRouting;
+ *          Ipv4TrieRoutingHelper trieRouting;
+ *          Ipv4ListRoutingHelper list;
+ *          list.Add (staticRouting, 0);
+ *          list.Add (trieRouting, 10);
+ *          internet.SetRoutingHelper (list);
+ *          ...
+ *          Ipv4TrieRoutingHelper::GetTrieRouting (node->GetObject<Ipv4> ())
+ *              ->AddNetworkRouteTo ("192.168.0.0", "255.255.0.0", "10.1.1.2", 1);
+ */
+
+#ifndef IPV4_TRIE_ROUTING_H
+#define IPV4_TRIE_ROUTING_H
+
+#include <stdint.h>
+#include <iomanip>
+#include <map>
+#include <ostream>
+#include <sstream>
+#include <vector>
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/ipv4-list-routing.h"
+
+#include "ipv4-poptrie.h"
+
+
+namespace ns3 {
+
+class Ipv4TrieRouting : public Ipv4RoutingProtocol
+{
+public:
+    static TypeId GetTypeId (void)
+    {
+        static TypeId tid = TypeId ("ns3::Ipv4TrieRouting")
+            .SetParent<Ipv4RoutingProtocol> ()
+            .AddConstructor<Ipv4TrieRouting> ();
+        return tid;
+    }
+
+    Ipv4TrieRouting ()
+        : m_dirty (false),
+          m_builds (0),
+          m_lookups (0)
+    {
+    }
+
+    void AddNetworkRouteTo (Ipv4Address network, Ipv4Mask mask, Ipv4Address nextHop,
+                            uint32_t interface, uint32_t metric = 0)
+    {
+        Route r = { network.CombineMask (mask), mask, nextHop, interface, metric };
+        m_routes.push_back (r);
+        m_dirty = true;
+    }
+
+    void AddNetworkRouteTo (Ipv4Address network, Ipv4Mask mask, uint32_t interface, uint32_t metric = 0)
+    {
+        AddNetworkRouteTo (network, mask, Ipv4Address::GetZero (), interface, metric);
+    }
+
+    void AddHostRouteTo (Ipv4Address dest, Ipv4Address nextHop, uint32_t interface, uint32_t metric = 0)
+    {
+        AddNetworkRouteTo (dest, Ipv4Mask::GetOnes (), nextHop, interface, metric);
+    }
+
+    void AddHostRouteTo (Ipv4Address dest, uint32_t interface, uint32_t metric = 0)
+    {
+        AddNetworkRouteTo (dest, Ipv4Mask::GetOnes (), interface, metric);
+    }
+
+    void SetDefaultRoute (Ipv4Address nextHop, uint32_t interface, uint32_t metric = 0)
+    {
+        AddNetworkRouteTo (Ipv4Address::GetZero (), Ipv4Mask::GetZero (), nextHop, interface, metric);
+    }
+
+    uint32_t GetNRoutes (void) const
+    {
+        return m_routes.size ();
+    }
+
+    /**
+     * Remove route i, counting in the order they were added
+     */
+    void RemoveRoute (uint32_t i)
+    {
+        NS_ABORT_MSG_IF (i >= m_routes.size (), "No route " << i);
+        m_routes.erase (m_routes.begin () + i);
+        m_dirty = true;
+    }
+
+    /**
+     * \returns times the trie was rebuilt, each change batch costs one
+     */
+    uint64_t GetBuilds (void) const
+    {
+        return m_builds;
+    }
+
+    uint64_t GetLookups (void) const
+    {
+        return m_lookups;
+    }
+
+    virtual Ptr<Ipv4Route> RouteOutput (Ptr<Packet> p, const Ipv4Header &header, Ptr<NetDevice> oif,
+                                        Socket::SocketErrno &sockerr)
+    {
+        Ipv4Address dest = header.GetDestination ();
+        if (dest.IsMulticast ())
+        {
+            sockerr = Socket::ERROR_NOROUTETOHOST;
+            return 0;
+        }
+        const Route *route = oif ? LookupOnInterface (dest, m_ipv4->GetInterfaceForDevice (oif))
+                                 : Lookup (header.GetSource (), dest);
+        if (route == 0)
+        {
+            sockerr = Socket::ERROR_NOROUTETOHOST;
+            return 0;
+        }
+        sockerr = Socket::ERROR_NOTERROR;
+        return MakeRoute (*route, dest);
+    }
+
+    virtual bool RouteInput (Ptr<const Packet> p, const Ipv4Header &header, Ptr<const NetDevice> idev,
+                             UnicastForwardCallback ucb, MulticastForwardCallback mcb,
+                             LocalDeliverCallback lcb, ErrorCallback ecb)
+    {
+        Ipv4Address dest = header.GetDestination ();
+        if (dest.IsMulticast ())
+        {
+            return false;
+        }
+        uint32_t iif = m_ipv4->GetInterfaceForDevice (idev);
+        if (m_ipv4->IsDestinationAddress (dest, iif))
+        {
+            if (!lcb.IsNull ())
+            {
+                lcb (p, header, iif);
+                return true;
+            }
+            return false;
+        }
+        if (!m_ipv4->IsForwarding (iif))
+        {
+            ecb (p, header, Socket::ERROR_NOROUTETOHOST);
+            return true;
+        }
+        const Route *route = Lookup (header.GetSource (), dest);
+        if (route == 0)
+        {
+            return false;
+        }
+        ucb (MakeRoute (*route, dest), p, header);
+        return true;
+    }
+
+    virtual void NotifyInterfaceUp (uint32_t interface)
+    {
+        for (uint32_t j = 0; j < m_ipv4->GetNAddresses (interface); ++j)
+        {
+            AddConnected (interface, m_ipv4->GetAddress (interface, j));
+        }
+        m_dirty = true;
+    }
+
+    virtual void NotifyInterfaceDown (uint32_t interface)
+    {
+        // Routes through it stay configured, Build skips them while it is down
+        m_dirty = true;
+    }
+
+    virtual void NotifyAddAddress (uint32_t interface, Ipv4InterfaceAddress address)
+    {
+        if (m_ipv4->IsUp (interface))
+        {
+            AddConnected (interface, address);
+        }
+    }
+
+    virtual void NotifyRemoveAddress (uint32_t interface, Ipv4InterfaceAddress address)
+    {
+        Ipv4Address network = address.GetLocal ().CombineMask (address.GetMask ());
+        for (std::vector<Route>::iterator it = m_routes.begin (); it != m_routes.end (); )
+        {
+            if (it->interface == interface && it->network == network && it->mask == address.GetMask ()
+                && it->gateway == Ipv4Address::GetZero ())
+            {
+                it = m_routes.erase (it);
+                m_dirty = true;
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+    virtual void SetIpv4 (Ptr<Ipv4> ipv4)
+    {
+        NS_ASSERT (m_ipv4 == 0 && ipv4 != 0);
+        m_ipv4 = ipv4;
+        for (uint32_t i = 0; i < m_ipv4->GetNInterfaces (); ++i)
+        {
+            if (m_ipv4->IsUp (i))
+            {
+                NotifyInterfaceUp (i);
+            }
+        }
+    }
+
+    virtual void PrintRoutingTable (Ptr<OutputStreamWrapper> stream, Time::Unit unit = Time::S) const
+    {
+        std::ostream *os = stream->GetStream ();
+        *os << "Node: " << m_ipv4->GetObject<Node> ()->GetId ()
+            << ", Time: " << Now ().As (unit)
+            << ", Ipv4TrieRouting table, " << m_routes.size () << " routes" << std::endl;
+        *os << std::left << std::setw (16) << "Destination" << std::setw (16) << "Gateway"
+            << std::setw (16) << "Genmask" << std::setw (7) << "Metric" << "Iface" << std::endl;
+        for (const Route &r : m_routes)
+        {
+            std::ostringstream dest, gw, mask;
+            dest << r.network;
+            gw << r.gateway;
+            mask << r.mask;
+            *os << std::setw (16) << dest.str () << std::setw (16) << gw.str () << std::setw (16) << mask.str ()
+                << std::setw (7) << r.metric << r.interface << std::endl;
+        }
+        *os << std::right << std::endl;
+    }
+
+protected:
+    virtual void DoDispose (void)
+    {
+        m_routes.clear ();
+        m_sets.clear ();
+        m_trie.Clear ();
+        m_ipv4 = 0;
+        Ipv4RoutingProtocol::DoDispose ();
+    }
+
+private:
+    struct Route
+    {
+        Ipv4Address network;
+        Ipv4Mask mask;
+        Ipv4Address gateway;        // zero when the network is on the link
+        uint32_t interface;
+        uint32_t metric;
+    };
+
+    void AddConnected (uint32_t interface, Ipv4InterfaceAddress address)
+    {
+        if (address.GetLocal () == Ipv4Address::GetLoopback ())
+        {
+            return;
+        }
+        Ipv4Address network = address.GetLocal ().CombineMask (address.GetMask ());
+        for (const Route &r : m_routes)
+        {
+            if (r.interface == interface && r.network == network && r.mask == address.GetMask ()
+                && r.gateway == Ipv4Address::GetZero ())
+            {
+                return;
+            }
+        }
+        AddNetworkRouteTo (network, address.GetMask (), interface);
+    }
+
+    /**
+     * Group the usable routes of lowest metric per prefix and compile the
+     * trie over the groups
+     */
+    void Build (void)
+    {
+        std::map<std::pair<uint32_t, uint32_t>, uint32_t> prefixes;    // (network, length) -> set
+        m_sets.clear ();
+        m_trie.Clear ();
+        for (uint32_t i = 0; i < m_routes.size (); ++i)
+        {
+            const Route &r = m_routes[i];
+            if (!m_ipv4->IsUp (r.interface))
+            {
+                continue;
+            }
+            std::pair<uint32_t, uint32_t> key (r.network.Get (), r.mask.GetPrefixLength ());
+            std::map<std::pair<uint32_t, uint32_t>, uint32_t>::iterator it = prefixes.find (key);
+            if (it == prefixes.end ())
+            {
+                prefixes[key] = m_sets.size ();
+                m_sets.push_back (std::vector<uint32_t> (1, i));
+                continue;
+            }
+            std::vector<uint32_t> &set = m_sets[it->second];
+            uint32_t best = m_routes[set[0]].metric;
+            if (r.metric < best)
+            {
+                set.assign (1, i);
+            }
+            else if (r.metric == best)
+            {
+                set.push_back (i);
+            }
+        }
+        for (const std::pair<const std::pair<uint32_t, uint32_t>, uint32_t> &p : prefixes)
+        {
+            m_trie.Insert (p.first.first, p.first.second, p.second + 1);
+        }
+        m_trie.Build ();
+        m_dirty = false;
+        ++m_builds;
+    }
+
+    const Route *Lookup (Ipv4Address source, Ipv4Address dest)
+    {
+        if (m_dirty)
+        {
+            Build ();
+        }
+        ++m_lookups;
+        uint32_t value = m_trie.Lookup (dest.Get ());
+        if (value == Ipv4Poptrie::NO_ROUTE)
+        {
+            return 0;
+        }
+        const std::vector<uint32_t> &set = m_sets[value - 1];
+        if (set.size () == 1)
+        {
+            return &m_routes[set[0]];
+        }
+        // Same pair, same route: keeps a flow's packets in order
+        uint32_t hash = (source.Get () * 2654435761u) ^ dest.Get ();
+        hash ^= hash >> 16;
+        return &m_routes[set[hash % set.size ()]];
+    }
+
+    /**
+     * \returns longest, then lowest metric, route to dest out of interface
+     */
+    const Route *LookupOnInterface (Ipv4Address dest, int32_t interface)
+    {
+        const Route *best = 0;
+        for (const Route &r : m_routes)
+        {
+            if (int32_t (r.interface) != interface || !r.mask.IsMatch (dest, r.network))
+            {
+                continue;
+            }
+            if (best == 0 || r.mask.GetPrefixLength () > best->mask.GetPrefixLength ()
+                || (r.mask == best->mask && r.metric < best->metric))
+            {
+                best = &r;
+            }
+        }
+        return best;
+    }
+
+    Ptr<Ipv4Route> MakeRoute (const Route &route, Ipv4Address dest) const
+    {
+        Ptr<Ipv4Route> rtentry = Create<Ipv4Route> ();
+        rtentry->SetDestination (dest);
+        rtentry->SetSource (m_ipv4->SourceAddressSelection (route.interface, dest));
+        rtentry->SetGateway (route.gateway);
+        rtentry->SetOutputDevice (m_ipv4->GetNetDevice (route.interface));
+        return rtentry;
+    }
+
+    Ptr<Ipv4> m_ipv4;
+    std::vector<Route> m_routes;
+    std::vector<std::vector<uint32_t> > m_sets;     // route indices of each trie value - 1
+    Ipv4Poptrie m_trie;
+    bool m_dirty;
+    uint64_t m_builds;
+    uint64_t m_lookups;
+};
+
+
+class Ipv4TrieRoutingHelper : public Ipv4RoutingHelper
+{
+public:
+    virtual Ipv4TrieRoutingHelper *Copy (void) const
+    {
+        return new Ipv4TrieRoutingHelper (*this);
+    }
+
+    virtual Ptr<Ipv4RoutingProtocol> Create (Ptr<Node> node) const
+    {
+        return CreateObject<Ipv4TrieRouting> ();
+    }
+
+    /**
+     * \returns the Ipv4TrieRouting of ipv4, on its own or inside an
+     *          Ipv4ListRouting; null if it has none
+     */
+    static Ptr<Ipv4TrieRouting> GetTrieRouting (Ptr<Ipv4> ipv4)
+    {
+        Ptr<Ipv4RoutingProtocol> protocol = ipv4->GetRoutingProtocol ();
+        Ptr<Ipv4TrieRouting> trie = DynamicCast<Ipv4TrieRouting> (protocol);
+        if (trie)
+        {
+            return trie;
+        }
+        Ptr<Ipv4ListRouting> list = DynamicCast<Ipv4ListRouting> (protocol);
+        if (list)
+        {
+            int16_t priority;
+            for (uint32_t i = 0; i < list->GetNRoutingProtocols (); ++i)
+            {
+                trie = DynamicCast<Ipv4TrieRouting> (list->GetRoutingProtocol (i, priority));
+                if (trie)
+                {
+                    return trie;
+                }
+            }
+        }
+        return 0;
+    }
+};
+
+} // namespace ns3
+
+
+#endif /* IPV4_TRIE_ROUTING_H */
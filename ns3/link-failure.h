@@ -0,0 +1,382 @@
+/**
+ * @author Harshil Bhatt
+ * @create date 2026-10-19 23:47:03
+ * @desc
+ *      Link failure injection and the disruption it causes.
+ *
+ *      LinkFailureSchedule takes the Ipv4 interfaces of a set of devices
+ *      (both ends of a point-to-point link, or one wifi NIC) down and back
+ *      up at given times. With global routing it then recomputes every
+ *      routing table after a detection delay and records how long
+ *      Ipv4GlobalRoutingHelper::RecomputeRoutingTables took in wall-clock
+ *      time. Protocols that repair themselves (OLSR) pass recompute =
+ *      false and only get the interface events.
+ *
+ *      OutageMonitor counts the bytes the sources sent and the sinks
+ *      received per flow, through their "Tx" and "Rx" traces
+ *      (OnOffApplication, BulkSendApplication, PacketSink, TrafficGenerator,
+ *      TrafficSink). Bytes, because for TCP BulkSend's "Tx" fires per
+ *      socket write and PacketSink's "Rx" per read, and the two never
+ *      match one to one; a TCP flow's "lost" is what was still queued or
+ *      in flight when the run ended.
+ *      A gap in a flow's receptions that spans a failure and is more than
+ *      twice the flow's usual gap is an outage; its time to recover runs
+ *      from the failure to the first packet after it. The resolution is
+ *      the flow's packet interval.
+ *
+ *          Ptr<OutageMonitor> outages = Create<OutageMonitor> ();
+ *          outages->Watch (sourceApps.Get (0), sinkApps.Get (0), "n0->n3");
+ *          Ptr<LinkFailureSchedule> failures = Create<LinkFailureSchedule> (true, MilliSeconds (50));
+ *          failures->SetOutageMonitor (outages);
+ *          failures->Add ("n2-n3", devices, Seconds (2), Seconds (4));
+ *          ...
+ *          failures->Report (std::cout);
+ *          outages->Report (std::cout);
+ *
+ *      ParseSpec reads the "<down>[-<up>]@<target>,..." lists the
+ *      scenarios take on the command line; what a target names is up to
+ *      the scenario.
+ */
+
+#ifndef LINK_FAILURE_H
+#define LINK_FAILURE_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+
+
+using namespace ns3;
+
+
+struct FailureSpec
+{
+    std::string target;
+    double down;            // seconds
+    double up;              // seconds, negative if it never comes back
+};
+
+
+class OutageMonitor : public SimpleRefCount<OutageMonitor>
+{
+public:
+    /**
+     * \returns index of the new flow, for Sent and Received
+     */
+    uint32_t AddFlow (const std::string &name)
+    {
+        Flow f;
+        f.name = name;
+        f.rx = 0;
+        f.txBytes = 0;
+        f.rxBytes = 0;
+        f.outages = 0;
+        m_flows.push_back (f);
+        return m_flows.size () - 1;
+    }
+
+    /**
+     * Count source's "Tx" and sink's "Rx" trace as one flow
+     */
+    uint32_t Watch (Ptr<Application> source, Ptr<Application> sink, const std::string &name)
+    {
+        uint32_t index = AddFlow (name);
+        source->TraceConnectWithoutContext ("Tx",
+            MakeBoundCallback (&OutageMonitor::TxTrace, Ptr<OutageMonitor> (this), index));
+        sink->TraceConnectWithoutContext ("Rx",
+            MakeBoundCallback (&OutageMonitor::RxTrace, Ptr<OutageMonitor> (this), index));
+        return index;
+    }
+
+    void NotifyFailure (void)
+    {
+        m_failures.push_back (Simulator::Now ());
+    }
+
+    void Sent (uint32_t index, uint32_t bytes)
+    {
+        m_flows[index].txBytes += bytes;
+        m_flows[index].lastTx = Simulator::Now ();
+    }
+
+    void Received (uint32_t index, uint32_t bytes)
+    {
+        Flow &f = m_flows[index];
+        Time now = Simulator::Now ();
+        if (f.rx > 0)
+        {
+            Time gap = now - f.lastRx;
+            f.longestGap = std::max (f.longestGap, gap);
+            double typical = f.rx > 1 ? (f.lastRx - f.firstRx).GetSeconds () / (f.rx - 1) : 0;
+            Time failure = FirstFailureAfter (f.lastRx);
+            if (!failure.IsNegative () && failure <= now && gap.GetSeconds () > 2 * typical)
+            {
+                Time recovery = now - failure;
+                ++f.outages;
+                f.totalRecovery += recovery;
+                f.maxRecovery = std::max (f.maxRecovery, recovery);
+            }
+        }
+        else
+        {
+            f.firstRx = now;
+        }
+        ++f.rx;
+        f.rxBytes += bytes;
+        f.lastRx = now;
+    }
+
+    void Report (std::ostream &os) const
+    {
+        os << std::left << std::setw (16) << "flow" << std::right
+           << std::setw (14) << "sent B" << std::setw (14) << "received B" << std::setw (12) << "lost B"
+           << std::setw (9) << "loss %" << std::setw (9) << "outages" << std::setw (14) << "recover ms"
+           << std::setw (14) << "max ms" << std::setw (14) << "longest gap" << std::endl;
+        for (const Flow &f : m_flows)
+        {
+            uint64_t lost = f.txBytes > f.rxBytes ? f.txBytes - f.rxBytes : 0;
+            os << std::left << std::setw (16) << f.name << std::right
+               << std::setw (14) << f.txBytes << std::setw (14) << f.rxBytes << std::setw (12) << lost
+               << std::fixed << std::setprecision (2)
+               << std::setw (9) << (f.txBytes ? 100.0 * lost / f.txBytes : 0.0)
+               << std::setw (9) << f.outages
+               << std::setw (14) << (f.outages ? f.totalRecovery.GetSeconds () * 1e3 / f.outages : 0.0)
+               << std::setw (14) << f.maxRecovery.GetSeconds () * 1e3
+               << std::setw (14) << f.longestGap.GetSeconds () * 1e3;
+            // still sending after a failure but nothing arrived since
+            Time failure = FirstFailureAfter (f.lastRx);
+            if (!failure.IsNegative () && f.lastTx > failure)
+            {
+                os << "  not recovered";
+            }
+            os << std::endl;
+            os.unsetf (std::ios::floatfield);
+        }
+    }
+
+private:
+    struct Flow
+    {
+        std::string name;
+        uint64_t rx;            // packets, for the usual gap
+        uint64_t txBytes;
+        uint64_t rxBytes;
+        Time lastTx;
+        Time firstRx;
+        Time lastRx;
+        Time longestGap;
+        uint32_t outages;
+        Time totalRecovery;
+        Time maxRecovery;
+    };
+
+    /**
+     * \returns first failure after t, negative if none
+     */
+    Time FirstFailureAfter (Time t) const
+    {
+        std::vector<Time>::const_iterator it = std::upper_bound (m_failures.begin (), m_failures.end (), t);
+        return it == m_failures.end () ? Seconds (-1) : *it;
+    }
+
+    static void TxTrace (Ptr<OutageMonitor> monitor, uint32_t index, Ptr<const Packet> packet)
+    {
+        monitor->Sent (index, packet->GetSize ());
+    }
+
+    static void RxTrace (Ptr<OutageMonitor> monitor, uint32_t index, Ptr<const Packet> packet, const Address &from)
+    {
+        monitor->Received (index, packet->GetSize ());
+    }
+
+    std::vector<Flow> m_flows;
+    std::vector<Time> m_failures;       // in the order they happened
+};
+
+
+class LinkFailureSchedule : public SimpleRefCount<LinkFailureSchedule>
+{
+public:
+    /**
+     * \param recompute recompute global routing after every change
+     *
+     * \param detectionDelay time from a change to the recomputation,
+     *                       how long the routers take to notice
+     */
+    LinkFailureSchedule (bool recompute = true, Time detectionDelay = Time (0))
+        : m_recompute (recompute),
+          m_detectionDelay (detectionDelay)
+    {
+    }
+
+    void SetOutageMonitor (Ptr<OutageMonitor> outages)
+    {
+        m_outages = outages;
+    }
+
+    /**
+     * Take the interfaces of devices down at down and up again at up;
+     * an up not after down keeps them down
+     */
+    void Add (const std::string &name, NetDeviceContainer devices, Time down, Time up)
+    {
+        // the events hold a reference, the schedule lives until they ran
+        Simulator::Schedule (down, &LinkFailureSchedule::Change, Ptr<LinkFailureSchedule> (this),
+                             name, devices, false);
+        if (up > down)
+        {
+            Simulator::Schedule (up, &LinkFailureSchedule::Change, Ptr<LinkFailureSchedule> (this),
+                                 name, devices, true);
+        }
+    }
+
+    /**
+     * Set the Ipv4 interfaces on devices up or down right now
+     */
+    static void SetState (NetDeviceContainer devices, bool up)
+    {
+        for (uint32_t i = 0; i < devices.GetN (); ++i)
+        {
+            Ptr<NetDevice> device = devices.Get (i);
+            Ptr<Ipv4> ipv4 = device->GetNode ()->GetObject<Ipv4> ();
+            int32_t interface = ipv4->GetInterfaceForDevice (device);
+            NS_ABORT_MSG_IF (interface < 0, "Device has no Ipv4 interface");
+            if (up)
+            {
+                ipv4->SetUp (interface);
+            }
+            else
+            {
+                ipv4->SetDown (interface);
+            }
+        }
+    }
+
+    /**
+     * \returns wall-clock seconds RecomputeRoutingTables took
+     */
+    static double Recompute (void)
+    {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+        Ipv4GlobalRoutingHelper::RecomputeRoutingTables ();
+        return std::chrono::duration<double> (std::chrono::steady_clock::now () - start).count ();
+    }
+
+    /**
+     * "<down>[-<up>]@<target>" entries separated by commas, in seconds,
+     * e.g. "2-4@2-3,6@0-2"
+     */
+    static std::vector<FailureSpec> ParseSpec (const std::string &spec)
+    {
+        std::vector<FailureSpec> specs;
+        std::stringstream list (spec);
+        std::string item;
+        while (std::getline (list, item, ','))
+        {
+            if (item.empty ())
+            {
+                continue;
+            }
+            size_t at = item.find ('@');
+            NS_ABORT_MSG_IF (at == std::string::npos || at == 0, "Bad failure \"" << item << "\", use <down>[-<up>]@<target>");
+            FailureSpec f;
+            f.target = item.substr (at + 1);
+            std::string times = item.substr (0, at);
+            size_t dash = times.find ('-');
+            if (!ParseSeconds (times.substr (0, dash), f.down)
+                || (dash != std::string::npos && !ParseSeconds (times.substr (dash + 1), f.up)))
+            {
+                NS_FATAL_ERROR ("Bad failure times \"" << item << "\", use <down>[-<up>]@<target>");
+            }
+            if (dash == std::string::npos)
+            {
+                f.up = -1;
+            }
+            specs.push_back (f);
+        }
+        return specs;
+    }
+
+    /**
+     * \returns false unless text is a whole non-negative number
+     */
+    static bool ParseSeconds (const std::string &text, double &seconds)
+    {
+        char *end;
+        seconds = std::strtod (text.c_str (), &end);
+        return !text.empty () && *end == '\0' && seconds >= 0;
+    }
+
+    void Report (std::ostream &os) const
+    {
+        double total = 0;
+        for (const Event &e : m_events)
+        {
+            os << std::fixed << std::setprecision (3) << std::setw (10) << e.at.GetSeconds () << " s  "
+               << std::left << std::setw (12) << e.name << std::right << std::setw (5) << (e.up ? "up" : "down");
+            if (e.recomputed)
+            {
+                os << "  routes recomputed at " << e.recomputedAt.GetSeconds () << " s in "
+                   << std::setprecision (3) << e.wallSeconds * 1e3 << " ms wall";
+                total += e.wallSeconds;
+            }
+            os << std::endl;
+            os.unsetf (std::ios::floatfield);
+        }
+        if (m_recompute)
+        {
+            os << "Route recomputation: " << total * 1e3 << " ms wall over " << m_events.size () << " changes" << std::endl;
+        }
+    }
+
+private:
+    struct Event
+    {
+        std::string name;
+        Time at;
+        bool up;
+        bool recomputed;
+        Time recomputedAt;
+        double wallSeconds;
+    };
+
+    void Change (std::string name, NetDeviceContainer devices, bool up)
+    {
+        SetState (devices, up);
+        Event e = { name, Simulator::Now (), up, false, Time (0), 0 };
+        m_events.push_back (e);
+        if (!up && m_outages)
+        {
+            m_outages->NotifyFailure ();
+        }
+        if (m_recompute)
+        {
+            Simulator::Schedule (m_detectionDelay, &LinkFailureSchedule::RecomputeFor, Ptr<LinkFailureSchedule> (this),
+                                 uint32_t (m_events.size () - 1));
+        }
+    }
+
+    void RecomputeFor (uint32_t index)
+    {
+        m_events[index].recomputed = true;
+        m_events[index].recomputedAt = Simulator::Now ();
+        m_events[index].wallSeconds = Recompute ();
+    }
+
+    bool m_recompute;
+    Time m_detectionDelay;
+    Ptr<OutageMonitor> m_outages;
+    std::vector<Event> m_events;
+};
+
+
+#endif /* LINK_FAILURE_H */
@@ -0,0 +1,532 @@
+/**
+ * @harshilbhatt2001 [Harshil Bhatt]
+ * @create date 2026-10-19 19:04:12
+ * @desc
+ *      Construction benchmark for PointToPointGrid_Helper.
+ *
+ *      Builds square grids of increasing size and reports how long the
+ *      nodes + links, the internet stack and the Ipv4 addresses take, and
+ *      the resident / peak memory afterwards. Each size is built in a
+ *      forked child so one grid's memory does not leak into the next
+ *      size's numbers, and a grid that runs out of memory only loses
+ *      its own row.
+ *
+ *      Links get /30 networks from 10.0.0.0/8 (and /127 networks from
+ *      2001:db8::/64 with --ipv6), enough for a 1000x1000 grid.
+ *
+ *      --routing sets up routing after the addresses and times it, then
+ *      takes the row link in the middle of the grid down and times the
+ *      recomputation: how routing reconvergence grows with the grid.
+ *          global      Ipv4GlobalRoutingHelper, a Dijkstra per node into
+ *                      per-node tables, keep the sizes modest
+ *          nexthop     Ipv4NexthopRouting (ipv4-nexthop-routing.h), one
+ *                      shared next-hop matrix computed on --threads
+ *                      threads, a byte per node pair
+ *      --reconverge is --routing=global. With --packets the recomputed
+ *      routes carry that many UDP packets corner to corner, (0, 0) to
+ *      (n-1, n-1), and "us/hop" is the wall time of the run per packet
+ *      per hop: what a lookup costs in the simulation.
+ *      --graph writes every exported grid as a routing/ edge list,
+ *      <prefix>-<n>.graph, for routing/nexthop-matrix.cpp.
+ *
+ *      --distributed runs one size on the ns-3 distributed simulator
+ *      (ns-3 configured with --enable-mpi), the rows split into one block
+ *      per MPI rank. The links between blocks are remote channels and
+ *      their delay is the lookahead, granted time windows by default or
+ *      null messages with --nullmsg. Every rank builds the whole grid and
+ *      its routing (nexthop unless --routing says otherwise), then row r
+ *      sends --packets (100 by default) UDP packets from (r, 0) to
+ *      (n-1-r, n-1), each rank only for the nodes it owns. Rank 0 prints
+ *      "name: value" lines; ns3/grid-scaling.cpp runs this for 1, 2, 4, 8
+ *      ranks and reports the strong scaling.
+ *
+ *      Place the p2p-grid directory in ./scratch/ and run
+ *      >> ./waf --run "p2p-grid --sizes=10,32,100,316,1000"
+ *      >> ./waf --run "p2p-grid --sizes=1000 --internet=false"
+ *      >> ./waf --run "p2p-grid --sizes=5,10,20,40 --reconverge"
+ *      >> ./waf --run "p2p-grid --sizes=10,32,100 --routing=nexthop --packets=1000"
+ *      >> ./waf --run "p2p-grid --sizes=100 --distributed" --command-template="mpirun -np 4 %s"
+ */
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/point-to-point-module.h"
+
+#ifdef NS3_MPI
+#include <mpi.h>
+#include "ns3/mpi-interface.h"
+#endif
+
+#include "p2p-grid.h"
+#include "ipv4-nexthop-routing.h"
+#include "../link-failure.h"
+#include "../child-runner.h"
+
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("GridBenchmark");
+
+
+static double
+SecondsSince (std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double> (std::chrono::steady_clock::now () - start).count ();
+}
+
+
+struct Options
+{
+    bool internet;
+    bool ipv6;
+    std::string routing;    // "none", "global" or "nexthop"
+    unsigned threads;       // for the next-hop matrix, 0 for every core
+    uint32_t packets;       // sent corner to corner after rerouting
+    std::string graph;      // prefix of the exported graphs, empty for none
+};
+
+
+static void
+CountRx (uint32_t *received, Ptr<Socket> socket)
+{
+    while (socket->Recv ())
+    {
+        ++*received;
+    }
+}
+
+static void
+SendPacket (Ptr<Socket> socket)
+{
+    socket->Send (Create<Packet> (64));
+}
+
+/**
+ * Send packets from (0, 0) to (n-1, n-1), one per ms
+ *
+ * \returns wall seconds of the run, the number received in received
+ */
+static double
+SendAcross (PointToPointGrid_Helper &grid, uint32_t n, uint32_t packets, uint32_t &received)
+{
+    uint16_t port = 9;
+    Ptr<Socket> sink = Socket::CreateSocket (grid.GetNode (n - 1, n - 1), UdpSocketFactory::GetTypeId ());
+    sink->Bind (InetSocketAddress (Ipv4Address::GetAny (), port));
+    sink->SetRecvCallback (MakeBoundCallback (&CountRx, &received));
+
+    Ptr<Socket> source = Socket::CreateSocket (grid.GetNode (0, 0), UdpSocketFactory::GetTypeId ());
+    source->Connect (InetSocketAddress (grid.GetIpv4Adress (n - 1, n - 1), port));
+    for (uint32_t i = 0; i < packets; ++i)
+    {
+        Simulator::Schedule (MilliSeconds (i), &SendPacket, source);
+    }
+
+    auto start = std::chrono::steady_clock::now ();
+    Simulator::Run ();
+    return SecondsSince (start);
+}
+
+
+static void
+PrintSeconds (double secs)
+{
+    if (secs < 0)
+    {
+        std::cout << std::setw (10) << "-";
+    }
+    else
+    {
+        std::cout << std::setw (10) << secs;
+    }
+}
+
+
+static void
+InstallRouting (InternetStackHelper &stack, Ptr<NexthopTable> table, const Options &options)
+{
+    // The list asks the higher priority first: the matrix (10) routes
+    // between grid nodes, static routing (0) takes what it has no entry
+    // for, such as loopback and multicast
+    if (options.routing == "nexthop")
+    {
+        Ipv4StaticRoutingHelper staticRouting;
+        Ipv4NexthopRoutingHelper nexthopRouting (table);
+        Ipv4ListRoutingHelper list;
+        list.Add (staticRouting, 0);
+        list.Add (nexthopRouting, 10);
+        stack.SetRoutingHelper (list);
+    }
+}
+
+
+static void
+BuildGrid (uint32_t n, PointToPointHelper &pointToPoint, const Options &options)
+{
+    auto start = std::chrono::steady_clock::now ();
+    PointToPointGrid_Helper grid (n, n, pointToPoint);
+    double buildSecs = SecondsSince (start);
+
+    Ptr<NexthopTable> table = Create<NexthopTable> ();
+    InternetStackHelper stack;
+    InstallRouting (stack, table, options);
+
+    double stackSecs = 0;
+    double addrSecs = 0;
+    if (options.internet)
+    {
+        start = std::chrono::steady_clock::now ();
+        grid.InstallInternet (stack);
+        stackSecs = SecondsSince (start);
+
+        start = std::chrono::steady_clock::now ();
+        grid.AssignIpv4Adress ();
+        if (options.ipv6)
+        {
+            grid.AssignIpv6Address ();
+        }
+        addrSecs = SecondsSince (start);
+    }
+
+    // A 1x1 grid has no link to fail nor hops to time, negative prints as "-"
+    bool routing = options.internet && options.routing != "none";
+    bool nexthop = options.routing == "nexthop";
+    double routeSecs = -1;
+    double rerouteSecs = -1;
+    double hopMicros = -1;
+    uint32_t received = 0;
+    if (routing)
+    {
+        start = std::chrono::steady_clock::now ();
+        if (nexthop)
+        {
+            table->Build (grid.GetNodes (), options.threads);
+        }
+        else
+        {
+            Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+        }
+        routeSecs = SecondsSince (start);
+
+        if (nexthop && !options.graph.empty ())
+        {
+            std::ostringstream path;
+            path << options.graph << "-" << n << ".graph";
+            if (!table->WriteGraph (path.str ()))
+            {
+                NS_FATAL_ERROR ("Cannot write " << path.str ());
+            }
+        }
+
+        if (n > 1)
+        {
+            uint32_t r = n / 2;
+            uint32_t c = (n - 1) / 2;
+            NetDeviceContainer middle;
+            middle.Add (grid.GetRowDevices ().Get (2 * (r * (n - 1) + c)));
+            middle.Add (grid.GetRowDevices ().Get (2 * (r * (n - 1) + c) + 1));
+            LinkFailureSchedule::SetState (middle, false);
+            if (nexthop)
+            {
+                start = std::chrono::steady_clock::now ();
+                table->Build (grid.GetNodes (), options.threads);
+                rerouteSecs = SecondsSince (start);
+            }
+            else
+            {
+                rerouteSecs = LinkFailureSchedule::Recompute ();
+            }
+
+            if (options.packets > 0)
+            {
+                double runSecs = SendAcross (grid, n, options.packets, received);
+                if (received > 0)
+                {
+                    hopMicros = runSecs * 1e6 / (received * 2.0 * (n - 1));
+                }
+            }
+        }
+    }
+
+    uint64_t links = (grid.GetRowDevices ().GetN () + grid.GetColDevices ().GetN ()) / 2;
+    std::cout << std::setw (6) << n << "x" << std::left << std::setw (6) << n << std::right
+              << std::setw (10) << n * n
+              << std::setw (10) << links
+              << std::fixed << std::setprecision (3)
+              << std::setw (10) << buildSecs
+              << std::setw (10) << stackSecs
+              << std::setw (10) << addrSecs;
+    if (options.routing != "none")
+    {
+        PrintSeconds (routeSecs);
+        PrintSeconds (rerouteSecs);
+    }
+    if (options.routing == "nexthop")
+    {
+        std::cout << std::setprecision (1) << std::setw (10) << table->GetMemory () / 1048576.0;
+    }
+    if (options.packets > 0)
+    {
+        std::cout << std::setw (10) << received;
+        if (hopMicros < 0)
+        {
+            std::cout << std::setw (10) << "-";
+        }
+        else
+        {
+            std::cout << std::setprecision (2) << std::setw (10) << hopMicros;
+        }
+    }
+    std::cout << std::setprecision (1)
+              << std::setw (10) << ReadStatusKb ("VmRSS") / 1024.0
+              << std::setw (10) << ReadStatusKb ("VmHWM") / 1024.0
+              << std::endl;
+
+    Simulator::Destroy ();
+}
+
+
+#ifdef NS3_MPI
+/**
+ * One size on the distributed simulator, see the file comment. Every rank
+ * has the whole topology, so routing needs no exchange between ranks
+ */
+static void
+RunDistributed (uint32_t n, PointToPointHelper &pointToPoint, const Options &options)
+{
+    uint32_t rank = MpiInterface::GetSystemId ();
+    uint32_t nRanks = MpiInterface::GetSize ();
+
+    auto start = std::chrono::steady_clock::now ();
+    PointToPointGrid_Helper grid (n, n, pointToPoint, nRanks);
+    Ptr<NexthopTable> table = Create<NexthopTable> ();
+    InternetStackHelper stack;
+    InstallRouting (stack, table, options);
+    grid.InstallInternet (stack);
+    grid.AssignIpv4Adress ();
+    double buildSecs = SecondsSince (start);
+
+    start = std::chrono::steady_clock::now ();
+    if (options.routing == "nexthop")
+    {
+        table->Build (grid.GetNodes (), options.threads);
+    }
+    else
+    {
+        Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+    }
+    double routeSecs = SecondsSince (start);
+
+    uint32_t remoteLinks = 0;
+    for (uint32_t r = 1; r < n; ++r)
+    {
+        if (grid.GetNode (r, 0)->GetSystemId () != grid.GetNode (r - 1, 0)->GetSystemId ())
+        {
+            remoteLinks += n;
+        }
+    }
+
+    // Row r's flow ends in row n-1-r, so most flows cross into other blocks
+    uint16_t port = 9;
+    uint32_t received = 0;
+    for (uint32_t r = 0; r < n; ++r)
+    {
+        Ptr<Node> from = grid.GetNode (r, 0);
+        Ptr<Node> to = grid.GetNode (n - 1 - r, n - 1);
+        if (to->GetSystemId () == rank)
+        {
+            Ptr<Socket> sink = Socket::CreateSocket (to, UdpSocketFactory::GetTypeId ());
+            sink->Bind (InetSocketAddress (Ipv4Address::GetAny (), port));
+            sink->SetRecvCallback (MakeBoundCallback (&CountRx, &received));
+        }
+        if (from->GetSystemId () == rank)
+        {
+            Ptr<Socket> source = Socket::CreateSocket (from, UdpSocketFactory::GetTypeId ());
+            source->Connect (InetSocketAddress (grid.GetIpv4Adress (n - 1 - r, n - 1), port));
+            for (uint32_t i = 0; i < options.packets; ++i)
+            {
+                Simulator::ScheduleWithContext (from->GetId (), MilliSeconds (i), &SendPacket, source);
+            }
+        }
+    }
+
+    // The distributed simulator needs a stop time; 10 s drains the longest
+    // path of a 1000x1000 grid at the default 2 ms per link
+    Simulator::Stop (MilliSeconds (options.packets) + Seconds (10));
+    start = std::chrono::steady_clock::now ();
+    Simulator::Run ();
+    double runSecs = SecondsSince (start);
+
+    uint32_t totalReceived = 0;
+    double slowestSecs = 0;
+    MPI_Reduce (&received, &totalReceived, 1, MPI_UNSIGNED, MPI_SUM, 0, MPI_COMM_WORLD);
+    MPI_Reduce (&runSecs, &slowestSecs, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+
+    if (rank == 0)
+    {
+        std::cout << std::fixed << std::setprecision (3)
+                  << "Grid: " << n << "\n"
+                  << "Ranks: " << nRanks << "\n"
+                  << "Nodes: " << n * n << "\n"
+                  << "Remote links: " << remoteLinks << "\n"
+                  << "Build seconds: " << buildSecs << "\n"
+                  << "Routing seconds: " << routeSecs << "\n"
+                  << "Run seconds: " << slowestSecs << "\n"
+                  << "Packets sent: " << uint64_t (n) * options.packets << "\n"
+                  << "Packets received: " << totalReceived << "\n"
+                  << "Peak MB: " << std::setprecision (1) << ReadStatusKb ("VmHWM") / 1024.0
+                  << std::endl;
+    }
+
+    Simulator::Destroy ();
+}
+#endif
+
+
+int
+main (int argc, char *argv[])
+{
+    std::string sizes = "10,32,100,316,1000";
+    std::string dataRate = "5Mbps";
+    std::string delay = "2ms";
+    bool isolate = true;
+    bool reconverge = false;
+    bool distributed = false;
+    bool nullmsg = false;
+    Options options;
+    options.internet = true;
+    options.ipv6 = false;
+    options.routing = "none";
+    options.threads = 0;
+    options.packets = 0;
+
+    CommandLine cmd;
+    cmd.AddValue ("sizes", "Comma separated grid sizes, each builds an n x n grid", sizes);
+    cmd.AddValue ("dataRate", "Data rate of every link", dataRate);
+    cmd.AddValue ("delay", "Delay of every link", delay);
+    cmd.AddValue ("internet", "Also install the internet stack and Ipv4 addresses", options.internet);
+    cmd.AddValue ("ipv6", "Assign Ipv6 addresses as well", options.ipv6);
+    cmd.AddValue ("isolate", "Build every size in its own process", isolate);
+    cmd.AddValue ("routing", "Routing to time with its recomputation after a link failure: "
+                  "none, global or nexthop", options.routing);
+    cmd.AddValue ("reconverge", "Same as --routing=global", reconverge);
+    cmd.AddValue ("threads", "Threads computing the next-hop matrix, 0 for every core", options.threads);
+    cmd.AddValue ("packets", "Packets sent corner to corner over the rerouted grid", options.packets);
+    cmd.AddValue ("graph", "Write each grid's exported graph to <graph>-<n>.graph", options.graph);
+    cmd.AddValue ("distributed", "Split the rows across the MPI ranks, run under mpirun", distributed);
+    cmd.AddValue ("nullmsg", "Null-message synchronisation instead of granted time windows", nullmsg);
+    cmd.Parse (argc, argv);
+
+    if (distributed && options.routing == "none")
+    {
+        options.routing = "nexthop";
+    }
+    if (distributed && options.packets == 0)
+    {
+        options.packets = 100;
+    }
+
+    if (reconverge && options.routing == "none")
+    {
+        options.routing = "global";
+    }
+    if (options.routing != "none" && options.routing != "global" && options.routing != "nexthop")
+    {
+        NS_FATAL_ERROR ("Unknown routing " << options.routing << ", use none, global or nexthop.");
+    }
+    if (options.routing == "none" || !options.internet)
+    {
+        options.packets = 0;
+    }
+
+    std::vector<uint32_t> sides;
+    std::stringstream list (sizes);
+    std::string item;
+    while (std::getline (list, item, ','))
+    {
+        if (std::stoul (item) < 1)
+        {
+            NS_FATAL_ERROR ("Grid size must be at least 1.");
+        }
+        sides.push_back (std::stoul (item));
+    }
+
+    PointToPointHelper pointToPoint;
+    pointToPoint.SetDeviceAttribute ("DataRate", StringValue (dataRate));
+    pointToPoint.SetChannelAttribute ("Delay", StringValue (delay));
+
+    if (distributed)
+    {
+#ifdef NS3_MPI
+        if (sides.size () != 1 || sides[0] < 2)
+        {
+            NS_FATAL_ERROR ("--distributed runs a single size of at least 2.");
+        }
+        GlobalValue::Bind ("SimulatorImplementationType",
+                           StringValue (nullmsg ? "ns3::NullMessageSimulatorImpl" : "ns3::DistributedSimulatorImpl"));
+        MpiInterface::Enable (&argc, &argv);
+        RunDistributed (sides[0], pointToPoint, options);
+        MpiInterface::Disable ();
+        return 0;
+#else
+        NS_FATAL_ERROR ("--distributed needs ns-3 configured with --enable-mpi.");
+#endif
+    }
+
+    std::cout << std::setw (13) << "grid"
+              << std::setw (10) << "nodes"
+              << std::setw (10) << "links"
+              << std::setw (10) << "build s"
+              << std::setw (10) << "stack s"
+              << std::setw (10) << "addr s";
+    if (options.routing != "none")
+    {
+        std::cout << std::setw (10) << "route s"
+                  << std::setw (10) << "reroute s";
+    }
+    if (options.routing == "nexthop")
+    {
+        std::cout << std::setw (10) << "matrix MB";
+    }
+    if (options.packets > 0)
+    {
+        std::cout << std::setw (10) << "received"
+                  << std::setw (10) << "us/hop";
+    }
+    std::cout << std::setw (10) << "rss MB"
+              << std::setw (10) << "peak MB"
+              << std::endl;
+
+    for (uint32_t n : sides)
+    {
+        if (!isolate)
+        {
+            BuildGrid (n, pointToPoint, options);
+            continue;
+        }
+
+        ChildRunner::Run (1, 1,
+            [&] (size_t)
+            {
+                BuildGrid (n, pointToPoint, options);
+                return std::string ();
+            },
+            [&] (size_t, bool ok, const std::string &)
+            {
+                if (!ok)
+                {
+                    std::cout << std::setw (6) << n << "x" << std::left << std::setw (6) << n << std::right
+                              << "   failed (likely out of memory)" << std::endl;
+                }
+            });
+    }
+
+    return 0;
+}
@@ -0,0 +1,343 @@
+/**
+ * @author Harshil Bhatt
+ * @create date 2026-10-19 23:59:58
+ * @desc
+ *      Ipv4 routing from a precomputed next-hop matrix, see
+ *      ipv4-nexthop-routing.h
+ */
+
+
+#include "ipv4-nexthop-routing.h"
+
+#include <fstream>
+
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include "ns3/node.h"
+#include "ns3/node-list.h"
+#include "ns3/channel.h"
+#include "ns3/ipv4.h"
+#include "ns3/ipv4-route.h"
+#include "ns3/output-stream-wrapper.h"
+#include "ns3/simulator.h"
+
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("Ipv4NexthopRouting");
+
+NS_OBJECT_ENSURE_REGISTERED (Ipv4NexthopRouting);
+
+
+NexthopTable::NexthopTable ()
+{
+}
+
+void
+NexthopTable::Build (NodeContainer nodes, unsigned threads)
+{
+    Export (nodes);
+    Compute (threads);
+}
+
+void
+NexthopTable::Export (NodeContainer nodes)
+{
+    m_vertexOfNode.assign (NodeList::GetNNodes (), NO_VERTEX);
+    for (uint32_t i = 0; i < nodes.GetN (); ++i)
+    {
+        m_vertexOfNode[nodes.Get (i)->GetId ()] = i;
+    }
+    m_vertexOfAddress.clear ();
+    m_ports.assign (nodes.GetN (), std::vector<Port> ());
+    m_graph = NexthopGraph (nodes.GetN ());
+
+    for (uint32_t u = 0; u < nodes.GetN (); ++u)
+    {
+        Ptr<Node> node = nodes.Get (u);
+        Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
+        NS_ABORT_MSG_IF (ipv4 == 0, "Install the internet stack before building the next-hop table.");
+
+        for (uint32_t i = 0; i < ipv4->GetNInterfaces (); ++i)
+        {
+            for (uint32_t j = 0; j < ipv4->GetNAddresses (i); ++j)
+            {
+                Ipv4Address local = ipv4->GetAddress (i, j).GetLocal ();
+                if (local != Ipv4Address::GetLoopback ())
+                {
+                    m_vertexOfAddress[local.Get ()] = u;
+                }
+            }
+        }
+
+        for (uint32_t k = 0; k < node->GetNDevices (); ++k)
+        {
+            Ptr<NetDevice> device = node->GetDevice (k);
+            Ptr<Channel> channel = device->GetChannel ();
+            if (channel == 0 || channel->GetNDevices () != 2)
+            {
+                continue;
+            }
+            Ptr<NetDevice> peer = channel->GetDevice (channel->GetDevice (0) == device ? 1 : 0);
+            uint32_t peerId = peer->GetNode ()->GetId ();
+            uint32_t v = peerId < m_vertexOfNode.size () ? m_vertexOfNode[peerId] : NO_VERTEX;
+            // Every link once, from its lower end
+            if (v == NO_VERTEX || v <= u)
+            {
+                continue;
+            }
+
+            Ptr<Ipv4> peerIpv4 = peer->GetNode ()->GetObject<Ipv4> ();
+            int32_t here = ipv4->GetInterfaceForDevice (device);
+            int32_t there = peerIpv4 ? peerIpv4->GetInterfaceForDevice (peer) : -1;
+            if (here < 0 || there < 0 || !ipv4->IsUp (here) || !peerIpv4->IsUp (there)
+                || ipv4->GetNAddresses (here) == 0 || peerIpv4->GetNAddresses (there) == 0)
+            {
+                continue;
+            }
+
+            // Ports are pushed in the order NexthopGraph numbers them
+            if (!m_graph.addEdge (u, v, ipv4->GetMetric (here)))
+            {
+                NS_FATAL_ERROR ("Node " << node->GetId () << " or " << peerId << " has more than "
+                                << NEXTHOP_MAX_PORTS << " links for the next-hop matrix.");
+            }
+            Port out = { uint32_t (here), peerIpv4->GetAddress (there, 0).GetLocal () };
+            Port back = { uint32_t (there), ipv4->GetAddress (here, 0).GetLocal () };
+            m_ports[u].push_back (out);
+            m_ports[v].push_back (back);
+        }
+    }
+    NS_LOG_INFO ("Exported " << m_graph.numVertices () << " nodes, " << m_graph.numEdges () << " links");
+}
+
+bool
+NexthopTable::WriteGraph (const std::string &path) const
+{
+    std::ofstream out (path.c_str ());
+    if (!out)
+    {
+        return false;
+    }
+    out << m_graph.numVertices () << " " << m_graph.numEdges () << "\n";
+    // Each edge from its lower end; Export added them in this order, so
+    // the file numbers the ports the same way
+    for (uint32_t u = 0; u < m_graph.numVertices (); ++u)
+    {
+        for (const NexthopGraph::Port &p : m_graph.ports (u))
+        {
+            if (p.vertex > u)
+            {
+                out << u << " " << p.vertex << " " << p.weight << "\n";
+            }
+        }
+    }
+    return bool (out);
+}
+
+void
+NexthopTable::Compute (unsigned threads)
+{
+    m_matrix.compute (m_graph, threads);
+}
+
+void
+NexthopTable::Load (const std::string &path)
+{
+    std::string error;
+    if (!m_matrix.load (path.c_str (), error))
+    {
+        NS_FATAL_ERROR (path << ": " << error);
+    }
+    NS_ABORT_MSG_IF (m_matrix.numVertices () != m_graph.numVertices (),
+                     path << " has " << m_matrix.numVertices () << " nodes, the topology "
+                     << m_graph.numVertices ());
+}
+
+bool
+NexthopTable::Lookup (uint32_t nodeId, Ipv4Address dest, uint32_t &interface, Ipv4Address &gateway) const
+{
+    if (nodeId >= m_vertexOfNode.size () || m_matrix.numVertices () != m_ports.size ())
+    {
+        return false;
+    }
+    uint32_t source = m_vertexOfNode[nodeId];
+    std::unordered_map<uint32_t, uint32_t>::const_iterator it = m_vertexOfAddress.find (dest.Get ());
+    if (source == NO_VERTEX || it == m_vertexOfAddress.end ())
+    {
+        return false;
+    }
+    uint8_t port = m_matrix.hop (source, it->second);
+    if (port == NEXTHOP_NONE)
+    {
+        return false;
+    }
+    interface = m_ports[source][port].interface;
+    gateway = m_ports[source][port].gateway;
+    return true;
+}
+
+uint32_t
+NexthopTable::GetNVertices (void) const
+{
+    return m_graph.numVertices ();
+}
+
+size_t
+NexthopTable::GetMemory (void) const
+{
+    return m_matrix.memory ();
+}
+
+
+TypeId
+Ipv4NexthopRouting::GetTypeId (void)
+{
+    static TypeId tid = TypeId ("ns3::Ipv4NexthopRouting")
+        .SetParent<Ipv4RoutingProtocol> ()
+        .AddConstructor<Ipv4NexthopRouting> ();
+    return tid;
+}
+
+Ipv4NexthopRouting::Ipv4NexthopRouting ()
+    : m_nodeId (0)
+{
+}
+
+void
+Ipv4NexthopRouting::SetTable (Ptr<NexthopTable> table, uint32_t nodeId)
+{
+    m_table = table;
+    m_nodeId = nodeId;
+}
+
+Ptr<Ipv4Route>
+Ipv4NexthopRouting::RouteOutput (Ptr<Packet> p, const Ipv4Header &header, Ptr<NetDevice> oif,
+                                 Socket::SocketErrno &sockerr)
+{
+    Ipv4Address dest = header.GetDestination ();
+    uint32_t interface;
+    Ipv4Address gateway;
+    if (dest.IsMulticast () || dest.IsBroadcast () || !m_table->Lookup (m_nodeId, dest, interface, gateway)
+        || (oif && int32_t (interface) != m_ipv4->GetInterfaceForDevice (oif)))
+    {
+        sockerr = Socket::ERROR_NOROUTETOHOST;
+        return 0;
+    }
+    sockerr = Socket::ERROR_NOTERROR;
+    return MakeRoute (dest, interface, gateway);
+}
+
+bool
+Ipv4NexthopRouting::RouteInput (Ptr<const Packet> p, const Ipv4Header &header, Ptr<const NetDevice> idev,
+                                UnicastForwardCallback ucb, MulticastForwardCallback mcb,
+                                LocalDeliverCallback lcb, ErrorCallback ecb)
+{
+    Ipv4Address dest = header.GetDestination ();
+    if (dest.IsMulticast ())
+    {
+        return false;
+    }
+    uint32_t iif = m_ipv4->GetInterfaceForDevice (idev);
+    if (m_ipv4->IsDestinationAddress (dest, iif))
+    {
+        if (!lcb.IsNull ())
+        {
+            lcb (p, header, iif);
+            return true;
+        }
+        return false;
+    }
+    if (!m_ipv4->IsForwarding (iif))
+    {
+        ecb (p, header, Socket::ERROR_NOROUTETOHOST);
+        return true;
+    }
+
+    uint32_t interface;
+    Ipv4Address gateway;
+    if (!m_table->Lookup (m_nodeId, dest, interface, gateway))
+    {
+        return false;
+    }
+    ucb (MakeRoute (dest, interface, gateway), p, header);
+    return true;
+}
+
+// The table is rebuilt as a whole by its owner, one node's interface
+// changes do not touch it
+void
+Ipv4NexthopRouting::NotifyInterfaceUp (uint32_t interface)
+{
+}
+
+void
+Ipv4NexthopRouting::NotifyInterfaceDown (uint32_t interface)
+{
+}
+
+void
+Ipv4NexthopRouting::NotifyAddAddress (uint32_t interface, Ipv4InterfaceAddress address)
+{
+}
+
+void
+Ipv4NexthopRouting::NotifyRemoveAddress (uint32_t interface, Ipv4InterfaceAddress address)
+{
+}
+
+void
+Ipv4NexthopRouting::SetIpv4 (Ptr<Ipv4> ipv4)
+{
+    NS_ASSERT (m_ipv4 == 0 && ipv4 != 0);
+    m_ipv4 = ipv4;
+}
+
+void
+Ipv4NexthopRouting::PrintRoutingTable (Ptr<OutputStreamWrapper> stream, Time::Unit unit) const
+{
+    *stream->GetStream () << "Node: " << m_nodeId << ", Time: " << Now ().As (unit)
+                          << ", Ipv4NexthopRouting: next-hop matrix over " << m_table->GetNVertices ()
+                          << " nodes" << std::endl;
+}
+
+void
+Ipv4NexthopRouting::DoDispose (void)
+{
+    m_table = 0;
+    m_ipv4 = 0;
+    Ipv4RoutingProtocol::DoDispose ();
+}
+
+Ptr<Ipv4Route>
+Ipv4NexthopRouting::MakeRoute (Ipv4Address dest, uint32_t interface, Ipv4Address gateway) const
+{
+    Ptr<Ipv4Route> rtentry = Create<Ipv4Route> ();
+    rtentry->SetDestination (dest);
+    rtentry->SetSource (m_ipv4->SourceAddressSelection (interface, dest));
+    rtentry->SetGateway (gateway);
+    rtentry->SetOutputDevice (m_ipv4->GetNetDevice (interface));
+    return rtentry;
+}
+
+
+Ipv4NexthopRoutingHelper::Ipv4NexthopRoutingHelper (Ptr<NexthopTable> table)
+    : m_table (table)
+{
+}
+
+Ipv4NexthopRoutingHelper *
+Ipv4NexthopRoutingHelper::Copy (void) const
+{
+    return new Ipv4NexthopRoutingHelper (*this);
+}
+
+Ptr<Ipv4RoutingProtocol>
+Ipv4NexthopRoutingHelper::Create (Ptr<Node> node) const
+{
+    Ptr<Ipv4NexthopRouting> routing = CreateObject<Ipv4NexthopRouting> ();
+    routing->SetTable (m_table, node->GetId ());
+    return routing;
+}
+
+} // namespace ns3
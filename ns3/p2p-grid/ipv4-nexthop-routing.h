@@ -0,0 +1,174 @@
+/**
+ * @author Harshil Bhatt
+ * @create date 2026-10-19 23:59:58
+ * @desc
+ *      Ipv4 routing from a precomputed next-hop matrix.
+ *
+ *      Global routing runs an SPF per node and keeps a route per network in
+ *      every node's table, which on a 10k node grid is both slow to set up
+ *      and slow to look up (a linear scan per packet). NexthopTable instead
+ *          - exports the nodes and the point-to-point channels between them
+ *            into the graph of routing/nexthop-matrix.h (edge weight =
+ *            interface metric, links with a down end are left out),
+ *          - computes every source's first hops once on several threads,
+ *            or loads a matrix routing/nexthop-matrix.cpp saved,
+ *          - maps every interface address to its node.
+ *      Ipv4NexthopRouting then forwards a packet with one hash lookup
+ *      (destination address to node) and one matrix read.
+ *
+ *      The matrix takes a byte per node pair, 100 MB at 10k nodes, shared
+ *      by every node. Nothing is recomputed on its own: after taking links
+ *      down or up, call Build again.
+ *
+ *      Ipv4ListRouting asks the protocol with the higher priority first, so
+ *      below the matrix routes every packet between grid nodes and static
+ *      routing only gets what it has no entry for (loopback, multicast,
+ *      host routes added by hand outside the grid).
+ *
+ *          Ptr<NexthopTable> table = Create<NexthopTable> ();
+ *          Ipv4StaticRoutingHelper staticRouting;
+ *          Ipv4NexthopRoutingHelper nexthopRouting (table);
+ *          Ipv4ListRoutingHelper list;
+ *          list.Add (staticRouting, 0);
+ *          list.Add (nexthopRouting, 10);
+ *          InternetStackHelper internet;
+ *          internet.SetRoutingHelper (list);
+ *          grid.InstallInternet (internet);
+ *          grid.AssignIpv4Adress ();
+ *          table->Build (grid.GetNodes ());
+ */
+
+#ifndef IPV4_NEXTHOP_ROUTING_H
+#define IPV4_NEXTHOP_ROUTING_H
+
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "ns3/ipv4-routing-protocol.h"
+#include "ns3/ipv4-routing-helper.h"
+#include "ns3/node-container.h"
+
+#include "../../routing/nexthop-matrix.h"
+
+
+namespace ns3 {
+
+class NexthopTable : public SimpleRefCount<NexthopTable>
+{
+public:
+    NexthopTable ();
+
+    /**
+     * Export nodes and compute the matrix
+     *
+     * \param threads threads for the matrix, 0 for every core
+     */
+    void Build (NodeContainer nodes, unsigned threads = 0);
+
+    /**
+     * Turn nodes and the point-to-point channels between them into the
+     * graph and port tables, without computing the matrix
+     */
+    void Export (NodeContainer nodes);
+
+    /**
+     * Write the exported graph as a routing/ edge list, vertex i being
+     * nodes.Get (i)
+     */
+    bool WriteGraph (const std::string &path) const;
+
+    /**
+     * Compute the matrix of the exported graph
+     */
+    void Compute (unsigned threads = 0);
+
+    /**
+     * Load the matrix of the exported graph from a file
+     * routing/nexthop-matrix.cpp saved
+     */
+    void Load (const std::string &path);
+
+    /**
+     * \returns false if node cannot reach dest through the table
+     */
+    bool Lookup (uint32_t nodeId, Ipv4Address dest, uint32_t &interface, Ipv4Address &gateway) const;
+
+    uint32_t GetNVertices (void) const;
+
+    /**
+     * \returns bytes of the matrix
+     */
+    size_t GetMemory (void) const;
+
+private:
+    struct Port
+    {
+        uint32_t interface;
+        Ipv4Address gateway;    // the other end of the link
+    };
+
+    static const uint32_t NO_VERTEX = 0xffffffff;
+
+    std::vector<uint32_t> m_vertexOfNode;                       // by node id
+    std::unordered_map<uint32_t, uint32_t> m_vertexOfAddress;   // by Ipv4 address
+    std::vector<std::vector<Port> > m_ports;                    // same order as the graph's
+    NexthopGraph m_graph;
+    NexthopMatrix m_matrix;
+};
+
+
+class Ipv4NexthopRouting : public Ipv4RoutingProtocol
+{
+public:
+    static TypeId GetTypeId (void);
+
+    Ipv4NexthopRouting ();
+
+    void SetTable (Ptr<NexthopTable> table, uint32_t nodeId);
+
+    virtual Ptr<Ipv4Route> RouteOutput (Ptr<Packet> p, const Ipv4Header &header, Ptr<NetDevice> oif,
+                                        Socket::SocketErrno &sockerr);
+    virtual bool RouteInput (Ptr<const Packet> p, const Ipv4Header &header, Ptr<const NetDevice> idev,
+                             UnicastForwardCallback ucb, MulticastForwardCallback mcb,
+                             LocalDeliverCallback lcb, ErrorCallback ecb);
+    virtual void NotifyInterfaceUp (uint32_t interface);
+    virtual void NotifyInterfaceDown (uint32_t interface);
+    virtual void NotifyAddAddress (uint32_t interface, Ipv4InterfaceAddress address);
+    virtual void NotifyRemoveAddress (uint32_t interface, Ipv4InterfaceAddress address);
+    virtual void SetIpv4 (Ptr<Ipv4> ipv4);
+    virtual void PrintRoutingTable (Ptr<OutputStreamWrapper> stream, Time::Unit unit = Time::S) const;
+
+protected:
+    virtual void DoDispose (void);
+
+private:
+    Ptr<Ipv4Route> MakeRoute (Ipv4Address dest, uint32_t interface, Ipv4Address gateway) const;
+
+    Ptr<Ipv4> m_ipv4;
+    Ptr<NexthopTable> m_table;
+    uint32_t m_nodeId;
+};
+
+
+class Ipv4NexthopRoutingHelper : public Ipv4RoutingHelper
+{
+public:
+    /**
+     * \param table shared by every node the helper installs on, filled
+     *              in later by NexthopTable::Build
+     */
+    Ipv4NexthopRoutingHelper (Ptr<NexthopTable> table);
+
+    virtual Ipv4NexthopRoutingHelper *Copy (void) const;
+    virtual Ptr<Ipv4RoutingProtocol> Create (Ptr<Node> node) const;
+
+private:
+    Ptr<NexthopTable> m_table;
+};
+
+} // namespace ns3
+
+
+#endif /* IPV4_NEXTHOP_ROUTING_H */
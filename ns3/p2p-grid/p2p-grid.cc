@@ -13,7 +13,11 @@
 #include "ns3/string.h"
 #include "ns3/vector.h"
 #include "ns3/log.h"
-#include "ns3/ipv6-address-generator.h"
+#include "ns3/ipv4.h"
+#include "ns3/ipv6.h"
+#include "ns3/net-device-queue-interface.h"
+#include "ns3/traffic-control-layer.h"
+#include "ns3/traffic-control-helper.h"
 
 
 using namespace ns3;
@@ -21,44 +25,48 @@ using namespace ns3;
 NS_LOG_COMPONENT_DEFINE ("P2P-Grid");
 
 PointToPointGrid_Helper::PointToPointGrid_Helper (uint32_t nRows, uint32_t nCols, 
-                                                  PointToPointHelper pointToPoint)
+                                                  PointToPointHelper pointToPoint,
+                                                  uint32_t nSystems)
     : m_xSize (nCols), m_ySize (nRows)
 {
     if (m_xSize < 1 || m_ySize < 1)
     {
         NS_FATAL_ERROR ("Need more nodes for grid.");
     }
+    if (nSystems < 1 || nSystems > nRows)
+    {
+        NS_FATAL_ERROR ("Cannot split " << nRows << " rows into " << nSystems << " systems.");
+    }
 
-    InternetStackHelper internet;
+    // (r, c) lands at r*nCols + c. A row at a time when split, still in
+    // order so the node ids stay consecutive
+    if (nSystems == 1)
+    {
+        m_nodes.Create (nRows * nCols);
+    }
+    else
+    {
+        for (uint32_t y = 0; y < nRows; y++)
+        {
+            m_nodes.Create (nCols, uint64_t (y) * nSystems / nRows);
+        }
+    }
+    m_firstId = m_nodes.Get (0)->GetId ();
 
+    // Links are installed in the order of their flat index, so the
+    // device containers never need to be searched
     for (uint32_t y = 0; y < nRows; y++)
     {
-        NodeContainer rowNodes;
-        NetDeviceContainer rowDevices;
-        NetDeviceContainer colDevices;
-
-        for (uint32_t x = 0; x < nCols; x++)
+        for (uint32_t x = 1; x < nCols; x++)
         {
-            rowNodes.Create(1);
-            
-            // Install p2p links across the row
-            if (x > 0)
-            {
-                rowDevices.Add (pointToPoint.Install (rowNodes.Get(x-1), rowNodes.Get(x)));
-            }
-            // Install vertical p2p links 
-            if (y > 0)
-            {
-                colDevices.Add (pointToPoint.Install (m_nodes.at(y-1).Get(x), rowNodes.Get(x)));
-            }
+            m_rowDevices.Add (pointToPoint.Install (GetNode (y, x-1), GetNode (y, x)));
         }
-        
-        m_nodes.push_back (rowNodes);
-        m_rowDevices.push_back (rowDevices);
-
-        if (y > 0)
+    }
+    for (uint32_t y = 1; y < nRows; y++)
+    {
+        for (uint32_t x = 0; x < nCols; x++)
         {
-            m_colDevices.push_back (colDevices);
+            m_colDevices.Add (pointToPoint.Install (GetNode (y-1, x), GetNode (y, x)));
         }
     }
 }
@@ -70,45 +78,170 @@ PointToPointGrid_Helper::~PointToPointGrid_Helper ()
 }
 
 void
-PointToPointGrid_Helper::InstallInternet (InternetStackHelper internet)
+PointToPointGrid_Helper::InstallInternet (const InternetStackHelper &internet)
+{
+    internet.Install (m_nodes);
+}
+
+std::pair<Ptr<NetDevice>, Ptr<NetDevice> >
+PointToPointGrid_Helper::GetLink (uint32_t k) const
 {
-    for (uint32_t i = 0; i < m_nodes.size(); ++i)
+    uint32_t rowLinks = m_rowDevices.GetN () / 2;
+    if (k < rowLinks)
     {
-        NodeContainer rowNodes = m_nodes[i];
-        for (uint32_t j = 0; j < rowNodes.GetN(); ++j)
-        {
-            internet.Install (rowNodes.Get(j));
-        }
+        return std::make_pair (m_rowDevices.Get (2*k), m_rowDevices.Get (2*k + 1));
     }
+    k -= rowLinks;
+    return std::make_pair (m_colDevices.Get (2*k), m_colDevices.Get (2*k + 1));
+}
+
+uint32_t
+PointToPointGrid_Helper::GetIndex (Ptr<NetDevice> device) const
+{
+    return device->GetNode ()->GetId () - m_firstId;
+}
+
+// Same default queue disc Ipv4AddressHelper::Assign would install
+static void
+InstallDefaultQueueDisc (Ptr<NetDevice> device)
+{
+    Ptr<TrafficControlLayer> tc = device->GetNode ()->GetObject<TrafficControlLayer> ();
+    if (tc && tc->GetRootQueueDiscOnDevice (device) == 0
+        && device->GetObject<NetDeviceQueueInterface> ())
+    {
+        TrafficControlHelper::Default ().Install (device);
+    }
+}
+
+static void
+AddIpv4 (Ptr<NetDevice> device, Ipv4Address address)
+{
+    Ptr<Ipv4> ipv4 = device->GetNode ()->GetObject<Ipv4> ();
+    NS_ASSERT_MSG (ipv4, "Install the internet stack before assigning addresses.");
+
+    int32_t ifIndex = ipv4->GetInterfaceForDevice (device);
+    if (ifIndex == -1)
+    {
+        ifIndex = ipv4->AddInterface (device);
+    }
+    ipv4->AddAddress (ifIndex, Ipv4InterfaceAddress (address, Ipv4Mask ("255.255.255.252")));
+    ipv4->SetMetric (ifIndex, 1);
+    ipv4->SetUp (ifIndex);
+    InstallDefaultQueueDisc (device);
+}
+
+static void
+AddIpv6 (Ptr<NetDevice> device, Ipv6Address address)
+{
+    Ptr<Ipv6> ipv6 = device->GetNode ()->GetObject<Ipv6> ();
+    NS_ASSERT_MSG (ipv6, "Install the internet stack before assigning addresses.");
+
+    int32_t ifIndex = ipv6->GetInterfaceForDevice (device);
+    if (ifIndex == -1)
+    {
+        ifIndex = ipv6->AddInterface (device);
+    }
+    ipv6->SetMetric (ifIndex, 1);
+    ipv6->AddAddress (ifIndex, Ipv6InterfaceAddress (address, Ipv6Prefix (127)));
+    ipv6->SetUp (ifIndex);
+    InstallDefaultQueueDisc (device);
 }
 
 void
-PointToPointGrid_Helper::AssignIpv4Adress (Ipv4AddressHelper rowIp, Ipv4AddressHelper colIp)
+PointToPointGrid_Helper::AssignIpv4Adress (Ipv4Address network, Ipv4Mask mask)
 {
-    for (uint32_t i = 0; i < m_nodes.size(); ++i)
+    uint32_t nLinks = (m_rowDevices.GetN () + m_colDevices.GetN ()) / 2;
+    uint64_t poolSize = uint64_t (1) << (32 - mask.GetPrefixLength ());
+    if (network.CombineMask (mask) != network)
+    {
+        NS_FATAL_ERROR ("Ipv4 pool " << network << " is not aligned to its mask.");
+    }
+    if (uint64_t (nLinks) * 4 > poolSize)
+    {
+        NS_FATAL_ERROR ("Ipv4 pool too small for " << nLinks << " links.");
+    }
+
+    // Link k owns base + 4k .. base + 4k + 3, its ends are +1 and +2.
+    // A node reports the first address it is given, which is the left
+    // end of its row link for col 0 and the right end of the link to its
+    // left otherwise (or the vertical equivalents in a single column).
+    m_ipv4.assign (m_nodes.GetN (), Ipv4Address ());
+    uint32_t base = network.Get ();
+    for (uint32_t k = 0; k < nLinks; ++k)
     {
-        Ipv4InterfaceContainer rowInterfaces;
-        NetDeviceContainer rowContainer = m_rowDevices[i];
-        for (uint32_t j = 0; j < rowContainer.GetN(); ++j)
+        std::pair<Ptr<NetDevice>, Ptr<NetDevice> > link = GetLink (k);
+        Ipv4Address a (base + 4*k + 1);
+        Ipv4Address b (base + 4*k + 2);
+        AddIpv4 (link.first, a);
+        AddIpv4 (link.second, b);
+
+        Ipv4Address &first = m_ipv4[GetIndex (link.first)];
+        if (first == Ipv4Address ())
+        {
+            first = a;
+        }
+        Ipv4Address &second = m_ipv4[GetIndex (link.second)];
+        if (second == Ipv4Address ())
         {
-            rowInterfaces.Add (rowIp.Assign (rowContainer.Get(j)));
-            rowInterfaces.Add (rowIp.Assign (rowContainer.Get(j+1)));
-            rowIp.NewNetwork();
+            second = b;
         }
-        m_rowInterfaces.push_back (rowInterfaces);
+    }
+}
+
+void
+PointToPointGrid_Helper::AssignIpv6Address (Ipv6Address network, Ipv6Prefix prefix)
+{
+    uint32_t nLinks = (m_rowDevices.GetN () + m_colDevices.GetN ()) / 2;
+    if (prefix.GetPrefixLength () > 64)
+    {
+        NS_FATAL_ERROR ("Ipv6 pool has to be a /64 or larger.");
+    }
+    if (network.CombinePrefix (prefix) != network)
+    {
+        NS_FATAL_ERROR ("Ipv6 pool " << network << " is not aligned to its prefix.");
     }
 
-    for (uint32_t i = 0; i < m_nodes.size(); ++i)
+    // Link k owns base + 2k and base + 2k + 1; with a /64 or larger pool
+    // only the low 64 bits ever change
+    uint8_t bytes[16];
+    network.GetBytes (bytes);
+    uint64_t low = 0;
+    for (uint32_t i = 8; i < 16; ++i)
     {
-        Ipv4InterfaceContainer colInterfaces;
-        NetDeviceContainer colContainer = m_colDevices[i];
-        for (uint32_t j = 0; j < colContainer.GetN(); ++j)
+        low = (low << 8) | bytes[i];
+    }
+    // Each /127 has to start on an even id and the last one must not wrap
+    // past the interface id space
+    if (low & 1)
+    {
+        NS_FATAL_ERROR ("Ipv6 pool " << network << " does not start on a /127 boundary.");
+    }
+    if (low + 2*uint64_t (nLinks) < low)
+    {
+        NS_FATAL_ERROR ("Ipv6 pool too small for " << nLinks << " links.");
+    }
+
+    m_ipv6.assign (m_nodes.GetN (), Ipv6Address::GetAny ());
+    for (uint32_t k = 0; k < nLinks; ++k)
+    {
+        std::pair<Ptr<NetDevice>, Ptr<NetDevice> > link = GetLink (k);
+        for (uint32_t end = 0; end < 2; ++end)
         {
-            colInterfaces.Add (colIp.Assign (colContainer.Get(j)));
-            colInterfaces.Add (colIp.Assign (colContainer.Get(j+1)));
-            colIp.NewNetwork();
+            uint64_t id = low + 2*uint64_t (k) + end;
+            for (uint32_t i = 0; i < 8; ++i)
+            {
+                bytes[15 - i] = (id >> (8*i)) & 0xff;
+            }
+            Ipv6Address address (bytes);
+            Ptr<NetDevice> device = end ? link.second : link.first;
+            AddIpv6 (device, address);
+
+            Ipv6Address &reported = m_ipv6[GetIndex (device)];
+            if (reported.IsAny ())
+            {
+                reported = address;
+            }
         }
-        m_colInterfaces.push_back (colInterfaces);
     }
 }
 
@@ -149,7 +282,7 @@ PointToPointGrid_Helper::BoundingBox (double ulx, double uly,
             if (loc==0)
             {
                 loc = CreateObject<ConstantPositionMobilityModel> ();
-                loc->AggregateObject (loc);
+                node->AggregateObject (loc);
             }
             Vector locVector (xLoc, yLoc, 0);
             loc->SetPosition (locVector);
@@ -161,31 +294,57 @@ PointToPointGrid_Helper::BoundingBox (double ulx, double uly,
 }    
 
 Ptr<Node> 
-PointToPointGrid_Helper::GetNode (uint32_t row, uint32_t col)
+PointToPointGrid_Helper::GetNode (uint32_t row, uint32_t col) const
 {
-    if (row > m_nodes.size() - 1 ||
-        col > m_nodes.at(row).GetN() - 1)
+    if (row >= m_ySize || col >= m_xSize)
         {
             NS_FATAL_ERROR ("Selected Node out of bounds.");
         }
-    return ((m_nodes.at (row)).Get (col));
+    return m_nodes.Get (row * m_xSize + col);
+}
+
+NodeContainer
+PointToPointGrid_Helper::GetNodes (void) const
+{
+    return m_nodes;
+}
+
+NetDeviceContainer
+PointToPointGrid_Helper::GetRowDevices (void) const
+{
+    return m_rowDevices;
+}
+
+NetDeviceContainer
+PointToPointGrid_Helper::GetColDevices (void) const
+{
+    return m_colDevices;
 }
 
 Ipv4Address
-PointToPointGrid_Helper::GetIpv4Adress (uint32_t row, uint32_t col)
+PointToPointGrid_Helper::GetIpv4Adress (uint32_t row, uint32_t col) const
 {
-    if (row > m_nodes.size() - 1 ||
-        col > m_nodes.at(row).GetN() - 1)
+    if (row >= m_ySize || col >= m_xSize)
         {
             NS_FATAL_ERROR ("Selected Node out of bounds.");
         }
-    
-    if (col == 0)
-    {
-        return (m_rowInterfaces.at(row)).GetAddress(0);
-    }
-    else
-    {
-        return (m_rowInterfaces.at(row)).GetAddress((2*col)-1);
-    }
+    if (m_ipv4.empty ())
+        {
+            NS_FATAL_ERROR ("Ipv4 addresses have not been assigned.");
+        }
+    return m_ipv4[row * m_xSize + col];
+}
+
+Ipv6Address
+PointToPointGrid_Helper::GetIpv6Address (uint32_t row, uint32_t col) const
+{
+    if (row >= m_ySize || col >= m_xSize)
+        {
+            NS_FATAL_ERROR ("Selected Node out of bounds.");
+        }
+    if (m_ipv6.empty ())
+        {
+            NS_FATAL_ERROR ("Ipv6 addresses have not been assigned.");
+        }
+    return m_ipv6[row * m_xSize + col];
 }
@@ -1,16 +1,13 @@
 /**
  * @harshilbhatt2001 [Harshil Bhatt]
  * @create date 2020-06-22 23:03:55
- * 
- *      TODO:
- *          1. Add Ipv6 support
- *     
  */
 
 #ifndef P2P_HELPER_H
 #define P2P_HELPER_H
 
 
+#include <utility>
 #include <vector>
 
 #include "ns3/internet-stack-helper.h"
@@ -24,6 +21,22 @@
 
 using namespace ns3;
 
+/**
+ * Nodes and devices are kept in flat row-major containers,
+ * so every lookup is a single index computation:
+ *
+ *      node (r, c)                 m_nodes[r*nCols + c]
+ *      row link (r, c)-(r, c+1)    m_rowDevices[2*(r*(nCols-1) + c)], +1
+ *      col link (r, c)-(r+1, c)    m_colDevices[2*(r*nCols + c)], +1
+ *
+ * Addresses are handed out per link from a single pool, and the address
+ * reported for each node is kept in a flat per-node array.
+ *
+ * For the distributed simulator the rows can be split into nSystems
+ * contiguous blocks, block k getting system id (MPI rank) k. The links
+ * between two blocks then become PointToPointRemoteChannels and their
+ * delay is the lookahead of the ranks on either side.
+ */
 class PointToPointGrid_Helper 
 {
 public:
@@ -35,10 +48,13 @@ public:
      * 
      * \param pointToPoint PointToPointHelper which is used
      *                     connect all the nodes together in the grid.
+     *
+     * \param nSystems number of row blocks, one per rank, at most nRows
      */
     PointToPointGrid_Helper (uint32_t numRows,
                              uint32_t numCols,
-                             PointToPointHelper pointToPoint);
+                             PointToPointHelper pointToPoint,
+                             uint32_t nSystems = 1);
 
     ~PointToPointGrid_Helper();
 
@@ -52,7 +68,25 @@ public:
      * \returns Pointer to specified node
      */
 
-    Ptr<Node> GetNode (uint32_t row, uint32_t col);
+    Ptr<Node> GetNode (uint32_t row, uint32_t col) const;
+
+
+    /**
+     * \returns all nodes of the grid in row-major order
+     */
+    NodeContainer GetNodes (void) const;
+
+
+    /**
+     * \returns devices of the horizontal links, two per link
+     */
+    NetDeviceContainer GetRowDevices (void) const;
+
+
+    /**
+     * \returns devices of the vertical links, two per link
+     */
+    NetDeviceContainer GetColDevices (void) const;
 
 
     /**
@@ -65,26 +99,54 @@ public:
      * 
      * \returns Ipv4 Adress of one of the interfaces
      */
-    Ipv4Address GetIpv4Adress (uint32_t row, uint32_t col);
+    Ipv4Address GetIpv4Adress (uint32_t row, uint32_t col) const;
+
+
+    /**
+     * Returns Ipv6 address at node specified by (row, col)
+     * address
+     *
+     * \param row row address of desired node
+     *
+     * \param col column address of desired node
+     *
+     * \returns global Ipv6 Adress of one of the interfaces
+     */
+    Ipv6Address GetIpv6Address (uint32_t row, uint32_t col) const;
 
     
     /**
      * \param internet InternetStackHelper used to install
      *                 internet on every node
      */
-    void InstallInternet (InternetStackHelper internet);
+    void InstallInternet (const InternetStackHelper &internet);
     
 
     /**
-     *  Assign Ipv4 Address to row and column interfaces.
-     * 
-     * \param rowIp Ipv4AdressHelper to install assign Ipv4 adress
-     *              to row interface
-     * 
-     * \param colIp Ipv4AdressHelper to install assign Ipv4 adress
-     *              to column interface
+     *  Assign a /30 network to every link, row links first, taken in
+     *  order from one pool. Addresses are written straight into each
+     *  node's Ipv4 in a single pass and are not registered with the
+     *  global Ipv4AddressGenerator, so the pool must not overlap
+     *  networks handed out by an Ipv4AddressHelper.
+     *
+     * \param network first address of the pool, aligned to the pool mask
+     *
+     * \param mask mask of the pool, has to hold 4 addresses per link
      */
-    void AssignIpv4Adress (Ipv4AddressHelper rowIp, Ipv4AddressHelper colIp);
+    void AssignIpv4Adress (Ipv4Address network = Ipv4Address ("10.0.0.0"),
+                           Ipv4Mask mask = Ipv4Mask ("255.0.0.0"));
+
+
+    /**
+     *  Assign a /127 network to every link from one pool, in the same
+     *  order and with the same caveats as AssignIpv4Adress.
+     *
+     * \param network first address of the pool
+     *
+     * \param prefix prefix of the pool, at most /64
+     */
+    void AssignIpv6Address (Ipv6Address network = Ipv6Address ("2001:db8::"),
+                            Ipv6Prefix prefix = Ipv6Prefix (64));
 
     /**
      * Sets up the node canvas locations for every node in the grid,
@@ -98,13 +160,25 @@ public:
     void BoundingBox (double ulx, double uly, double lrx, double lry);
 
 private:
-    uint32_t m_xSize;   // no of rows
-    uint32_t m_ySize;   // no of cols
-    std::vector<NetDeviceContainer> m_rowDevices;   // NetDevices in row
-    std::vector<NetDeviceContainer> m_colDevices;   // NetDevices in col
-    std::vector<Ipv4InterfaceContainer> m_rowInterfaces;    // Ipv4 interfaces of row
-    std::vector<Ipv4InterfaceContainer> m_colInterfaces;    // Ipv4 interfaces of col
-    std::vector<NodeContainer> m_nodes;    // all nodes in grid 
+    /**
+     * \returns the two devices of link k, row links first
+     */
+    std::pair<Ptr<NetDevice>, Ptr<NetDevice> > GetLink (uint32_t k) const;
+
+    /**
+     * \returns flat index of the node that owns device
+     */
+    uint32_t GetIndex (Ptr<NetDevice> device) const;
+
+
+    uint32_t m_xSize;   // no of cols
+    uint32_t m_ySize;   // no of rows
+    NetDeviceContainer m_rowDevices;    // NetDevices of row links
+    NetDeviceContainer m_colDevices;    // NetDevices of col links
+    NodeContainer m_nodes;    // all nodes in grid, row-major 
+    uint32_t m_firstId;       // node id of (0, 0), the ids are consecutive
+    std::vector<Ipv4Address> m_ipv4;    // reported Ipv4 address per node
+    std::vector<Ipv6Address> m_ipv6;    // reported Ipv6 address per node
 
 
 
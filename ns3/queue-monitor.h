@@ -0,0 +1,172 @@
+/**
+ * @author Harshil Bhatt
+ * @create date 2026-10-19 23:58:40
+ * @desc
+ *      Sojourn time and occupancy of queue discs, for comparing AQMs on a
+ *      bottleneck.
+ *
+ *      Every dequeue's sojourn time (the queue disc's SojournTime trace)
+ *      goes into a log2 histogram with the bins of flow-stats-format.h, so
+ *      memory stays fixed however long the run is. Occupancy in packets
+ *      and bytes is sampled every Interval. Drops and marks come from the
+ *      queue disc's own statistics.
+ *
+ *          Ptr<QueueMonitor> monitor = Create<QueueMonitor> (MilliSeconds (10));
+ *          monitor->Install (discs.Get (0), "n2->n3");
+ *          monitor->Start (Seconds (0));
+ *          ...
+ *          monitor->Report (std::cout);
+ *
+ *      Sampling stops once nothing else is left in the event queue.
+ *      Packets waiting in the device queue below the disc are not seen.
+ */
+
+#ifndef QUEUE_MONITOR_H
+#define QUEUE_MONITOR_H
+
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "ns3/core-module.h"
+#include "ns3/traffic-control-module.h"
+
+#include "flow-stats-format.h"
+
+
+using namespace ns3;
+
+
+class QueueMonitor : public SimpleRefCount<QueueMonitor>
+{
+public:
+    QueueMonitor (Time interval)
+        : m_interval (interval)
+    {
+        NS_ABORT_MSG_IF (!interval.IsStrictlyPositive (), "Queue monitor interval must be positive");
+    }
+
+    void Install (Ptr<QueueDisc> disc, const std::string &name)
+    {
+        Entry e;
+        e.name = name;
+        e.disc = disc;
+        std::fill (e.sojournBins, e.sojournBins + FLOW_STATS_BINS, 0);
+        e.dequeued = 0;
+        e.sojournSum = 0;
+        e.maxSojourn = 0;
+        e.samples = 0;
+        e.packetSum = 0;
+        e.byteSum = 0;
+        e.maxPackets = 0;
+        e.maxBytes = 0;
+        m_entries.push_back (e);
+        disc->TraceConnectWithoutContext ("SojournTime",
+            MakeBoundCallback (&QueueMonitor::SojournTime, &m_entries, uint32_t (m_entries.size () - 1)));
+    }
+
+    void Install (QueueDiscContainer discs, const std::string &name)
+    {
+        for (uint32_t i = 0; i < discs.GetN (); ++i)
+        {
+            Install (discs.Get (i), discs.GetN () > 1 ? name + std::to_string (i) : name);
+        }
+    }
+
+    void Start (Time start)
+    {
+        Simulator::Cancel (m_event);
+        m_event = Simulator::Schedule (start, &QueueMonitor::Sample, this);
+    }
+
+    /**
+     * \returns q quantile of the sojourn time of queue i, upper bin edge
+     *          in microseconds
+     */
+    double GetSojournQuantile (uint32_t i, double q) const
+    {
+        return FlowStats::GetQuantile (m_entries[i].sojournBins, q);
+    }
+
+    void Report (std::ostream &os) const
+    {
+        os << std::left << std::setw (12) << "queue" << std::setw (22) << "disc" << std::right
+           << std::setw (10) << "dequeued" << std::setw (8) << "drops" << std::setw (8) << "marks"
+           << std::setw (10) << "avg pkts" << std::setw (10) << "max pkts" << std::setw (10) << "max KB"
+           << std::setw (12) << "sojourn ms" << std::setw (10) << "p50 ms" << std::setw (10) << "p99 ms"
+           << std::setw (10) << "max ms" << std::endl;
+        for (uint32_t i = 0; i < m_entries.size (); ++i)
+        {
+            const Entry &e = m_entries[i];
+            QueueDisc::Stats stats = e.disc->GetStats ();
+            os << std::left << std::setw (12) << e.name
+               << std::setw (22) << e.disc->GetInstanceTypeId ().GetName () << std::right
+               << std::setw (10) << e.dequeued
+               << std::setw (8) << stats.nTotalDroppedPackets
+               << std::setw (8) << stats.nTotalMarkedPackets
+               << std::fixed << std::setprecision (1)
+               << std::setw (10) << (e.samples ? double (e.packetSum) / e.samples : 0.0)
+               << std::setw (10) << e.maxPackets
+               << std::setw (10) << e.maxBytes / 1024.0
+               << std::setprecision (3)
+               << std::setw (12) << (e.dequeued ? e.sojournSum / 1e6 / e.dequeued : 0.0)
+               << std::setw (10) << GetSojournQuantile (i, 0.5) / 1e3
+               << std::setw (10) << GetSojournQuantile (i, 0.99) / 1e3
+               << std::setw (10) << e.maxSojourn / 1e6 << std::endl;
+            os.unsetf (std::ios::floatfield);
+        }
+    }
+
+private:
+    struct Entry
+    {
+        std::string name;
+        Ptr<QueueDisc> disc;
+        uint32_t sojournBins[FLOW_STATS_BINS];
+        uint64_t dequeued;
+        int64_t sojournSum;     // ns
+        int64_t maxSojourn;     // ns
+        uint64_t samples;
+        uint64_t packetSum;
+        uint64_t byteSum;
+        uint32_t maxPackets;
+        uint32_t maxBytes;
+    };
+
+    static void SojournTime (std::vector<Entry> *entries, uint32_t index, Time sojourn)
+    {
+        Entry &e = (*entries)[index];
+        int64_t ns = sojourn.GetNanoSeconds ();
+        ++e.sojournBins[FlowStats::GetBin (ns)];
+        ++e.dequeued;
+        e.sojournSum += ns;
+        e.maxSojourn = std::max (e.maxSojourn, ns);
+    }
+
+    void Sample (void)
+    {
+        for (Entry &e : m_entries)
+        {
+            uint32_t packets = e.disc->GetNPackets ();
+            uint32_t bytes = e.disc->GetNBytes ();
+            ++e.samples;
+            e.packetSum += packets;
+            e.byteSum += bytes;
+            e.maxPackets = std::max (e.maxPackets, packets);
+            e.maxBytes = std::max (e.maxBytes, bytes);
+        }
+        if (!Simulator::IsFinished ())
+        {
+            m_event = Simulator::Schedule (m_interval, &QueueMonitor::Sample, this);
+        }
+    }
+
+    Time m_interval;
+    std::vector<Entry> m_entries;
+    EventId m_event;
+};
+
+
+#endif /* QUEUE_MONITOR_H */
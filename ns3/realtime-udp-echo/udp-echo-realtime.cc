@@ -16,7 +16,8 @@
  *      
  *      UDP flows from n0 to n1 and back
  *      DropTail queues 
- *      Tracing of queues and packet receptions to file "udp-echo.tr"
+ *      Tracing of queues and packet receptions to the columnar trace
+ *      "realtime-udp-echo.ctr" (read it with columnar-trace-dump)
  */
 
 #include <fstream>
@@ -27,6 +28,7 @@
 #include "ns3/netanim-module.h"
 
 #include "Data.h"
+#include "../columnar-trace-helper.h"
 
 using namespace ns3;
 
@@ -154,8 +156,8 @@ Analyse (Data &data, CsmaHelper &csma)
 {
     if (data.trace)
     {
-    AsciiTraceHelper ascii;
-    csma.EnableAsciiAll (ascii.CreateFileStream ("trace/realtime-udp-echo/realtime-udp-echo.tr"));
+    ColumnarTraceHelper trace ("trace/realtime-udp-echo/realtime-udp-echo.ctr");
+    trace.InstallAll ();
     csma.EnablePcapAll ("trace/realtime-udp-echo/realtime-udp-echo", false);
     }
 
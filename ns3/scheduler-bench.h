@@ -0,0 +1,218 @@
+/**
+ * @author Harshil Bhatt
+ * @create date 2026-10-19 22:06:51
+ * @desc
+ *      Event scheduler benchmark and auto-selection.
+ *
+ *      The best scheduler depends on the shape of the event queue: a few
+ *      thousand periodic timers (OLSR hello/TC) favour Calendar or Heap,
+ *      a long tail of far-future events favours Map. This runs a scenario
+ *      once per scheduler and reports events per second and the peak
+ *      resident memory of each run.
+ *
+ *      The scenario is passed as a function that builds the topology and
+ *      applications (and may call Simulator::Stop) but does not run it.
+ *      Every run happens in a forked child, so each one starts from the
+ *      same untouched process and its memory use is its own; the caller
+ *      must not have built anything in the simulator before.
+ *
+ *      Usage:
+ *          void Build (void);      // builds the scenario
+ *          ...
+ *          if (bench)
+ *          {
+ *              SchedulerBench::Print (SchedulerBench::RunAll (&Build), std::cout);
+ *              return 0;
+ *          }
+ *          SchedulerBench::Configure (scheduler, &Build, Seconds (5));   // "auto" probes
+ *          Build ();
+ *          Simulator::Run ();
+ */
+
+#ifndef SCHEDULER_BENCH_H
+#define SCHEDULER_BENCH_H
+
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "ns3/core-module.h"
+
+#include "child-runner.h"
+
+
+using namespace ns3;
+
+
+struct SchedulerBenchResult
+{
+    std::string scheduler;      // short name, e.g. "Heap"
+    bool ok;                    // false if the run crashed
+    uint64_t events;
+    double wallSeconds;
+    double eventsPerSecond;
+    double peakMb;              // VmHWM of the run's process
+};
+
+
+class SchedulerBench
+{
+public:
+    typedef std::function<void (void)> Scenario;
+
+    /**
+     * \returns short names of the schedulers that ns-3 ships
+     */
+    static std::vector<std::string> GetSchedulers (void)
+    {
+        return std::vector<std::string> { "Map", "List", "Heap", "Calendar", "PriorityQueue" };
+    }
+
+    /**
+     * \param scheduler short name ("Heap") or full TypeId name
+     *                  ("ns3::HeapScheduler")
+     */
+    static std::string GetTypeName (const std::string &scheduler)
+    {
+        if (scheduler.compare (0, 5, "ns3::") == 0)
+        {
+            return scheduler;
+        }
+        return "ns3::" + scheduler + "Scheduler";
+    }
+
+    /**
+     * Build and run scenario under one scheduler in a child process
+     *
+     * \param limit stop the run after this much simulated time, zero
+     *              runs it to the scenario's own end
+     */
+    static SchedulerBenchResult Run (const std::string &scheduler, Scenario scenario,
+                                     Time limit = Time (0))
+    {
+        SchedulerBenchResult result = { scheduler, false, 0, 0, 0, 0 };
+        ChildRunner::Run (1, 1,
+            [&] (size_t)
+            {
+                ObjectFactory factory;
+                factory.SetTypeId (GetTypeName (scheduler));
+                Simulator::SetScheduler (factory);
+                scenario ();
+                if (!limit.IsZero ())
+                {
+                    Simulator::Stop (limit);
+                }
+
+                std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+                Simulator::Run ();
+                double wallSeconds = std::chrono::duration<double> (std::chrono::steady_clock::now () - start).count ();
+                double values[3] = { double (Simulator::GetEventCount ()), wallSeconds,
+                                     ReadStatusKb ("VmHWM") / 1024.0 };
+                Simulator::Destroy ();
+                return ChildRunner::Pack (values, 3);
+            },
+            [&] (size_t, bool ok, const std::string &bytes)
+            {
+                double values[3];
+                if (ok && ChildRunner::Unpack (bytes, values, 3))
+                {
+                    result.ok = true;
+                    result.events = uint64_t (values[0]);
+                    result.wallSeconds = values[1];
+                    result.peakMb = values[2];
+                    result.eventsPerSecond = result.wallSeconds > 0 ? result.events / result.wallSeconds : 0;
+                }
+            });
+        return result;
+    }
+
+    static std::vector<SchedulerBenchResult> RunAll (Scenario scenario, Time limit = Time (0),
+                                                     std::vector<std::string> schedulers = GetSchedulers ())
+    {
+        std::vector<SchedulerBenchResult> results;
+        for (const std::string &scheduler : schedulers)
+        {
+            results.push_back (Run (scheduler, scenario, limit));
+        }
+        return results;
+    }
+
+    static void Print (const std::vector<SchedulerBenchResult> &results, std::ostream &os)
+    {
+        os << std::left << std::setw (16) << "scheduler" << std::right
+           << std::setw (12) << "events"
+           << std::setw (10) << "wall s"
+           << std::setw (14) << "events/s"
+           << std::setw (10) << "peak MB" << std::endl;
+        for (const SchedulerBenchResult &r : results)
+        {
+            os << std::left << std::setw (16) << r.scheduler << std::right;
+            if (!r.ok)
+            {
+                os << "   failed" << std::endl;
+                continue;
+            }
+            os << std::setw (12) << r.events
+               << std::fixed << std::setprecision (3)
+               << std::setw (10) << r.wallSeconds
+               << std::setprecision (0)
+               << std::setw (14) << r.eventsPerSecond
+               << std::setprecision (1)
+               << std::setw (10) << r.peakMb << std::endl;
+            os.unsetf (std::ios::floatfield);
+        }
+    }
+
+    /**
+     * Probe every scheduler for warmup of simulated time
+     *
+     * \returns short name of the one with the highest events per second
+     */
+    static std::string PickBest (Scenario scenario, Time warmup)
+    {
+        std::vector<SchedulerBenchResult> results = RunAll (scenario, warmup);
+        std::string best = "Map";
+        double bestRate = 0;
+        for (const SchedulerBenchResult &r : results)
+        {
+            if (r.ok && r.eventsPerSecond > bestRate)
+            {
+                best = r.scheduler;
+                bestRate = r.eventsPerSecond;
+            }
+        }
+        return best;
+    }
+
+    /**
+     * Select the scheduler for this process, before the scenario is built
+     *
+     * \param scheduler short or TypeId name, "auto" to probe with
+     *                  PickBest, or empty to keep the default
+     *
+     * \returns short name of the scheduler in use
+     */
+    static std::string Configure (const std::string &scheduler, Scenario scenario, Time warmup)
+    {
+        if (scheduler.empty ())
+        {
+            return "Map";
+        }
+        std::string chosen = scheduler;
+        if (scheduler == "auto")
+        {
+            chosen = PickBest (scenario, warmup);
+            std::cout << "Scheduler auto-selection picked " << chosen << std::endl;
+        }
+        ObjectFactory factory;
+        factory.SetTypeId (GetTypeName (chosen));
+        Simulator::SetScheduler (factory);
+        return chosen;
+    }
+};
+
+
+#endif /* SCHEDULER_BENCH_H */
@@ -20,12 +20,23 @@
  *                    |     /
  *                    \    /
  *                    Source
+ *
+ *      --trie puts the routes into Ipv4TrieRouting (ipv4-trie-routing.h),
+ *      listed above Ipv4StaticRouting, instead of Ipv4StaticRouting.
+ *      --extraRoutes adds that many random prefixes (11/8 to 223/8, /16 to
+ *      /32, never matching the 10/8 traffic) to every node, the way a
+ *      router with a large table looks up; --burst sends that many more
+ *      packets from 4 s on and the run prints its wall-clock time. Compare
+ *      >> ./waf --run "scratch/<filename> --extraRoutes=50000 --burst=10000"
+ *      >> ./waf --run "scratch/<filename> --extraRoutes=50000 --burst=10000 --trie"
+ *      Per-packet logging is off with --burst.
 */
 
 #include <iostream>
 #include <fstream>
 #include <string>
 #include <cassert>
+#include <chrono>
 
 #include "ns3/core-module.h"
 #include "ns3/network-module.h"
@@ -35,6 +46,9 @@
 #include "ns3/ipv4-list-routing-helper.h"
 #include "ns3/netanim-module.h"
 
+#include "columnar-trace-helper.h"
+#include "ipv4-trie-routing.h"
+
 using namespace ns3;
 NS_LOG_COMPONENT_DEFINE("SocketBoundStaticRouting");
 
@@ -42,19 +56,29 @@ void SendStuff (Ptr<Socket> sock, Ipv4Address dstaddr, uint16_t port);
 void BindSock (Ptr<Socket> sock, Ptr<NetDevice> netdev);
 void srcSocketRecv(Ptr<Socket> socket);
 void dstSocketRecv(Ptr<Socket> socket);
+void AddHostRoute (bool trie, Ptr<Ipv4> ipv4, Ipv4Address dest, Ipv4Address nextHop,
+                   uint32_t interface, uint32_t metric = 0);
+void AddExtraRoutes (bool trie, Ptr<Ipv4> ipv4, Ipv4Address nextHop, uint32_t interface,
+                     uint32_t count, Ptr<UniformRandomVariable> random);
 
 int 
 main (int argc, char *argv[])
 {
     
     bool pcapTracing  = false;
-    bool asciiTracing = false;
+    bool packetTracing = false;
     bool netanim      = false;
+    bool trie         = false;
+    uint32_t extraRoutes = 0;
+    uint32_t burst    = 0;
 
     CommandLine cmd;
     cmd.AddValue("pcap",    "Enable Pcap tracing",  pcapTracing);
-    cmd.AddValue("ascii",   "Enable Ascii tracing", asciiTracing);
+    cmd.AddValue("trace",   "Enable columnar packet tracing", packetTracing);
     cmd.AddValue("netanim", "Enable NetAnim",       netanim);
+    cmd.AddValue("trie",    "Route with Ipv4TrieRouting instead of Ipv4StaticRouting", trie);
+    cmd.AddValue("extraRoutes", "Random prefixes added to every node's table", extraRoutes);
+    cmd.AddValue("burst",   "Extra packets sent from 4 s on, timed", burst);
     cmd.Parse(argc, argv);
 
     Ptr<Node> nSrc    = CreateObject<Node> ();
@@ -66,6 +90,16 @@ main (int argc, char *argv[])
     NodeContainer c = NodeContainer (nSrc, nDst, nRtr1, nRtr2, nDstRtr);
 
     InternetStackHelper internet;
+    if (trie)
+    {
+        // Static routing stays below it for anything the trie does not answer
+        Ipv4StaticRoutingHelper staticRouting;
+        Ipv4TrieRoutingHelper trieRouting;
+        Ipv4ListRoutingHelper list;
+        list.Add (staticRouting, 0);
+        list.Add (trieRouting, 10);
+        internet.SetRoutingHelper (list);
+    }
     internet.Install(c);
 
     //NS_LOG_INFO("Creating P2P links.");
@@ -110,26 +144,29 @@ main (int argc, char *argv[])
     Ptr<Ipv4> ipv4DstRtr = nDstRtr -> GetObject<Ipv4> ();
     Ptr<Ipv4> ipv4Dst    = nDst    -> GetObject<Ipv4> ();
 
-    Ipv4StaticRoutingHelper ipv4RoutingHelper;
-    Ptr<Ipv4StaticRouting> staticRoutingSrc    = ipv4RoutingHelper.GetStaticRouting(ipv4Src);
-    Ptr<Ipv4StaticRouting> staticRoutingRtr1   = ipv4RoutingHelper.GetStaticRouting(ipv4Rtr1);
-    Ptr<Ipv4StaticRouting> staticRoutingRtr2   = ipv4RoutingHelper.GetStaticRouting(ipv4Rtr2);
-    Ptr<Ipv4StaticRouting> staticRoutingDstRtr = ipv4RoutingHelper.GetStaticRouting(ipv4DstRtr);
-    Ptr<Ipv4StaticRouting> staticRoutingDst    = ipv4RoutingHelper.GetStaticRouting(ipv4Dst);
-
-
     // Create static routes from Src to Dst
-    staticRoutingRtr1->AddHostRouteTo (Ipv4Address ("10.20.1.2"), Ipv4Address ("10.10.1.2"), 2);
-    staticRoutingRtr2->AddHostRouteTo (Ipv4Address ("10.20.1.2"), Ipv4Address ("10.10.2.2"), 2);
+    AddHostRoute (trie, ipv4Rtr1, Ipv4Address ("10.20.1.2"), Ipv4Address ("10.10.1.2"), 2);
+    AddHostRoute (trie, ipv4Rtr2, Ipv4Address ("10.20.1.2"), Ipv4Address ("10.10.2.2"), 2);
 
     // Two routes to same destination - setting separate metrics. 
-    staticRoutingSrc->AddHostRouteTo (Ipv4Address ("10.20.1.2"), Ipv4Address ("10.1.1.2"), 1,5);
-    staticRoutingSrc->AddHostRouteTo (Ipv4Address ("10.20.1.2"), Ipv4Address ("10.1.2.2"), 2,10);
+    AddHostRoute (trie, ipv4Src, Ipv4Address ("10.20.1.2"), Ipv4Address ("10.1.1.2"), 1,5);
+    AddHostRoute (trie, ipv4Src, Ipv4Address ("10.20.1.2"), Ipv4Address ("10.1.2.2"), 2,10);
 
     // Creating static routes from DST to Source pointing to Rtr1 VIA Rtr2(!)
-    staticRoutingDst->AddHostRouteTo (Ipv4Address ("10.1.1.1"), Ipv4Address ("10.20.1.1"), 1);
-    staticRoutingDstRtr->AddHostRouteTo (Ipv4Address ("10.1.1.1"), Ipv4Address ("10.10.2.1"), 2);
-    staticRoutingRtr2->AddHostRouteTo (Ipv4Address ("10.1.1.1"), Ipv4Address ("10.1.2.1"), 1);
+    AddHostRoute (trie, ipv4Dst, Ipv4Address ("10.1.1.1"), Ipv4Address ("10.20.1.1"), 1);
+    AddHostRoute (trie, ipv4DstRtr, Ipv4Address ("10.1.1.1"), Ipv4Address ("10.10.2.1"), 2);
+    AddHostRoute (trie, ipv4Rtr2, Ipv4Address ("10.1.1.1"), Ipv4Address ("10.1.2.1"), 1);
+
+    // Large tables, out of interface 1 towards its neighbour
+    if (extraRoutes > 0)
+    {
+        Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+        AddExtraRoutes (trie, ipv4Src,    Ipv4Address ("10.1.1.2"),  1, extraRoutes, random);
+        AddExtraRoutes (trie, ipv4Rtr1,   Ipv4Address ("10.1.1.1"),  1, extraRoutes, random);
+        AddExtraRoutes (trie, ipv4Rtr2,   Ipv4Address ("10.1.2.1"),  1, extraRoutes, random);
+        AddExtraRoutes (trie, ipv4DstRtr, Ipv4Address ("10.10.1.1"), 1, extraRoutes, random);
+        AddExtraRoutes (trie, ipv4Dst,    Ipv4Address ("10.20.1.1"), 1, extraRoutes, random);
+    }
     
 
     // There are no apps that can utilize the Socket Option so doing the work directly..
@@ -145,11 +182,11 @@ main (int argc, char *argv[])
     dstSocket->Bind (dst);
     dstSocket->SetRecvCallback (MakeCallback (&dstSocketRecv));
 
-    if (asciiTracing)
+    if (packetTracing)
     {
-        AsciiTraceHelper ascii;
-        p2p.EnableAsciiAll(ascii.CreateFileStream("trace/socket-static-routing/socket-bound-static-routing.tr"));
-        NS_LOG_INFO("Generated ascii trace file");
+        ColumnarTraceHelper trace ("trace/socket-static-routing/socket-bound-static-routing.ctr");
+        trace.InstallAll ();
+        NS_LOG_INFO("Generated columnar trace file");
     }
 
     if (pcapTracing)
@@ -164,8 +201,11 @@ main (int argc, char *argv[])
         AnimationInterface anim ("NetAnim_Simulation_Files/socket-static-routing.xml");
     }
 
-    LogComponentEnableAll (LOG_PREFIX_TIME);
-    LogComponentEnable ("SocketBoundStaticRouting", LOG_LEVEL_INFO);
+    if (burst == 0)
+    {
+        LogComponentEnableAll (LOG_PREFIX_TIME);
+        LogComponentEnable ("SocketBoundStaticRouting", LOG_LEVEL_INFO);
+    }
 
     // First packet as normal (goes via Rtr1)
     Simulator::Schedule (Seconds (0.1),&SendStuff, srcSocket, dstaddr, dstport);
@@ -178,13 +218,76 @@ main (int argc, char *argv[])
     // Fourth again as normal (goes via Rtr1)
     Simulator::Schedule (Seconds (3.0),&BindSock, srcSocket, Ptr<NetDevice>(0));
     Simulator::Schedule (Seconds (3.1),&SendStuff, srcSocket, dstaddr, dstport);
+    // Then the burst, 1 ms apart, each echoed back by the destination
+    for (uint32_t i = 0; i < burst; ++i)
+    {
+        Simulator::Schedule (Seconds (4.0) + MilliSeconds (i), &SendStuff, srcSocket, dstaddr, dstport);
+    }
 
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
     Simulator::Run();
+    double wall = std::chrono::duration<double> (std::chrono::steady_clock::now () - start).count ();
+    if (burst > 0 || extraRoutes > 0)
+    {
+        std::cout << (trie ? "Ipv4TrieRouting" : "Ipv4StaticRouting") << ", " << extraRoutes
+                  << " extra routes per node, " << burst << " burst packets: "
+                  << Simulator::GetEventCount () << " events in " << wall << " s wall" << std::endl;
+    }
     Simulator::Destroy();
 
     return 0;
 }
 
+void
+AddHostRoute (bool trie, Ptr<Ipv4> ipv4, Ipv4Address dest, Ipv4Address nextHop, uint32_t interface, uint32_t metric)
+{
+    if (trie)
+    {
+        Ipv4TrieRoutingHelper::GetTrieRouting (ipv4)->AddHostRouteTo (dest, nextHop, interface, metric);
+    }
+    else
+    {
+        Ipv4StaticRoutingHelper ipv4RoutingHelper;
+        ipv4RoutingHelper.GetStaticRouting (ipv4)->AddHostRouteTo (dest, nextHop, interface, metric);
+    }
+}
+
+void
+AddExtraRoutes (bool trie, Ptr<Ipv4> ipv4, Ipv4Address nextHop, uint32_t interface,
+                uint32_t count, Ptr<UniformRandomVariable> random)
+{
+    Ptr<Ipv4TrieRouting> trieRouting;
+    Ptr<Ipv4StaticRouting> staticRouting;
+    if (trie)
+    {
+        trieRouting = Ipv4TrieRoutingHelper::GetTrieRouting (ipv4);
+    }
+    else
+    {
+        Ipv4StaticRoutingHelper ipv4RoutingHelper;
+        staticRouting = ipv4RoutingHelper.GetStaticRouting (ipv4);
+    }
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        uint32_t first = random->GetInteger (11, 223);
+        if (first == 127)
+        {
+            first = 128;
+        }
+        uint32_t length = random->GetInteger (16, 32);
+        Ipv4Address network ((first << 24) | random->GetInteger (0, 0xffffff));
+        Ipv4Mask mask (length == 32 ? 0xffffffff : ~(0xffffffffu >> length));
+        if (trie)
+        {
+            trieRouting->AddNetworkRouteTo (network, mask, nextHop, interface);
+        }
+        else
+        {
+            staticRouting->AddNetworkRouteTo (network.CombineMask (mask), mask, nextHop, interface);
+        }
+    }
+}
+
 void 
 SendStuff (Ptr<Socket> sock, Ipv4Address dstaddr, uint16_t port)
 {
@@ -15,6 +15,15 @@
  *            /|\      
  *           / | \     
  *          n8 n7 n6   
+ *
+ *      Scheduler options
+ *      >> ./waf --run "scratch/star --nSpokes=200 --benchScheduler"
+ *          runs the scenario once under each event scheduler and prints
+ *          events/s and peak memory
+ *      >> ./waf --run "scratch/star --nSpokes=200 --scheduler=auto"
+ *          probes every scheduler for --warmup seconds of simulated time
+ *          and runs with the fastest (or name one: Map, List, Heap,
+ *          Calendar, PriorityQueue)
  */
 
 #include "ns3/core-module.h"
@@ -24,11 +33,14 @@
 #include "ns3/applications-module.h"
 #include "ns3/point-to-point-layout-module.h"
 #include "ns3/netanim-module.h"
+#include "scheduler-bench.h"
 
 using namespace ns3;
 
 NS_LOG_COMPONENT_DEFINE("Star-Topo");
 
+void BuildStar (uint32_t nSpokes, bool tracing);
+
 int 
 main (int argc, char *argv[])
 {
@@ -38,13 +50,46 @@ main (int argc, char *argv[])
     bool tracing = false;
 	bool netanim = false;
     uint32_t nSpokes = 8;
+    std::string scheduler = "";
+    bool benchScheduler = false;
+    double warmup = 2.0;
     
     CommandLine cmd;
 	cmd.AddValue("tracing", "Enable Pcap tracing", tracing);
 	cmd.AddValue("netanim", "Enable NetAnim", netanim);
     cmd.AddValue("nSpokes", "Number of nodes in star", nSpokes);
+    cmd.AddValue("scheduler", "Event scheduler: Map, List, Heap, Calendar, PriorityQueue or auto", scheduler);
+    cmd.AddValue("benchScheduler", "Run under every scheduler and compare", benchScheduler);
+    cmd.AddValue("warmup", "Simulated seconds each scheduler is probed for with --scheduler=auto", warmup);
     cmd.Parse(argc, argv);
 
+    // Probe runs never write traces
+    SchedulerBench::Scenario probe = [nSpokes] () { BuildStar (nSpokes, false); };
+    if (benchScheduler)
+    {
+        SchedulerBench::Print (SchedulerBench::RunAll (probe), std::cout);
+        return 0;
+    }
+    SchedulerBench::Configure (scheduler, probe, Seconds (warmup));
+
+    BuildStar (nSpokes, tracing);
+
+	// Not Working
+	if (netanim)
+	{
+		AnimationInterface anim("NetAnim_Simulation_Files/star/star.xml");
+	}
+
+    NS_LOG_INFO ("Run Simulation.");
+    Simulator::Run ();
+    Simulator::Destroy ();
+    NS_LOG_INFO ("Done.");
+    return 0;
+}
+
+void
+BuildStar (uint32_t nSpokes, bool tracing)
+{
     NS_LOG_INFO("Building Star Topology.");
     PointToPointHelper pointToPoint;
     pointToPoint.SetDeviceAttribute("DataRate", StringValue("5Mbps"));
@@ -84,7 +129,7 @@ main (int argc, char *argv[])
         spokeApps.Add(onOffHelper.Install(star.GetSpokeNode(i)));
     }
     spokeApps.Start(Seconds(1.0));
-    spokeApps.Stop(Seconds(1.0));
+    spokeApps.Stop(Seconds(10.0));
     NS_LOG_INFO("Finished Creating Applications.");
 
     NS_LOG_INFO("Enabling Global Static Routing.");
@@ -95,16 +140,4 @@ main (int argc, char *argv[])
 	{
     	pointToPoint.EnablePcapAll ("trace/star/star");
 	}
-
-	// Not Working
-	if (netanim)
-	{
-		AnimationInterface anim("NetAnim_Simulation_Files/star/star.xml");
-	}
-
-    NS_LOG_INFO ("Run Simulation.");
-    Simulator::Run ();
-    Simulator::Destroy ();
-    NS_LOG_INFO ("Done.");
-    return 0;
 }
\ No newline at end of file
@@ -0,0 +1,439 @@
+/*
+Created on Mon Oct 19 19:31:48 2026
+@author: Harshil Bhatt
+*/
+
+
+/*  Parallel parameter sweep driver for the ns-3 scenarios.
+
+    Runs every combination of the given parameter values, times the number
+    of replicates (--RngRun=1..n), as separate processes spread over all
+    local cores. Each run gets its own directory under the work directory,
+    so the traces the scenarios write with relative paths (trace/...,
+    NetAnim_Simulation_Files/...) never collide.
+
+    When everything has finished the results are gathered into one
+    tab separated file, one row per run:
+
+        run  status  seconds  <parameters...>  RngRun  <metrics...>
+
+    Metrics are taken from the lines a scenario prints as "name: number",
+    e.g. "Average throughput: 52.3 Mbit/s" becomes Average_throughput.
+    Files named with -c (cwnd series, flow stats CSVs, ...) are read from
+    every run directory and their numeric rows are appended to one long
+    format series file as  run  file  <columns...>.
+
+    waf holds a lock while it runs, so build once and sweep the binary
+    from inside "./waf shell" (which sets the library path):
+
+        ./waf build && ./waf shell
+        g++ -O2 -std=c++17 -o sweep-runner scratch/sweep-runner.cpp
+        ./sweep-runner -x build/scratch/wifi-tcp/wifi-tcp \
+            -P tcpVariant=TcpNewReno,TcpCubic,TcpWestwoodPlus \
+            -P dataRate=50Mbps,100Mbps -P phyRate=HtMcs3,HtMcs7 -r 10 \
+            -m trace -o wifi-tcp.tsv
+        ./sweep-runner -x "build/scratch/TcpCongestion --binaryTrace=false" \
+            -m trace/TcpCongestion -c trace/TcpCongestion/TcpCongestion.cwnd -r 20
+
+    TcpCongestion writes binary traces by default; --binaryTrace=false
+    gives -c the ascii cwnd file to read, otherwise convert each run's
+    TcpCongestion.cwnd.bin with binary-trace-convert first.
+
+    Numeric ranges can be given as name=start:stop:step.
+*/
+
+#include <bits/stdc++.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+using namespace std;
+
+
+class Param {
+    public:
+        string name;
+        vector<string> values;
+};
+
+
+class Run {
+    public:
+        int id;
+        vector<string> values;      // one per Param, then the RngRun
+        string dir;
+        pid_t pid = -1;
+        double start = 0;
+        double seconds = 0;
+        string status = "pending";
+        vector<pair<string, string>> metrics;
+};
+
+
+static double nowSeconds() {
+    return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+static bool isNumber(const string &s) {
+    if (s.empty())
+        return false;
+    char *end;
+    strtod(s.c_str(), &end);
+    return *end == '\0';
+}
+
+
+static string formatNumber(double v) {
+    char buff[32];
+    snprintf(buff, sizeof(buff), "%g", v);
+    return buff;
+}
+
+
+// name=a,b,c  or  name=start:stop:step
+static bool parseParam(const string &spec, Param &p) {
+    size_t eq = spec.find('=');
+    if (eq == string::npos || eq == 0)
+        return false;
+    p.name = spec.substr(0, eq);
+    string list = spec.substr(eq + 1);
+
+    vector<string> range;
+    stringstream rs(list);
+    string item;
+    while (getline(rs, item, ':'))
+        range.push_back(item);
+    if (range.size() == 3 && isNumber(range[0]) && isNumber(range[1]) && isNumber(range[2])) {
+        double start = stod(range[0]), stop = stod(range[1]), step = stod(range[2]);
+        if (step <= 0)
+            return false;
+        for (double v = start; v <= stop + step * 1e-9; v += step)
+            p.values.push_back(formatNumber(v));
+        return true;
+    }
+
+    stringstream ss(list);
+    while (getline(ss, item, ','))
+        if (!item.empty())
+            p.values.push_back(item);
+    return !p.values.empty();
+}
+
+
+static void makeDirs(const string &path) {
+    for (size_t i = 1; i <= path.size(); ++i)
+        if (i == path.size() || path[i] == '/')
+            mkdir(path.substr(0, i).c_str(), 0755);
+}
+
+
+static vector<string> splitWords(const string &s) {
+    vector<string> words;
+    stringstream ss(s);
+    string w;
+    while (ss >> w)
+        words.push_back(w);
+    return words;
+}
+
+
+class Sweep {
+    public:
+        vector<string> command;
+        vector<Param> params;
+        int replicates = 1;
+        int jobs = 1;
+        double timeout = 0;
+        string workdir = "sweep";
+        vector<string> mkdirs;
+        vector<string> collect;
+
+        void plan();
+        void execute();
+        void writeResults(const string &path);
+        void writeSeries(const string &path);
+
+        vector<Run> runs;
+
+    private:
+        void launch(Run &r);
+        void finish(Run &r, int status);
+        void parseMetrics(Run &r);
+};
+
+
+// Cartesian product of all parameter values, replicates innermost
+void Sweep::plan() {
+    size_t total = replicates;
+    for (const Param &p : params)
+        total *= p.values.size();
+
+    vector<size_t> digit(params.size(), 0);
+    for (size_t n = 0; n < total; ++n) {
+        size_t rest = n / replicates;
+        Run r;
+        r.id = n;
+        for (int i = params.size() - 1; i >= 0; --i) {
+            digit[i] = rest % params[i].values.size();
+            rest /= params[i].values.size();
+        }
+        for (size_t i = 0; i < params.size(); ++i)
+            r.values.push_back(params[i].values[digit[i]]);
+        r.values.push_back(to_string(n % replicates + 1));
+
+        char name[32];
+        snprintf(name, sizeof(name), "/run-%05zu", n);
+        r.dir = workdir + name;
+        runs.push_back(r);
+    }
+}
+
+
+void Sweep::launch(Run &r) {
+    makeDirs(r.dir);
+    for (const string &d : mkdirs)
+        makeDirs(r.dir + "/" + d);
+
+    vector<string> args = command;
+    for (size_t i = 0; i < params.size(); ++i)
+        args.push_back("--" + params[i].name + "=" + r.values[i]);
+    args.push_back("--RngRun=" + r.values.back());
+
+    r.start = nowSeconds();
+    r.pid = fork();
+    if (r.pid < 0) {
+        perror("fork");
+        exit(1);
+    }
+    if (r.pid == 0) {
+        if (chdir(r.dir.c_str()) != 0)
+            _exit(127);
+        int out = open("stdout.txt", O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        int err = open("stderr.txt", O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        dup2(out, STDOUT_FILENO);
+        dup2(err, STDERR_FILENO);
+        close(out);
+        close(err);
+        setpgid(0, 0);      // lets a timeout take down the whole run
+
+        vector<char *> argv;
+        for (string &a : args)
+            argv.push_back(&a[0]);
+        argv.push_back(NULL);
+        execvp(argv[0], argv.data());
+        perror("execvp");
+        _exit(127);
+    }
+    r.status = "running";
+}
+
+
+void Sweep::finish(Run &r, int status) {
+    r.seconds = nowSeconds() - r.start;
+    r.pid = -1;
+    if (r.status == "timeout")
+        ;
+    else if (WIFEXITED(status))
+        r.status = WEXITSTATUS(status) == 0 ? "ok" : "exit" + to_string(WEXITSTATUS(status));
+    else if (WIFSIGNALED(status))
+        r.status = string("signal") + to_string(WTERMSIG(status));
+    parseMetrics(r);
+}
+
+
+// "Average throughput: 52.3 Mbit/s" -> Average_throughput = 52.3
+void Sweep::parseMetrics(Run &r) {
+    ifstream in(r.dir + "/stdout.txt");
+    string line;
+    map<string, size_t> seen;
+    while (getline(in, line)) {
+        size_t colon = line.find(':');
+        if (colon == string::npos)
+            continue;
+        string key = line.substr(0, colon);
+        key.erase(0, key.find_first_not_of(" \t"));
+        key.erase(key.find_last_not_of(" \t") + 1);
+        if (key.empty() || !isalpha((unsigned char)key[0]))
+            continue;
+        vector<string> rest = splitWords(line.substr(colon + 1));
+        if (rest.empty() || !isNumber(rest[0]))
+            continue;
+        for (char &c : key)
+            if (isspace((unsigned char)c) || c == '\t')
+                c = '_';
+
+        // A repeated name keeps its last value
+        auto it = seen.find(key);
+        if (it != seen.end())
+            r.metrics[it->second].second = rest[0];
+        else {
+            seen[key] = r.metrics.size();
+            r.metrics.push_back({key, rest[0]});
+        }
+    }
+}
+
+
+void Sweep::execute() {
+    size_t next = 0, done = 0;
+    map<pid_t, size_t> running;
+
+    while (done < runs.size()) {
+        while (running.size() < (size_t)jobs && next < runs.size()) {
+            launch(runs[next]);
+            running[runs[next].pid] = next;
+            ++next;
+        }
+
+        int status;
+        pid_t pid = waitpid(-1, &status, timeout > 0 ? WNOHANG : 0);
+        if (pid > 0 && running.count(pid)) {
+            Run &r = runs[running[pid]];
+            running.erase(pid);
+            finish(r, status);
+            ++done;
+            fprintf(stderr, "[%zu/%zu] run %d %s (%.1f s)\n", done, runs.size(), r.id,
+                    r.status.c_str(), r.seconds);
+            continue;
+        }
+
+        if (timeout > 0) {
+            double now = nowSeconds();
+            for (auto &it : running) {
+                Run &r = runs[it.second];
+                if (r.status == "running" && now - r.start > timeout) {
+                    r.status = "timeout";
+                    kill(-r.pid, SIGKILL);
+                }
+            }
+            usleep(20000);
+        }
+    }
+}
+
+
+void Sweep::writeResults(const string &path) {
+    // Metric columns in order of first appearance over all runs
+    vector<string> columns;
+    set<string> known;
+    for (const Run &r : runs)
+        for (const auto &m : r.metrics)
+            if (known.insert(m.first).second)
+                columns.push_back(m.first);
+
+    ofstream out(path);
+    out << "run\tstatus\tseconds";
+    for (const Param &p : params)
+        out << "\t" << p.name;
+    out << "\tRngRun";
+    for (const string &c : columns)
+        out << "\t" << c;
+    out << "\n";
+
+    for (const Run &r : runs) {
+        out << r.id << "\t" << r.status << "\t" << formatNumber(r.seconds);
+        for (const string &v : r.values)
+            out << "\t" << v;
+        map<string, string> values(r.metrics.begin(), r.metrics.end());
+        for (const string &c : columns) {
+            auto it = values.find(c);
+            out << "\t" << (it == values.end() ? "NA" : it->second);
+        }
+        out << "\n";
+    }
+}
+
+
+// Numeric rows only, so headers and comments in the collected files are skipped
+void Sweep::writeSeries(const string &path) {
+    ofstream out(path);
+    out << "run\tfile\tcolumns...\n";
+    for (const Run &r : runs) {
+        for (const string &name : collect) {
+            ifstream in(r.dir + "/" + name);
+            string line;
+            while (getline(in, line)) {
+                for (char &c : line)
+                    if (c == ',' || c == ';')
+                        c = ' ';
+                vector<string> fields = splitWords(line);
+                if (fields.empty() || !all_of(fields.begin(), fields.end(), isNumber))
+                    continue;
+                out << r.id << "\t" << name;
+                for (const string &f : fields)
+                    out << "\t" << f;
+                out << "\n";
+            }
+        }
+    }
+}
+
+
+int main(int argc, char *argv[]) {
+    Sweep sweep;
+    sweep.jobs = max(1L, sysconf(_SC_NPROCESSORS_ONLN));
+    string output = "results.tsv";
+    string series = "series.tsv";
+    string program;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "x:P:r:j:t:d:m:c:o:s:")) != -1) {
+        switch (opt) {
+            case 'x': program = optarg; break;
+            case 'P': {
+                Param p;
+                if (!parseParam(optarg, p)) {
+                    fprintf(stderr, "Bad parameter '%s'\n", optarg);
+                    return 1;
+                }
+                sweep.params.push_back(p);
+                break;
+            }
+            case 'r': sweep.replicates = max(1, atoi(optarg)); break;
+            case 'j': sweep.jobs = max(1, atoi(optarg)); break;
+            case 't': sweep.timeout = atof(optarg); break;
+            case 'd': sweep.workdir = optarg; break;
+            case 'm': sweep.mkdirs.push_back(optarg); break;
+            case 'c': sweep.collect.push_back(optarg); break;
+            case 'o': output = optarg; break;
+            case 's': series = optarg; break;
+            default: break;
+        }
+    }
+
+    if (program.empty()) {
+        fprintf(stderr, "Script Usage: %s -x <scenario binary [fixed args]> [-P name=v1,v2 | name=start:stop:step]... "
+                        "[-r replicates] [-j jobs] [-t timeout s] [-d workdir] [-m run subdir]... "
+                        "[-c collected file]... [-o results.tsv] [-s series.tsv]\n", argv[0]);
+        return 1;
+    }
+
+    // Runs execute inside their own directories
+    sweep.command = splitWords(program);
+    if (sweep.command[0].find('/') != string::npos) {
+        char *abs = realpath(sweep.command[0].c_str(), NULL);
+        if (abs == NULL) {
+            fprintf(stderr, "Cannot find %s\n", sweep.command[0].c_str());
+            return 1;
+        }
+        sweep.command[0] = abs;
+        free(abs);
+    }
+
+    makeDirs(sweep.workdir);
+    sweep.plan();
+    fprintf(stderr, "%zu runs on %d workers\n", sweep.runs.size(), sweep.jobs);
+
+    double start = nowSeconds();
+    sweep.execute();
+    sweep.writeResults(output);
+    if (!sweep.collect.empty())
+        sweep.writeSeries(series);
+
+    size_t ok = count_if(sweep.runs.begin(), sweep.runs.end(), [](const Run &r) { return r.status == "ok"; });
+    fprintf(stderr, "%zu/%zu runs ok in %.1f s, results in %s\n", ok, sweep.runs.size(),
+            nowSeconds() - start, output.c_str());
+    return ok == sweep.runs.size() ? 0 : 1;
+}
@@ -0,0 +1,489 @@
+/**
+ * @author Harshil Bhatt
+ * @create date 2026-10-19 23:41:12
+ * @desc
+ *      Place the file in ./scratch/ directory and build using
+ *      >> ./waf --run scratch/<filename>
+ *      Run the following for user input via command line
+ *      >> ./waf --run "scratch/<filename> --PrintHelp"
+ *
+ *
+ *      ===========================================================================
+ *
+ *         s0 ---+                                   +--- r0
+ *         s1 ---+-- R0 ------------------------ R1 -+--- r1
+ *          ..   |        --bandwidth, --rtt/2       |    ..
+ *         sN-1 -+      FIFO of --buffer x BDP       +--- rN-1
+ *                     random loss --loss on R1
+ *
+ *       Congestion control comparison on a dumbbell. N bulk TCP flows
+ *       (TxDrivenSender, saturating), flow i from si to ri, share the R0-R1
+ *       bottleneck; access links are ten times faster with no delay, so
+ *       --rtt is the base RTT. Flows start --stagger seconds apart and all
+ *       stop at --duration.
+ *
+ *       Every combination of --bandwidth, --rtt and --loss (comma separated
+ *       lists) is run once per variant in --variants, all N flows using
+ *       that variant. With --mix the variants instead share one dumbbell,
+ *       flow i running variant i mod #variants, to see how they compete.
+ *       Variants this ns-3 build does not have are skipped.
+ *
+ *       Per variant and combination:
+ *          goodput     sum over the flows, and as a share of the bottleneck
+ *          RTT x       mean of the senders' RTT samples (the socket's "RTT"
+ *                      trace, the latest sample, not the smoothed RTT)
+ *                      over the base RTT, i.e. how much queue the variant
+ *                      keeps
+ *          retrans     retransmitted data segments (and % of all sent)
+ *          jain        Jain's fairness index over the flows' goodputs
+ *       With --mix an extra "all" row covers every flow of the run.
+ *
+ *       Each run is a forked child (--jobs at a time) so every one starts
+ *       from a clean simulator. --csv prints comma separated rows.
+ *
+ *       >> ./waf --run "scratch/tcp-cc-harness --flows=4 --bandwidth=10Mbps,100Mbps
+ *                       --rtt=20ms,100ms --loss=0,0.001 --jobs=8"
+ *      ===========================================================================
+ */
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/applications-module.h"
+#include "ns3/traffic-control-module.h"
+
+#include "throughput-probe.h"
+#include "child-runner.h"
+#include "tx-driven-sender.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("TcpCcHarness");
+
+
+struct HarnessConfig
+{
+    uint32_t flows;
+    std::string bandwidth;
+    std::string rtt;
+    double loss;
+    double buffer;          // bottleneck queue in BDPs
+    double duration;
+    double stagger;
+    uint32_t segmentSize;
+};
+
+
+/* What a child sends back per flow */
+struct FlowResult
+{
+    uint32_t variant;       // index into the variant list
+    double goodput;         // bit/s
+    double meanRtt;         // seconds, mean of the RTT samples
+    uint64_t retransmits;
+    uint64_t segments;
+};
+
+
+struct FlowState
+{
+    Ptr<PacketSink> sink;
+    double start;
+    bool sent;
+    SequenceNumber32 highTx;
+    double rttSum;
+    uint64_t rttSamples;
+    uint64_t retransmits;
+    uint64_t segments;
+};
+
+
+static std::vector<std::string>
+Split (const std::string &list)
+{
+    std::vector<std::string> items;
+    std::stringstream ss (list);
+    std::string item;
+    while (std::getline (ss, item, ','))
+    {
+        if (!item.empty ())
+        {
+            items.push_back (item);
+        }
+    }
+    return items;
+}
+
+
+/* TcpWestwoodPlus is TcpWestwood with another ProtocolType, not a TypeId */
+static bool
+LookupVariant (const std::string &name, ObjectFactory &factory)
+{
+    std::string typeName = name == "TcpWestwoodPlus" ? "ns3::TcpWestwood" : "ns3::" + name;
+    TypeId tid;
+    if (!TypeId::LookupByNameFailSafe (typeName, &tid))
+    {
+        return false;
+    }
+    factory.SetTypeId (tid);
+    if (name == "TcpWestwoodPlus")
+    {
+        factory.Set ("ProtocolType", EnumValue (TcpWestwood::WESTWOODPLUS));
+    }
+    return true;
+}
+
+
+/* Data segments sent below the highest sequence already sent are retransmissions */
+static void
+SegmentSent (FlowState *flow, Ptr<const Packet> packet, const TcpHeader &header, Ptr<const TcpSocketBase> socket)
+{
+    if (packet->GetSize () == 0)
+    {
+        return;
+    }
+    ++flow->segments;
+    SequenceNumber32 seq = header.GetSequenceNumber ();
+    if (flow->sent && seq < flow->highTx)
+    {
+        ++flow->retransmits;
+        return;
+    }
+    flow->highTx = seq + packet->GetSize ();
+    flow->sent = true;
+}
+
+
+static void
+RttChanged (FlowState *flow, Time oldRtt, Time newRtt)
+{
+    flow->rttSum += newRtt.GetSeconds ();
+    ++flow->rttSamples;
+}
+
+
+/**
+ * Build the dumbbell, run it and return one result per flow
+ *
+ * \param flowVariant variant index of every flow
+ */
+std::vector<FlowResult>
+RunDumbbell (const HarnessConfig &config, const std::vector<std::string> &variants,
+             const std::vector<uint32_t> &flowVariant)
+{
+    uint32_t n = config.flows;
+    DataRate bandwidth (config.bandwidth);
+    Time rtt (config.rtt);
+
+    // the bottleneck holds buffer x BDP, the socket buffers must not be
+    // what limits the flows
+    double bdp = bandwidth.GetBitRate () * rtt.GetSeconds () / 8;
+    uint32_t queuePackets = std::max (uint32_t (config.buffer * bdp / (config.segmentSize + 52)), 2u);
+    uint32_t socketBuffer = std::max (uint32_t (4 * bdp + queuePackets * config.segmentSize), 131072u);
+    Config::SetDefault ("ns3::TcpSocket::SegmentSize", UintegerValue (config.segmentSize));
+    Config::SetDefault ("ns3::TcpSocket::SndBufSize", UintegerValue (socketBuffer));
+    Config::SetDefault ("ns3::TcpSocket::RcvBufSize", UintegerValue (socketBuffer));
+    if (std::find (variants.begin (), variants.end (), "TcpBbr") != variants.end ())
+    {
+        // BBR needs pacing; older releases have neither
+        Config::SetDefaultFailSafe ("ns3::TcpSocketState::EnablePacing", BooleanValue (true));
+    }
+
+    NodeContainer routers;
+    routers.Create (2);
+    NodeContainer senders;
+    senders.Create (n);
+    NodeContainer receivers;
+    receivers.Create (n);
+    InternetStackHelper stack;
+    stack.InstallAll ();
+
+    PointToPointHelper bottleneck;
+    bottleneck.SetDeviceAttribute ("DataRate", DataRateValue (bandwidth));
+    bottleneck.SetChannelAttribute ("Delay", TimeValue (Seconds (rtt.GetSeconds () / 2)));
+    bottleneck.SetQueue ("ns3::DropTailQueue<Packet>", "MaxSize", StringValue ("1p"));
+    NetDeviceContainer core = bottleneck.Install (routers);
+
+    TrafficControlHelper tch;
+    tch.SetRootQueueDisc ("ns3::FifoQueueDisc", "MaxSize", StringValue (std::to_string (queuePackets) + "p"));
+    tch.Install (core);
+
+    if (config.loss > 0)
+    {
+        Ptr<RateErrorModel> em = CreateObject<RateErrorModel> ();
+        em->SetAttribute ("ErrorRate", DoubleValue (config.loss));
+        em->SetAttribute ("ErrorUnit", EnumValue (RateErrorModel::ERROR_UNIT_PACKET));
+        core.Get (1)->SetAttribute ("ReceiveErrorModel", PointerValue (em));
+    }
+
+    PointToPointHelper access;
+    access.SetDeviceAttribute ("DataRate", DataRateValue (DataRate (bandwidth.GetBitRate () * 10)));
+    access.SetChannelAttribute ("Delay", TimeValue (Seconds (0)));
+
+    Ipv4AddressHelper address;
+    address.SetBase ("10.0.0.0", "255.255.255.252");
+    address.Assign (core);
+    address.SetBase ("10.1.0.0", "255.255.255.252");
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        address.Assign (access.Install (senders.Get (i), routers.Get (0)));
+        address.NewNetwork ();
+    }
+    std::vector<Ipv4Address> receiverAddress;
+    address.SetBase ("10.2.0.0", "255.255.255.252");
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        Ipv4InterfaceContainer interfaces = address.Assign (access.Install (receivers.Get (i), routers.Get (1)));
+        receiverAddress.push_back (interfaces.GetAddress (0));
+        address.NewNetwork ();
+    }
+    Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+
+    uint16_t port = 5000;
+    PacketSinkHelper sinkHelper ("ns3::TcpSocketFactory", InetSocketAddress (Ipv4Address::GetAny (), port));
+    ApplicationContainer sinkApps = sinkHelper.Install (receivers);
+    sinkApps.Start (Seconds (0));
+
+    std::vector<ObjectFactory> factories (variants.size ());
+    for (uint32_t v = 0; v < variants.size (); ++v)
+    {
+        LookupVariant (variants[v], factories[v]);
+    }
+
+    // the traces hold pointers into flows, it must not reallocate
+    std::vector<FlowState> flows (n);
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        FlowState &flow = flows[i];
+        flow.sink = StaticCast<PacketSink> (sinkApps.Get (i));
+        flow.start = 1.0 + i * config.stagger;
+        flow.sent = false;
+        flow.rttSum = 0;
+        flow.rttSamples = 0;
+        flow.retransmits = 0;
+        flow.segments = 0;
+
+        Ptr<Socket> socket = Socket::CreateSocket (senders.Get (i), TcpSocketFactory::GetTypeId ());
+        DynamicCast<TcpSocketBase> (socket)->SetCongestionControlAlgorithm (
+            factories[flowVariant[i]].Create<TcpCongestionOps> ());
+        socket->TraceConnectWithoutContext ("Tx", MakeBoundCallback (&SegmentSent, &flow));
+        socket->TraceConnectWithoutContext ("RTT", MakeBoundCallback (&RttChanged, &flow));
+
+        Ptr<TxDrivenSender> app = CreateObject<TxDrivenSender> ();
+        app->Setup (socket, InetSocketAddress (receiverAddress[i], port), config.segmentSize, 0);
+        senders.Get (i)->AddApplication (app);
+        app->SetStartTime (Seconds (flow.start));
+        app->SetStopTime (Seconds (config.duration));
+    }
+
+    Simulator::Stop (Seconds (config.duration));
+    Simulator::Run ();
+
+    std::vector<FlowResult> results;
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        const FlowState &flow = flows[i];
+        FlowResult r;
+        r.variant = flowVariant[i];
+        r.goodput = flow.sink->GetTotalRx () * 8.0 / (config.duration - flow.start);
+        r.meanRtt = flow.rttSamples ? flow.rttSum / flow.rttSamples : 0;
+        r.retransmits = flow.retransmits;
+        r.segments = flow.segments;
+        results.push_back (r);
+    }
+    Simulator::Destroy ();
+    return results;
+}
+
+
+struct Run
+{
+    HarnessConfig config;
+    std::vector<std::string> variants;      // the ones sharing the dumbbell
+    bool ok;
+    std::vector<FlowResult> results;
+};
+
+
+/* Runs every entry in a forked child, jobs at a time */
+void
+RunAll (std::vector<Run> &runs, uint32_t jobs)
+{
+    ChildRunner::Run (runs.size (), jobs,
+        [&] (size_t index)
+        {
+            const Run &run = runs[index];
+            std::vector<uint32_t> flowVariant;
+            for (uint32_t i = 0; i < run.config.flows; ++i)
+            {
+                flowVariant.push_back (i % run.variants.size ());
+            }
+            std::vector<FlowResult> results = RunDumbbell (run.config, run.variants, flowVariant);
+            return ChildRunner::Pack (results.data (), results.size ());
+        },
+        [&] (size_t index, bool ok, const std::string &bytes)
+        {
+            Run &run = runs[index];
+            run.results.resize (run.config.flows);
+            run.ok = ok && ChildRunner::Unpack (bytes, run.results.data (), run.results.size ());
+        });
+}
+
+
+void
+PrintRun (const Run &run, bool csv)
+{
+    const HarnessConfig &c = run.config;
+    double base = Time (c.rtt).GetSeconds ();
+    double capacity = DataRate (c.bandwidth).GetBitRate ();
+    // with several variants the last pass covers every flow
+    uint32_t passes = run.variants.size () > 1 ? run.variants.size () + 1 : 1;
+    for (uint32_t v = 0; v < passes; ++v)
+    {
+        bool all = v == run.variants.size ();
+        double goodput = 0;
+        double rtt = 0;
+        uint64_t retransmits = 0;
+        uint64_t segments = 0;
+        std::vector<double> share;
+        for (const FlowResult &r : run.results)
+        {
+            if (!all && r.variant != v)
+            {
+                continue;
+            }
+            goodput += r.goodput;
+            rtt += r.meanRtt;
+            retransmits += r.retransmits;
+            segments += r.segments;
+            share.push_back (r.goodput);
+        }
+        std::string name = all ? "all(mix)" : run.variants[v] + (run.variants.size () > 1 ? "(mix)" : "");
+        double inflation = share.empty () ? 0 : rtt / share.size () / base;
+        double retxPercent = segments ? 100.0 * retransmits / segments : 0;
+        if (csv)
+        {
+            std::cout << name << "," << c.bandwidth << "," << c.rtt << "," << c.loss << "," << share.size ()
+                      << "," << run.ok << "," << goodput / 1e6 << "," << 100 * goodput / capacity << ","
+                      << inflation << "," << retransmits << "," << retxPercent << "," << JainIndex (share) << std::endl;
+            continue;
+        }
+        std::cout << std::left << std::setw (18) << name << std::right << std::setw (10) << c.bandwidth
+                  << std::setw (8) << c.rtt << std::setw (9) << c.loss << std::setw (6) << share.size ();
+        if (!run.ok)
+        {
+            std::cout << std::setw (12) << "failed" << std::endl;
+            continue;
+        }
+        std::cout << std::fixed << std::setprecision (2)
+                  << std::setw (12) << goodput / 1e6 << std::setw (8) << 100 * goodput / capacity
+                  << std::setw (8) << inflation << std::setw (10) << retransmits << std::setw (8) << retxPercent
+                  << std::setprecision (3) << std::setw (8) << JainIndex (share) << std::endl;
+        std::cout.unsetf (std::ios::floatfield);
+    }
+}
+
+
+int
+main (int argc, char *argv[])
+{
+    std::string variantList = "TcpNewReno,TcpCubic,TcpBbr,TcpVegas,TcpWestwoodPlus,TcpBic,TcpHtcp,TcpIllinois";
+    std::string bandwidths = "10Mbps";
+    std::string rtts = "40ms";
+    std::string losses = "0";
+    HarnessConfig config;
+    config.flows = 4;
+    config.buffer = 1.0;
+    config.duration = 30;
+    config.stagger = 0.5;
+    config.segmentSize = 1448;
+    bool mix = false;
+    bool csv = false;
+    uint32_t jobs = 1;
+
+    CommandLine cmd;
+    cmd.AddValue ("variants", "Comma separated TCP variants, e.g. TcpNewReno,TcpCubic,TcpBbr", variantList);
+    cmd.AddValue ("flows", "Competing flows on the dumbbell", config.flows);
+    cmd.AddValue ("bandwidth", "Comma separated bottleneck rates", bandwidths);
+    cmd.AddValue ("rtt", "Comma separated base RTTs", rtts);
+    cmd.AddValue ("loss", "Comma separated random packet loss rates on the bottleneck", losses);
+    cmd.AddValue ("buffer", "Bottleneck queue in bandwidth-delay products", config.buffer);
+    cmd.AddValue ("duration", "Seconds simulated per run", config.duration);
+    cmd.AddValue ("stagger", "Seconds between flow starts", config.stagger);
+    cmd.AddValue ("segmentSize", "TCP segment size in bytes", config.segmentSize);
+    cmd.AddValue ("mix", "Run all variants together on one dumbbell", mix);
+    cmd.AddValue ("jobs", "Runs in parallel", jobs);
+    cmd.AddValue ("csv", "Print comma separated rows", csv);
+    cmd.Parse (argc, argv);
+    NS_ABORT_MSG_IF (config.flows < 1 || config.flows > 1000, "flows must be between 1 and 1000");
+    NS_ABORT_MSG_IF (1.0 + (config.flows - 1) * config.stagger >= config.duration,
+                     "The last flow starts after the run ends");
+
+    std::vector<std::string> variants;
+    for (const std::string &name : Split (variantList))
+    {
+        ObjectFactory factory;
+        if (LookupVariant (name, factory))
+        {
+            variants.push_back (name);
+        }
+        else
+        {
+            std::cout << "Skipping " << name << ": not in this ns-3 build" << std::endl;
+        }
+    }
+    NS_ABORT_MSG_IF (variants.empty (), "No usable TCP variant");
+
+    std::vector<Run> runs;
+    for (const std::string &bandwidth : Split (bandwidths))
+    {
+        for (const std::string &rtt : Split (rtts))
+        {
+            for (const std::string &loss : Split (losses))
+            {
+                Run run;
+                run.config = config;
+                run.config.bandwidth = bandwidth;
+                run.config.rtt = rtt;
+                run.config.loss = std::stod (loss);
+                run.ok = false;
+                if (mix)
+                {
+                    run.variants = variants;
+                    runs.push_back (run);
+                    continue;
+                }
+                for (const std::string &variant : variants)
+                {
+                    run.variants = std::vector<std::string> (1, variant);
+                    runs.push_back (run);
+                }
+            }
+        }
+    }
+
+    RunAll (runs, jobs);
+
+    if (csv)
+    {
+        std::cout << "variant,bandwidth,rtt,loss,flows,ok,goodput_mbps,utilization,rtt_inflation,"
+                     "retransmits,retransmit_percent,jain" << std::endl;
+    }
+    else
+    {
+        std::cout << std::left << std::setw (18) << "variant" << std::right << std::setw (10) << "bandwidth"
+                  << std::setw (8) << "rtt" << std::setw (9) << "loss" << std::setw (6) << "flows"
+                  << std::setw (12) << "Mbit/s" << std::setw (8) << "util %" << std::setw (8) << "RTT x"
+                  << std::setw (10) << "retrans" << std::setw (8) << "retx %" << std::setw (8) << "jain" << std::endl;
+    }
+    for (const Run &run : runs)
+    {
+        PrintRun (run, csv);
+    }
+    return 0;
+}
@@ -0,0 +1,273 @@
+/**
+ * @author Harshil Bhatt
+ * @create date 2026-10-19 23:56:12
+ * @desc
+ *      Windowed throughput sampler for any number of receivers.
+ *
+ *      One timer samples every series each Interval. A series is a
+ *      received-bytes counter, usually a PacketSink's GetTotalRx; the
+ *      difference since the previous sample, divided by the interval,
+ *      goes into the series' ring buffer of the last Capacity samples
+ *      (allocated up front). Kept up to date at every sample:
+ *          - the moving average over the last Window samples
+ *          - the mean over the whole run
+ *      Percentiles are computed over the ring when asked for. Nothing is
+ *      printed while the simulation runs; call Report () at the end.
+ *      GetJainIndex () gives Jain's fairness index over the series means.
+ *
+ *      Usage:
+ *          Ptr<ThroughputProbe> probe = Create<ThroughputProbe> (MilliSeconds (100));
+ *          probe->Add (sink, "sta0");
+ *          probe->Start (Seconds (1.0));
+ *          ...
+ *          Simulator::Run ();
+ *          probe->Report (std::cout);
+ */
+
+#ifndef THROUGHPUT_PROBE_H
+#define THROUGHPUT_PROBE_H
+
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "ns3/core-module.h"
+#include "ns3/packet-sink.h"
+
+
+using namespace ns3;
+
+
+/**
+ * Jain's fairness index (sum x)^2 / (n * sum x^2): 1 when every share is
+ * equal, 1/n when one takes everything
+ */
+inline double
+JainIndex (const std::vector<double> &x)
+{
+    double sum = 0;
+    double squares = 0;
+    for (double v : x)
+    {
+        sum += v;
+        squares += v * v;
+    }
+    return squares > 0 ? sum * sum / (x.size () * squares) : 1;
+}
+
+
+class ThroughputProbe : public SimpleRefCount<ThroughputProbe>
+{
+public:
+    /**
+     * \param interval time between samples
+     *
+     * \param capacity samples kept per series for percentiles
+     *
+     * \param window samples in the moving average
+     */
+    ThroughputProbe (Time interval, uint32_t capacity = 1024, uint32_t window = 10)
+        : m_interval (interval),
+          m_capacity (std::max (capacity, window)),
+          m_window (std::max (window, 1u))
+    {
+        NS_ABORT_MSG_IF (!interval.IsStrictlyPositive (), "Throughput probe interval must be positive");
+    }
+
+    /**
+     * \param totalRx returns the bytes received so far
+     *
+     * \returns index of the new series
+     */
+    uint32_t Add (Callback<uint64_t> totalRx, const std::string &name)
+    {
+        Series s;
+        s.name = name;
+        s.totalRx = totalRx;
+        s.lastBytes = 0;
+        s.samples.assign (m_capacity, 0);
+        s.head = 0;
+        s.count = 0;
+        s.windowSum = 0;
+        s.sum = 0;
+        s.n = 0;
+        m_series.push_back (s);
+        return m_series.size () - 1;
+    }
+
+    uint32_t Add (Ptr<PacketSink> sink, const std::string &name)
+    {
+        return Add (MakeCallback (&PacketSink::GetTotalRx, sink), name);
+    }
+
+    /**
+     * Take the baseline at start and sample every interval after it
+     */
+    void Start (Time start)
+    {
+        Simulator::Cancel (m_event);
+        m_event = Simulator::Schedule (start, &ThroughputProbe::Begin, this);
+    }
+
+    void Stop (void)
+    {
+        Simulator::Cancel (m_event);
+    }
+
+    uint32_t GetN (void) const
+    {
+        return m_series.size ();
+    }
+
+    const std::string &GetName (uint32_t i) const
+    {
+        return m_series[i].name;
+    }
+
+    /**
+     * \returns samples taken of series i, including ones that have left
+     *          the ring
+     */
+    uint64_t GetSamples (uint32_t i) const
+    {
+        return m_series[i].n;
+    }
+
+    /**
+     * \returns latest sample in bit/s
+     */
+    double GetLast (uint32_t i) const
+    {
+        const Series &s = m_series[i];
+        return s.count ? s.samples[(s.head + m_capacity - 1) % m_capacity] : 0;
+    }
+
+    /**
+     * \returns bit/s averaged over the last Window samples
+     */
+    double GetMovingAverage (uint32_t i) const
+    {
+        const Series &s = m_series[i];
+        uint32_t n = std::min (s.count, m_window);
+        return n ? s.windowSum / n : 0;
+    }
+
+    /**
+     * \returns bit/s averaged over every sample
+     */
+    double GetMean (uint32_t i) const
+    {
+        const Series &s = m_series[i];
+        return s.n ? s.sum / s.n : 0;
+    }
+
+    /**
+     * \returns q quantile (0..1) of the samples still in the ring, bit/s
+     */
+    double GetPercentile (uint32_t i, double q) const
+    {
+        const Series &s = m_series[i];
+        if (s.count == 0)
+        {
+            return 0;
+        }
+        m_scratch.assign (s.samples.begin (), s.samples.begin () + s.count);
+        size_t k = std::min<size_t> (s.count - 1, size_t (q * (s.count - 1) + 0.5));
+        std::nth_element (m_scratch.begin (), m_scratch.begin () + k, m_scratch.end ());
+        return m_scratch[k];
+    }
+
+    /**
+     * \returns Jain's fairness index over the mean of every series
+     */
+    double GetJainIndex (void) const
+    {
+        std::vector<double> means;
+        for (uint32_t i = 0; i < m_series.size (); ++i)
+        {
+            means.push_back (GetMean (i));
+        }
+        return JainIndex (means);
+    }
+
+    void Report (std::ostream &os) const
+    {
+        os << std::left << std::setw (12) << "series" << std::right
+           << std::setw (10) << "samples"
+           << std::setw (12) << "mean"
+           << std::setw (12) << "moving"
+           << std::setw (12) << "p5"
+           << std::setw (12) << "p50"
+           << std::setw (12) << "p95" << "   (Mbit/s)" << std::endl;
+        for (uint32_t i = 0; i < m_series.size (); ++i)
+        {
+            os << std::left << std::setw (12) << m_series[i].name << std::right
+               << std::setw (10) << GetSamples (i)
+               << std::fixed << std::setprecision (3)
+               << std::setw (12) << GetMean (i) / 1e6
+               << std::setw (12) << GetMovingAverage (i) / 1e6
+               << std::setw (12) << GetPercentile (i, 0.05) / 1e6
+               << std::setw (12) << GetPercentile (i, 0.5) / 1e6
+               << std::setw (12) << GetPercentile (i, 0.95) / 1e6 << std::endl;
+            os.unsetf (std::ios::floatfield);
+        }
+    }
+
+private:
+    struct Series
+    {
+        std::string name;
+        Callback<uint64_t> totalRx;
+        uint64_t lastBytes;
+        std::vector<double> samples;    // ring of bit/s
+        uint32_t head;                  // next slot to write
+        uint32_t count;                 // valid samples in the ring
+        double windowSum;               // of the last m_window samples
+        double sum;                     // of every sample
+        uint64_t n;
+    };
+
+    void Begin (void)
+    {
+        for (Series &s : m_series)
+        {
+            s.lastBytes = s.totalRx ();
+        }
+        m_event = Simulator::Schedule (m_interval, &ThroughputProbe::Sample, this);
+    }
+
+    void Sample (void)
+    {
+        double seconds = m_interval.GetSeconds ();
+        for (Series &s : m_series)
+        {
+            uint64_t bytes = s.totalRx ();
+            double rate = (bytes - s.lastBytes) * 8.0 / seconds;
+            s.lastBytes = bytes;
+
+            if (s.count >= m_window)
+            {
+                s.windowSum -= s.samples[(s.head + m_capacity - m_window) % m_capacity];
+            }
+            s.windowSum += rate;
+            s.samples[s.head] = rate;
+            s.head = (s.head + 1) % m_capacity;
+            s.count = std::min (s.count + 1, m_capacity);
+            s.sum += rate;
+            ++s.n;
+        }
+        m_event = Simulator::Schedule (m_interval, &ThroughputProbe::Sample, this);
+    }
+
+    Time m_interval;
+    uint32_t m_capacity;
+    uint32_t m_window;
+    std::vector<Series> m_series;
+    EventId m_event;
+    mutable std::vector<double> m_scratch;
+};
+
+
+#endif /* THROUGHPUT_PROBE_H */
@@ -0,0 +1,479 @@
+/**
+ * @author Harshil Bhatt
+ * @create date 2026-10-19 22:52:18
+ * @desc
+ *      Traffic generator and sink applications with per-flow statistics.
+ *
+ *      TrafficGenerator sends on a socket it is given (already bound or
+ *      connected by the scenario) using a single timer per flow. Modes:
+ *          Cbr         one packet every Interval
+ *          Poisson     exponential gaps with mean Interval
+ *          OnOff       Cbr during OnTime periods, silent for OffTime
+ *          Trace       replays "<seconds> <bytes>" lines from TraceFile,
+ *                      times relative to the application start
+ *      Every packet starts with a TrafficHeader (flow id, sequence number,
+ *      send time), so the sink can count each flow and measure its delay
+ *      without any per-flow state on the sending side.
+ *
+ *      TrafficSink reads every packet from its socket and keeps, per
+ *      flow, packets and bytes received, packets lost (gaps in the
+ *      sequence numbers) and a log2 histogram of the one-way delay, with
+ *      the bins of flow-stats-format.h.
+ *
+ *      Both have the "Tx" / "Rx" trace sources of OnOffApplication and
+ *      PacketSink, so per-packet tools can hook either kind of flow.
+ *
+ *      Usage:
+ *          Ptr<TrafficSink> sink = CreateObject<TrafficSink> ();
+ *          sink->Setup (recvSocket);
+ *          nodes.Get (0)->AddApplication (sink);
+ *
+ *          Ptr<TrafficGenerator> gen = CreateObject<TrafficGenerator> ();
+ *          gen->Setup (sendSocket, 1);         // flow id 1
+ *          gen->SetAttribute ("Mode", StringValue ("Poisson"));
+ *          nodes.Get (1)->AddApplication (gen);
+ *          ...
+ *          Simulator::Run ();
+ *          sink->Report (std::cout);
+ */
+
+#ifndef TRAFFIC_GENERATOR_H
+#define TRAFFIC_GENERATOR_H
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+
+#include "flow-stats-format.h"
+
+
+using namespace ns3;
+
+
+class TrafficHeader : public Header
+{
+public:
+    static TypeId GetTypeId (void)
+    {
+        static TypeId tid = TypeId ("TrafficHeader")
+            .SetParent<Header> ()
+            .AddConstructor<TrafficHeader> ();
+        return tid;
+    }
+
+    TrafficHeader ()
+        : m_flowId (0), m_seq (0), m_txTime (0)
+    {
+    }
+
+    void SetFlowId (uint32_t flowId)    { m_flowId = flowId; }
+    void SetSeq (uint32_t seq)          { m_seq = seq; }
+    void SetTxTime (Time txTime)        { m_txTime = txTime.GetNanoSeconds (); }
+    uint32_t GetFlowId (void) const     { return m_flowId; }
+    uint32_t GetSeq (void) const        { return m_seq; }
+    Time GetTxTime (void) const         { return NanoSeconds (m_txTime); }
+
+    virtual TypeId GetInstanceTypeId (void) const
+    {
+        return GetTypeId ();
+    }
+
+    virtual uint32_t GetSerializedSize (void) const
+    {
+        return 16;
+    }
+
+    virtual void Serialize (Buffer::Iterator start) const
+    {
+        start.WriteHtonU32 (m_flowId);
+        start.WriteHtonU32 (m_seq);
+        start.WriteHtonU64 (m_txTime);
+    }
+
+    virtual uint32_t Deserialize (Buffer::Iterator start)
+    {
+        m_flowId = start.ReadNtohU32 ();
+        m_seq = start.ReadNtohU32 ();
+        m_txTime = start.ReadNtohU64 ();
+        return GetSerializedSize ();
+    }
+
+    virtual void Print (std::ostream &os) const
+    {
+        os << "flow=" << m_flowId << " seq=" << m_seq << " tx=" << m_txTime << "ns";
+    }
+
+private:
+    uint32_t m_flowId;
+    uint32_t m_seq;
+    uint64_t m_txTime;      // ns
+};
+
+
+class TrafficGenerator : public Application
+{
+public:
+    enum Mode
+    {
+        CBR,
+        POISSON,
+        ONOFF,
+        TRACE
+    };
+
+    static TypeId GetTypeId (void)
+    {
+        static TypeId tid = TypeId ("TrafficGenerator")
+            .SetParent<Application> ()
+            .AddConstructor<TrafficGenerator> ()
+            .AddAttribute ("Mode", "Cbr, Poisson, OnOff or Trace.",
+                           EnumValue (CBR),
+                           MakeEnumAccessor (&TrafficGenerator::m_mode),
+                           MakeEnumChecker (CBR, "Cbr", POISSON, "Poisson",
+                                            ONOFF, "OnOff", TRACE, "Trace"))
+            .AddAttribute ("PacketSize", "Bytes per packet, header included.",
+                           UintegerValue (1000),
+                           MakeUintegerAccessor (&TrafficGenerator::m_packetSize),
+                           MakeUintegerChecker<uint32_t> ())
+            .AddAttribute ("Interval", "Gap between packets, the mean gap for Poisson.",
+                           TimeValue (Seconds (1.0)),
+                           MakeTimeAccessor (&TrafficGenerator::m_interval),
+                           MakeTimeChecker ())
+            .AddAttribute ("MaxPackets", "Packets to send, 0 for no limit.",
+                           UintegerValue (0),
+                           MakeUintegerAccessor (&TrafficGenerator::m_maxPackets),
+                           MakeUintegerChecker<uint32_t> ())
+            .AddAttribute ("OnTime", "Seconds of each on period (OnOff).",
+                           StringValue ("ns3::ExponentialRandomVariable[Mean=1.0]"),
+                           MakePointerAccessor (&TrafficGenerator::m_onTime),
+                           MakePointerChecker<RandomVariableStream> ())
+            .AddAttribute ("OffTime", "Seconds of each off period (OnOff).",
+                           StringValue ("ns3::ExponentialRandomVariable[Mean=1.0]"),
+                           MakePointerAccessor (&TrafficGenerator::m_offTime),
+                           MakePointerChecker<RandomVariableStream> ())
+            .AddAttribute ("TraceFile", "\"<seconds> <bytes>\" per line (Trace).",
+                           StringValue (""),
+                           MakeStringAccessor (&TrafficGenerator::m_traceFile),
+                           MakeStringChecker ())
+            .AddTraceSource ("Tx", "A packet has been sent.",
+                             MakeTraceSourceAccessor (&TrafficGenerator::m_txTrace),
+                             "ns3::Packet::TracedCallback");
+        return tid;
+    }
+
+    TrafficGenerator ()
+        : m_flowId (0), m_seq (0), m_next (0), m_sentPackets (0), m_sentBytes (0)
+    {
+        m_gap = CreateObject<ExponentialRandomVariable> ();
+    }
+
+    /**
+     * \param socket bound and connected socket to send on
+     *
+     * \param flowId written into every packet
+     */
+    void Setup (Ptr<Socket> socket, uint32_t flowId)
+    {
+        m_socket = socket;
+        m_flowId = flowId;
+    }
+
+    uint64_t GetSentPackets (void) const
+    {
+        return m_sentPackets;
+    }
+
+    uint64_t GetSentBytes (void) const
+    {
+        return m_sentBytes;
+    }
+
+private:
+    struct TraceRecord
+    {
+        Time at;        // from the application start
+        uint32_t size;
+    };
+
+    virtual void DoDispose (void)
+    {
+        m_socket = 0;
+        Application::DoDispose ();
+    }
+
+    virtual void StartApplication (void)
+    {
+        m_start = Simulator::Now ();
+        m_next = 0;
+        if (m_mode == TRACE)
+        {
+            LoadTrace ();
+            if (!m_trace.empty ())
+            {
+                m_sendEvent = Simulator::Schedule (m_trace[0].at, &TrafficGenerator::SendNext, this);
+            }
+            return;
+        }
+        if (m_mode == ONOFF)
+        {
+            m_onEnd = Simulator::Now () + Seconds (m_onTime->GetValue ());
+        }
+        SendNext ();
+    }
+
+    virtual void StopApplication (void)
+    {
+        Simulator::Cancel (m_sendEvent);
+        if (m_socket)
+        {
+            m_socket->Close ();
+        }
+    }
+
+    void LoadTrace (void)
+    {
+        m_trace.clear ();
+        std::ifstream in (m_traceFile.c_str ());
+        if (!in)
+        {
+            NS_FATAL_ERROR ("Cannot open traffic trace " << m_traceFile);
+        }
+        double at;
+        uint32_t size;
+        while (in >> at >> size)
+        {
+            TraceRecord r = { Seconds (at), size };
+            m_trace.push_back (r);
+        }
+    }
+
+    void SendNext (void)
+    {
+        uint32_t size = m_mode == TRACE ? m_trace[m_next].size : m_packetSize;
+        Send (size);
+        ++m_next;
+        if (m_maxPackets > 0 && m_sentPackets >= m_maxPackets)
+        {
+            return;
+        }
+
+        Time delay;
+        switch (m_mode)
+        {
+            case CBR:
+                delay = m_interval;
+                break;
+            case POISSON:
+                delay = Seconds (m_gap->GetValue (m_interval.GetSeconds (), 0));
+                break;
+            case ONOFF:
+                delay = m_interval;
+                if (Simulator::Now () + delay >= m_onEnd)
+                {
+                    // Skip to the start of the next on period
+                    Time on = m_onEnd + Seconds (m_offTime->GetValue ());
+                    m_onEnd = on + Seconds (m_onTime->GetValue ());
+                    delay = on - Simulator::Now ();
+                }
+                break;
+            case TRACE:
+                if (m_next >= m_trace.size ())
+                {
+                    return;
+                }
+                delay = m_start + m_trace[m_next].at - Simulator::Now ();
+                break;
+        }
+        m_sendEvent = Simulator::Schedule (delay, &TrafficGenerator::SendNext, this);
+    }
+
+    void Send (uint32_t size)
+    {
+        TrafficHeader header;
+        header.SetFlowId (m_flowId);
+        header.SetSeq (m_seq);
+        header.SetTxTime (Simulator::Now ());
+        Ptr<Packet> packet = Create<Packet> (size > header.GetSerializedSize () ? size - header.GetSerializedSize () : 0);
+        packet->AddHeader (header);
+        if (m_socket->Send (packet) >= 0)
+        {
+            m_txTrace (packet);
+            ++m_sentPackets;
+            m_sentBytes += packet->GetSize ();
+        }
+        // A failed send still uses up its sequence number, the sink counts it lost
+        ++m_seq;
+    }
+
+    Ptr<Socket> m_socket;
+    uint32_t m_flowId;
+
+    Mode m_mode;
+    uint32_t m_packetSize;
+    Time m_interval;
+    uint32_t m_maxPackets;
+    Ptr<RandomVariableStream> m_onTime;
+    Ptr<RandomVariableStream> m_offTime;
+    std::string m_traceFile;
+
+    Ptr<ExponentialRandomVariable> m_gap;
+    std::vector<TraceRecord> m_trace;
+    EventId m_sendEvent;
+    Time m_start;
+    Time m_onEnd;
+    uint32_t m_seq;
+    size_t m_next;              // index of the next packet
+    uint64_t m_sentPackets;
+    uint64_t m_sentBytes;
+    TracedCallback<Ptr<const Packet> > m_txTrace;
+};
+
+
+class TrafficSink : public Application
+{
+public:
+    struct FlowStats
+    {
+        uint64_t rxPackets;
+        uint64_t rxBytes;
+        uint64_t lost;              // sequence numbers skipped
+        uint32_t nextSeq;
+        Time delaySum;
+        Time minDelay;
+        Time maxDelay;
+        uint32_t delayBins[FLOW_STATS_BINS];     // see ::FlowStats::GetBin
+    };
+
+    static TypeId GetTypeId (void)
+    {
+        static TypeId tid = TypeId ("TrafficSink")
+            .SetParent<Application> ()
+            .AddConstructor<TrafficSink> ()
+            .AddTraceSource ("Rx", "A packet has been received.",
+                             MakeTraceSourceAccessor (&TrafficSink::m_rxTrace),
+                             "ns3::Packet::AddressTracedCallback");
+        return tid;
+    }
+
+    /**
+     * \param socket bound socket to read from
+     */
+    void Setup (Ptr<Socket> socket)
+    {
+        m_socket = socket;
+    }
+
+    /**
+     * \returns statistics of flowId, or null if nothing arrived from it
+     */
+    const FlowStats *GetFlow (uint32_t flowId) const
+    {
+        std::unordered_map<uint32_t, FlowStats>::const_iterator it = m_flows.find (flowId);
+        return it == m_flows.end () ? 0 : &it->second;
+    }
+
+    void Report (std::ostream &os) const
+    {
+        std::vector<uint32_t> ids;
+        for (const std::pair<const uint32_t, FlowStats> &flow : m_flows)
+        {
+            ids.push_back (flow.first);
+        }
+        std::sort (ids.begin (), ids.end ());
+
+        for (uint32_t id : ids)
+        {
+            const FlowStats &f = m_flows.find (id)->second;
+            os << "Flow " << id << ": " << f.rxPackets << " packets, " << f.rxBytes << " bytes, "
+               << f.lost << " lost, delay min/mean/max "
+               << f.minDelay.GetMicroSeconds () << "/"
+               << f.delaySum.GetMicroSeconds () / int64_t (f.rxPackets) << "/"
+               << f.maxDelay.GetMicroSeconds () << " us" << std::endl;
+            for (uint32_t b = 0; b < FLOW_STATS_BINS; ++b)
+            {
+                if (f.delayBins[b] > 0)
+                {
+                    os << "    [" << std::setw (10) << uint64_t (::FlowStats::GetBinStart (b)) << ", "
+                       << std::setw (10) << uint64_t (::FlowStats::GetBinEnd (b)) << ") us  " << f.delayBins[b] << std::endl;
+                }
+            }
+        }
+    }
+
+private:
+    virtual void DoDispose (void)
+    {
+        m_socket = 0;
+        Application::DoDispose ();
+    }
+
+    virtual void StartApplication (void)
+    {
+        m_socket->SetRecvCallback (MakeCallback (&TrafficSink::HandleRead, this));
+    }
+
+    virtual void StopApplication (void)
+    {
+        if (m_socket)
+        {
+            m_socket->SetRecvCallback (MakeNullCallback<void, Ptr<Socket> > ());
+        }
+    }
+
+    void HandleRead (Ptr<Socket> socket)
+    {
+        Ptr<Packet> packet;
+        Address from;
+        TrafficHeader header;
+        while ((packet = socket->RecvFrom (from)))
+        {
+            if (packet->GetSize () < header.GetSerializedSize ())
+            {
+                continue;
+            }
+            m_rxTrace (packet, from);
+            uint32_t size = packet->GetSize ();
+            packet->RemoveHeader (header);
+            Time delay = Simulator::Now () - header.GetTxTime ();
+
+            std::unordered_map<uint32_t, FlowStats>::iterator it = m_flows.find (header.GetFlowId ());
+            if (it == m_flows.end ())
+            {
+                FlowStats fresh = FlowStats ();
+                fresh.minDelay = delay;
+                it = m_flows.insert (std::make_pair (header.GetFlowId (), fresh)).first;
+            }
+            FlowStats &f = it->second;
+            ++f.rxPackets;
+            f.rxBytes += size;
+            if (header.GetSeq () >= f.nextSeq)
+            {
+                f.lost += header.GetSeq () - f.nextSeq;
+                f.nextSeq = header.GetSeq () + 1;
+            }
+            else if (f.lost > 0)
+            {
+                --f.lost;       // arrived out of order, not lost after all
+            }
+            f.delaySum += delay;
+            f.minDelay = std::min (f.minDelay, delay);
+            f.maxDelay = std::max (f.maxDelay, delay);
+
+            ++f.delayBins[::FlowStats::GetBin (delay.GetNanoSeconds ())];
+        }
+    }
+
+    Ptr<Socket> m_socket;
+    std::unordered_map<uint32_t, FlowStats> m_flows;
+    TracedCallback<Ptr<const Packet>, const Address &> m_rxTrace;
+};
+
+
+#endif /* TRAFFIC_GENERATOR_H */
@@ -0,0 +1,202 @@
+/*
+Created on Mon Oct 19 23:54:09 2026
+@author: Harshil Bhatt
+*/
+
+
+/*  Lookup micro-benchmark of Ipv4Poptrie (ipv4-poptrie.h), the table behind
+    Ipv4TrieRouting.
+
+    Builds a table of -n random prefixes (lengths spread like a BGP table,
+    mostly /24 with /8 to /32 around it) or reads "a.b.c.d/len" lines from
+    -f, then looks up -l addresses and prints million lookups per second
+    for:
+        poptrie     Ipv4Poptrie::Lookup
+        binary      walking the binary trie bit by bit
+        linear      scanning every prefix for the longest match, what
+                    Ipv4StaticRouting does per packet (only -L addresses,
+                    it is that slow)
+    Half the addresses are drawn from inside the table's prefixes, half
+    uniformly. Every poptrie answer is checked against the binary trie
+    first, so a wrong table fails loudly instead of looking fast.
+
+    Build and run
+        g++ -O2 -march=native -std=c++17 -o trie-lookup-bench trie-lookup-bench.cpp
+        ./trie-lookup-bench -n 100000
+        ./trie-lookup-bench -f prefixes.txt -l 50000000
+*/
+
+#include <bits/stdc++.h>
+
+#include "ipv4-poptrie.h"
+
+using namespace std;
+
+
+struct Prefix {
+    uint32_t address;
+    uint32_t length;
+    uint32_t value;
+};
+
+
+static uint32_t mask(uint32_t length) {
+    return length ? ~0u << (32 - length) : 0;
+}
+
+
+static double secondsSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+
+static vector<Prefix> randomPrefixes(size_t n, mt19937 &rng) {
+    // Rough shape of a full BGP table: half /24, the rest /16 to /23, a
+    // few shorter and a few host routes
+    static const uint32_t lengths[] = {8, 12, 16, 18, 19, 20, 21, 22, 22, 23, 23,
+                                       24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 28, 32};
+    uniform_int_distribution<size_t> pick(0, sizeof(lengths) / sizeof(lengths[0]) - 1);
+    vector<Prefix> prefixes;
+    set<pair<uint32_t, uint32_t>> seen;
+    while (prefixes.size() < n) {
+        uint32_t length = lengths[pick(rng)];
+        uint32_t address = rng() & mask(length);
+        if (!seen.insert({address, length}).second)
+            continue;
+        prefixes.push_back({address, length, uint32_t(prefixes.size() + 1)});
+    }
+    return prefixes;
+}
+
+
+static bool readPrefixes(const char *path, vector<Prefix> &prefixes) {
+    ifstream in(path);
+    if (!in)
+        return false;
+    string line;
+    while (getline(in, line)) {
+        unsigned a, b, c, d, length;
+        if (sscanf(line.c_str(), "%u.%u.%u.%u/%u", &a, &b, &c, &d, &length) != 5 || length > 32)
+            continue;
+        uint32_t address = ((a << 24) | (b << 16) | (c << 8) | d) & mask(length);
+        prefixes.push_back({address, length, uint32_t(prefixes.size() + 1)});
+    }
+    return true;
+}
+
+
+static uint32_t linearLookup(const vector<Prefix> &prefixes, uint32_t address) {
+    uint32_t best = Ipv4Poptrie::NO_ROUTE;
+    int bestLength = -1;
+    for (const Prefix &p : prefixes) {
+        if ((address & mask(p.length)) == p.address && int(p.length) > bestLength) {
+            best = p.value;
+            bestLength = p.length;
+        }
+    }
+    return best;
+}
+
+
+int main(int argc, char *argv[]) {
+    size_t n = 50000;
+    size_t lookups = 10000000;
+    size_t linearLookups = 2000;
+    unsigned seed = 1;
+    const char *file = NULL;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:l:L:s:f:h")) != -1) {
+        switch (opt) {
+            case 'n': n = atol(optarg); break;
+            case 'l': lookups = atol(optarg); break;
+            case 'L': linearLookups = atol(optarg); break;
+            case 's': seed = atoi(optarg); break;
+            case 'f': file = optarg; break;
+            default:
+                fprintf(stderr, "Script Usage: %s [-n prefixes] [-f prefix file] [-l lookups] "
+                                "[-L linear lookups] [-s seed]\n", argv[0]);
+                return 1;
+        }
+    }
+
+    mt19937 rng(seed);
+    vector<Prefix> prefixes;
+    if (file) {
+        if (!readPrefixes(file, prefixes)) {
+            fprintf(stderr, "Cannot open %s\n", file);
+            return 1;
+        }
+    } else {
+        prefixes = randomPrefixes(n, rng);
+    }
+    if (prefixes.empty() || lookups == 0) {
+        fprintf(stderr, "Nothing to look up\n");
+        return 1;
+    }
+
+    Ipv4Poptrie trie;
+    auto start = chrono::steady_clock::now();
+    for (const Prefix &p : prefixes)
+        trie.Insert(p.address, p.length, p.value);
+    double insertSecs = secondsSince(start);
+    start = chrono::steady_clock::now();
+    trie.Build();
+    double buildSecs = secondsSince(start);
+
+    printf("%zu prefixes, insert %.3f s, build %.3f s, %zu nodes, %zu leaves, %.1f KB\n",
+           trie.GetPrefixCount(), insertSecs, buildSecs, trie.GetNodeCount(), trie.GetLeafCount(),
+           trie.GetMemory() / 1024.0);
+
+    vector<uint32_t> addresses(lookups);
+    uniform_int_distribution<size_t> which(0, prefixes.size() - 1);
+    for (size_t i = 0; i < lookups; ++i) {
+        uint32_t r = rng();
+        if (i & 1) {
+            addresses[i] = r;
+        } else {
+            const Prefix &p = prefixes[which(rng)];
+            addresses[i] = p.address | (r & ~mask(p.length));
+        }
+    }
+
+    for (size_t i = 0; i < lookups; ++i) {
+        if (trie.Lookup(addresses[i]) != trie.LookupReference(addresses[i])) {
+            fprintf(stderr, "Mismatch at %08x: poptrie %u, binary trie %u\n", addresses[i],
+                    trie.Lookup(addresses[i]), trie.LookupReference(addresses[i]));
+            return 1;
+        }
+    }
+    size_t linearCount = min(linearLookups, lookups);
+    for (size_t i = 0; i < linearCount; ++i) {
+        if (trie.Lookup(addresses[i]) != linearLookup(prefixes, addresses[i])) {
+            fprintf(stderr, "Mismatch at %08x against the linear scan\n", addresses[i]);
+            return 1;
+        }
+    }
+
+    // The sum keeps the loops from being optimized away
+    uint64_t sum = 0;
+    printf("%-10s %12s %10s %12s\n", "lookup", "addresses", "seconds", "Mlookups/s");
+
+    start = chrono::steady_clock::now();
+    for (size_t i = 0; i < lookups; ++i)
+        sum += trie.Lookup(addresses[i]);
+    double secs = secondsSince(start);
+    printf("%-10s %12zu %10.3f %12.2f\n", "poptrie", lookups, secs, lookups / secs / 1e6);
+
+    start = chrono::steady_clock::now();
+    for (size_t i = 0; i < lookups; ++i)
+        sum += trie.LookupReference(addresses[i]);
+    secs = secondsSince(start);
+    printf("%-10s %12zu %10.3f %12.2f\n", "binary", lookups, secs, lookups / secs / 1e6);
+
+    start = chrono::steady_clock::now();
+    for (size_t i = 0; i < linearCount; ++i)
+        sum += linearLookup(prefixes, addresses[i]);
+    secs = secondsSince(start);
+    printf("%-10s %12zu %10.3f %12.4f\n", "linear", linearCount, secs, linearCount / secs / 1e6);
+
+    fprintf(stderr, "checksum %llu\n", (unsigned long long)sum);
+    return 0;
+}
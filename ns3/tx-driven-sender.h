@@ -0,0 +1,229 @@
+/**
+ * @author Harshil Bhatt
+ * @create date 2026-10-19 22:31:40
+ * @desc
+ *      Bulk sender driven by the socket's buffer-space notification.
+ *
+ *      Instead of one timer per packet, the sender writes as many packets
+ *      as the socket accepts and then waits for the socket's send callback
+ *      (SetSendCallback), which fires when acknowledged data frees buffer
+ *      space. Every packet is a Copy () of one zero-filled template, so no
+ *      payload is allocated per send. A Send () that fails because the
+ *      buffer is full is simply retried on the next callback, nothing is
+ *      lost.
+ *
+ *      Two modes:
+ *          saturating      DataRate 0 (the default); the socket (cwnd and
+ *                          send buffer) is the only limit
+ *          rate limited    a token bucket of BurstBytes filled at DataRate;
+ *                          a timer is only scheduled when the bucket, not
+ *                          the socket, is what stops the sender
+ *
+ *      Meant for stream sockets. With a datagram socket use a DataRate,
+ *      since a UDP socket never runs out of buffer space.
+ *
+ *      Usage:
+ *          Ptr<TxDrivenSender> app = CreateObject<TxDrivenSender> ();
+ *          app->Setup (socket, sinkAddress, 1040, 1040 * 1000, DataRate ("1Mbps"));
+ *          node->AddApplication (app);
+ */
+
+#ifndef TX_DRIVEN_SENDER_H
+#define TX_DRIVEN_SENDER_H
+
+#include <algorithm>
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+
+
+using namespace ns3;
+
+
+class TxDrivenSender : public Application
+{
+public:
+    static TypeId GetTypeId (void)
+    {
+        static TypeId tid = TypeId ("TxDrivenSender")
+            .SetParent<Application> ()
+            .AddConstructor<TxDrivenSender> ()
+            .AddAttribute ("PacketSize", "Bytes per Send ().",
+                           UintegerValue (1040),
+                           MakeUintegerAccessor (&TxDrivenSender::m_packetSize),
+                           MakeUintegerChecker<uint32_t> (1))
+            .AddAttribute ("MaxBytes", "Total bytes to send, 0 for no limit.",
+                           UintegerValue (0),
+                           MakeUintegerAccessor (&TxDrivenSender::m_maxBytes),
+                           MakeUintegerChecker<uint64_t> ())
+            .AddAttribute ("DataRate", "Token bucket rate, 0 to saturate the socket.",
+                           DataRateValue (DataRate (0)),
+                           MakeDataRateAccessor (&TxDrivenSender::m_dataRate),
+                           MakeDataRateChecker ())
+            .AddAttribute ("BurstBytes", "Token bucket depth, 0 for one packet.",
+                           UintegerValue (0),
+                           MakeUintegerAccessor (&TxDrivenSender::m_burstBytes),
+                           MakeUintegerChecker<uint32_t> ());
+        return tid;
+    }
+
+    TxDrivenSender ()
+        : m_packetSize (1040),
+          m_maxBytes (0),
+          m_dataRate (0),
+          m_burstBytes (0),
+          m_running (false),
+          m_filling (false),
+          m_tokens (0),
+          m_totalBytes (0),
+          m_sends (0)
+    {
+    }
+
+    void Setup (Ptr<Socket> socket, Address address, uint32_t packetSize, uint64_t maxBytes,
+                DataRate dataRate = DataRate (0))
+    {
+        m_socket = socket;
+        m_peer = address;
+        m_packetSize = packetSize;
+        m_maxBytes = maxBytes;
+        m_dataRate = dataRate;
+    }
+
+    uint64_t GetTotalBytes (void) const
+    {
+        return m_totalBytes;
+    }
+
+    /**
+     * \returns successful Send () calls
+     */
+    uint64_t GetSends (void) const
+    {
+        return m_sends;
+    }
+
+private:
+    virtual void DoDispose (void)
+    {
+        m_socket = 0;
+        m_template = 0;
+        Application::DoDispose ();
+    }
+
+    virtual void StartApplication (void)
+    {
+        m_running = true;
+        m_template = Create<Packet> (m_packetSize);
+        m_tokens = GetBurst ();
+        m_lastRefill = Simulator::Now ();
+
+        m_socket->Bind ();
+        m_socket->Connect (m_peer);
+        m_socket->SetSendCallback (MakeCallback (&TxDrivenSender::SendReady, this));
+        Fill ();
+    }
+
+    virtual void StopApplication (void)
+    {
+        m_running = false;
+        Simulator::Cancel (m_wakeEvent);
+        if (m_socket)
+        {
+            m_socket->SetSendCallback (MakeNullCallback<void, Ptr<Socket>, uint32_t> ());
+            m_socket->Close ();
+        }
+    }
+
+    bool IsRateLimited (void) const
+    {
+        return m_dataRate.GetBitRate () > 0;
+    }
+
+    double GetBurst (void) const
+    {
+        return std::max (m_burstBytes, m_packetSize);
+    }
+
+    void SendReady (Ptr<Socket> socket, uint32_t available)
+    {
+        Fill ();
+    }
+
+    /**
+     * Send until the socket, the token bucket or MaxBytes says stop
+     */
+    void Fill (void)
+    {
+        // Some sockets call the send callback from inside Send ()
+        if (m_filling || !m_running)
+        {
+            return;
+        }
+        m_filling = true;
+
+        if (IsRateLimited ())
+        {
+            Time now = Simulator::Now ();
+            m_tokens = std::min (GetBurst (),
+                                 m_tokens + m_dataRate.GetBitRate () * (now - m_lastRefill).GetSeconds () / 8);
+            m_lastRefill = now;
+        }
+
+        while (m_maxBytes == 0 || m_totalBytes < m_maxBytes)
+        {
+            uint32_t size = m_packetSize;
+            if (m_maxBytes > 0)
+            {
+                size = std::min<uint64_t> (size, m_maxBytes - m_totalBytes);
+            }
+
+            if (IsRateLimited () && m_tokens < size)
+            {
+                if (!m_wakeEvent.IsRunning ())
+                {
+                    Time wait = Seconds ((size - m_tokens) * 8 / m_dataRate.GetBitRate ());
+                    m_wakeEvent = Simulator::Schedule (wait, &TxDrivenSender::Fill, this);
+                }
+                break;
+            }
+            if (m_socket->GetTxAvailable () < size)
+            {
+                break;      // SendReady wakes us once acks free some space
+            }
+
+            Ptr<Packet> packet = size == m_packetSize ? m_template->Copy () : Create<Packet> (size);
+            if (m_socket->Send (packet) < 0)
+            {
+                break;
+            }
+            m_totalBytes += size;
+            ++m_sends;
+            if (IsRateLimited ())
+            {
+                m_tokens -= size;
+            }
+        }
+
+        m_filling = false;
+    }
+
+    Ptr<Socket> m_socket;
+    Address m_peer;
+    uint32_t m_packetSize;
+    uint64_t m_maxBytes;
+    DataRate m_dataRate;
+    uint32_t m_burstBytes;
+
+    bool m_running;
+    bool m_filling;
+    Ptr<Packet> m_template;     // zero-filled, copied for every send
+    double m_tokens;            // bytes
+    Time m_lastRefill;
+    EventId m_wakeEvent;
+    uint64_t m_totalBytes;
+    uint64_t m_sends;
+};
+
+
+#endif /* TX_DRIVEN_SENDER_H */
@@ -0,0 +1,410 @@
+/**
+ * @author Harshil Bhatt
+ * @create date 2026-10-19 21:18:32
+ * @desc
+ *      Spectrum channel with a uniform grid index over receiver positions,
+ *      see spatial-spectrum-channel.h
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include "ns3/log.h"
+#include "ns3/double.h"
+#include "ns3/simulator.h"
+#include "ns3/node.h"
+#include "ns3/net-device.h"
+#include "ns3/spectrum-value.h"
+#include "ns3/constant-position-mobility-model.h"
+
+#include "spatial-spectrum-channel.h"
+
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("SpatialSpectrumChannel");
+
+NS_OBJECT_ENSURE_REGISTERED (SpatialSpectrumChannel);
+
+const int64_t SpatialSpectrumChannel::NO_CELL = INT64_MIN;
+
+
+TypeId
+SpatialSpectrumChannel::GetTypeId (void)
+{
+    static TypeId tid = TypeId ("ns3::SpatialSpectrumChannel")
+        .SetParent<SpectrumChannel> ()
+        .SetGroupName ("Spectrum")
+        .AddConstructor<SpatialSpectrumChannel> ()
+        .AddAttribute ("MaxLossDb",
+                       "If a single-frequency PropagationLossModel is used, "
+                       "this value represents the maximum loss in dB for which "
+                       "transmissions will be passed to the receiving PHY.",
+                       DoubleValue (1.0e9),
+                       MakeDoubleAccessor (&SpatialSpectrumChannel::m_maxLossDb),
+                       MakeDoubleChecker<double> ())
+        .AddAttribute ("EnergyDetectionThreshold",
+                       "Receivers whose receive power (dBm) would fall below "
+                       "this are skipped.",
+                       DoubleValue (-101.0),
+                       MakeDoubleAccessor (&SpatialSpectrumChannel::m_edThresholdDbm),
+                       MakeDoubleChecker<double> ())
+        .AddAttribute ("MaxReach",
+                       "Upper bound (m) for the reach search.",
+                       DoubleValue (1.0e6),
+                       MakeDoubleAccessor (&SpatialSpectrumChannel::m_maxReach),
+                       MakeDoubleChecker<double> (1.0))
+        .AddAttribute ("CellSize",
+                       "Side (m) of the grid cells, 0 uses the reach of the "
+                       "first transmission.",
+                       DoubleValue (0.0),
+                       MakeDoubleAccessor (&SpatialSpectrumChannel::m_cellSize),
+                       MakeDoubleChecker<double> (0.0))
+        ;
+    return tid;
+}
+
+
+SpatialSpectrumChannel::SpatialSpectrumChannel ()
+    : m_candidates (0),
+      m_deliveries (0)
+{
+    NS_LOG_FUNCTION (this);
+    m_probeA = CreateObject<ConstantPositionMobilityModel> ();
+    m_probeB = CreateObject<ConstantPositionMobilityModel> ();
+}
+
+SpatialSpectrumChannel::~SpatialSpectrumChannel ()
+{
+}
+
+void
+SpatialSpectrumChannel::DoDispose (void)
+{
+    NS_LOG_FUNCTION (this);
+    // the hooks hold a raw pointer to this channel and may outlive it
+    for (uint32_t i = 0; i < m_receivers.size (); ++i)
+    {
+        if (m_receivers[i].mobility)
+        {
+            m_receivers[i].mobility->TraceDisconnectWithoutContext ("CourseChange",
+                MakeBoundCallback (&SpatialSpectrumChannel::CourseChanged, this, i));
+        }
+    }
+    m_receivers.clear ();
+    m_cells.clear ();
+    m_moving.clear ();
+    m_unplaced.clear ();
+    m_probeA = 0;
+    m_probeB = 0;
+    m_propagationLoss = 0;
+    m_spectrumPropagationLoss = 0;
+    m_propagationDelay = 0;
+    SpectrumChannel::DoDispose ();
+}
+
+
+void
+SpatialSpectrumChannel::AddPropagationLossModel (Ptr<PropagationLossModel> loss)
+{
+    NS_ASSERT (m_propagationLoss == 0);
+    m_propagationLoss = loss;
+}
+
+void
+SpatialSpectrumChannel::AddSpectrumPropagationLossModel (Ptr<SpectrumPropagationLossModel> loss)
+{
+    NS_ASSERT (m_spectrumPropagationLoss == 0);
+    m_spectrumPropagationLoss = loss;
+}
+
+void
+SpatialSpectrumChannel::SetPropagationDelayModel (Ptr<PropagationDelayModel> delay)
+{
+    NS_ASSERT (m_propagationDelay == 0);
+    m_propagationDelay = delay;
+}
+
+Ptr<SpectrumPropagationLossModel>
+SpatialSpectrumChannel::GetSpectrumPropagationLossModel (void)
+{
+    return m_spectrumPropagationLoss;
+}
+
+
+// Mobility is usually aggregated after the PHY joins the channel, so
+// receivers are placed lazily on the first transmission
+void
+SpatialSpectrumChannel::AddRx (Ptr<SpectrumPhy> phy)
+{
+    NS_LOG_FUNCTION (this << phy);
+    Receiver r;
+    r.phy = phy;
+    r.cell = NO_CELL;
+    r.slot = m_unplaced.size ();
+    m_unplaced.push_back (m_receivers.size ());
+    m_receivers.push_back (r);
+}
+
+
+std::size_t
+SpatialSpectrumChannel::GetNDevices (void) const
+{
+    return m_receivers.size ();
+}
+
+Ptr<NetDevice>
+SpatialSpectrumChannel::GetDevice (std::size_t i) const
+{
+    return m_receivers.at (i).phy->GetDevice ();
+}
+
+uint64_t
+SpatialSpectrumChannel::GetCandidates (void) const
+{
+    return m_candidates;
+}
+
+uint64_t
+SpatialSpectrumChannel::GetDeliveries (void) const
+{
+    return m_deliveries;
+}
+
+
+int64_t
+SpatialSpectrumChannel::CellKey (int64_t x, int64_t y) const
+{
+    // Shifted as unsigned, left shifts of negative values are undefined
+    return int64_t ((uint64_t (uint32_t (x)) << 32) | uint32_t (y));
+}
+
+
+// Remove a receiver from whichever cell or list it is in
+void
+SpatialSpectrumChannel::Unlink (uint32_t index)
+{
+    Receiver &r = m_receivers[index];
+    std::vector<uint32_t> *list;
+    if (r.cell != NO_CELL)
+    {
+        list = &m_cells[r.cell];
+    }
+    else if (r.mobility)
+    {
+        list = &m_moving;
+    }
+    else
+    {
+        list = &m_unplaced;
+    }
+
+    uint32_t last = list->back ();
+    (*list)[r.slot] = last;
+    m_receivers[last].slot = r.slot;
+    list->pop_back ();
+    r.cell = NO_CELL;
+}
+
+
+void
+SpatialSpectrumChannel::Place (uint32_t index)
+{
+    Receiver &r = m_receivers[index];
+    if (r.mobility == 0 || r.mobility->GetVelocity ().GetLength () > 0)
+    {
+        std::vector<uint32_t> &list = r.mobility ? m_moving : m_unplaced;
+        r.cell = NO_CELL;
+        r.slot = list.size ();
+        list.push_back (index);
+        return;
+    }
+
+    Vector pos = r.mobility->GetPosition ();
+    r.cell = CellKey (int64_t (std::floor (pos.x / m_cellSize)), int64_t (std::floor (pos.y / m_cellSize)));
+    std::vector<uint32_t> &cell = m_cells[r.cell];
+    r.slot = cell.size ();
+    cell.push_back (index);
+}
+
+
+void
+SpatialSpectrumChannel::CourseChanged (SpatialSpectrumChannel *channel, uint32_t index,
+                                       Ptr<const MobilityModel> mobility)
+{
+    channel->Unlink (index);
+    channel->Place (index);
+}
+
+
+// Distance at which the loss model takes txPowerDbm down to the threshold,
+// by bisection on a pair of probe positions
+double
+SpatialSpectrumChannel::Reach (double txPowerDbm)
+{
+    int32_t key = int32_t (std::ceil (txPowerDbm * 10));
+    std::map<int32_t, double>::const_iterator it = m_reach.find (key);
+    if (it != m_reach.end ())
+    {
+        return it->second;
+    }
+
+    double power = key / 10.0;
+    double budget = std::min (power - m_edThresholdDbm, m_maxLossDb);
+    double lo = 0;
+    double hi = m_maxReach;
+    if (m_propagationLoss)
+    {
+        m_probeA->SetPosition (Vector (0, 0, 0));
+        for (int i = 0; i < 64 && hi - lo > 0.01; ++i)
+        {
+            double mid = (lo + hi) / 2;
+            m_probeB->SetPosition (Vector (mid, 0, 0));
+            double lossDb = -m_propagationLoss->CalcRxPower (0, m_probeA, m_probeB);
+            if (lossDb <= budget)
+            {
+                lo = mid;
+            }
+            else
+            {
+                hi = mid;
+            }
+        }
+    }
+    NS_LOG_INFO ("Reach at " << power << " dBm is " << hi << " m");
+    m_reach[key] = hi;
+    return hi;
+}
+
+
+void
+SpatialSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
+{
+    NS_LOG_FUNCTION (this << txParams->psd << txParams->duration << txParams->txPhy);
+    NS_ASSERT_MSG (txParams->psd, "NULL txPsd");
+    NS_ASSERT_MSG (txParams->txPhy, "NULL txPhy");
+
+    Ptr<MobilityModel> senderMobility = txParams->txPhy->GetMobility ();
+    double txPowerDbm = 10 * std::log10 (Integral (*txParams->psd)) + 30;
+    double reach = Reach (txPowerDbm);
+
+    if (m_cellSize <= 0)
+    {
+        m_cellSize = std::max (reach, 1.0);
+    }
+
+    // Receivers whose mobility has turned up since the last transmission
+    for (uint32_t i = 0; i < m_unplaced.size (); )
+    {
+        uint32_t index = m_unplaced[i];
+        Receiver &r = m_receivers[index];
+        r.mobility = r.phy->GetMobility ();
+        if (r.mobility == 0)
+        {
+            ++i;
+            continue;
+        }
+        r.mobility->TraceConnectWithoutContext ("CourseChange",
+            MakeBoundCallback (&SpatialSpectrumChannel::CourseChanged, this, index));
+        m_unplaced[i] = m_unplaced.back ();
+        m_receivers[m_unplaced[i]].slot = i;
+        m_unplaced.pop_back ();
+        Place (index);
+    }
+
+    std::vector<uint32_t> candidates (m_moving.begin (), m_moving.end ());
+    candidates.insert (candidates.end (), m_unplaced.begin (), m_unplaced.end ());
+    if (senderMobility)
+    {
+        Vector pos = senderMobility->GetPosition ();
+        int64_t x0 = int64_t (std::floor ((pos.x - reach) / m_cellSize));
+        int64_t x1 = int64_t (std::floor ((pos.x + reach) / m_cellSize));
+        int64_t y0 = int64_t (std::floor ((pos.y - reach) / m_cellSize));
+        int64_t y1 = int64_t (std::floor ((pos.y + reach) / m_cellSize));
+        for (int64_t x = x0; x <= x1; ++x)
+        {
+            for (int64_t y = y0; y <= y1; ++y)
+            {
+                std::unordered_map<int64_t, std::vector<uint32_t> >::const_iterator cell = m_cells.find (CellKey (x, y));
+                if (cell != m_cells.end ())
+                {
+                    candidates.insert (candidates.end (), cell->second.begin (), cell->second.end ());
+                }
+            }
+        }
+    }
+    else
+    {
+        for (uint32_t i = 0; i < m_receivers.size (); ++i)
+        {
+            if (m_receivers[i].cell != NO_CELL)
+            {
+                candidates.push_back (i);
+            }
+        }
+    }
+
+    // Same order as the PHYs were added, as SingleModelSpectrumChannel does
+    std::sort (candidates.begin (), candidates.end ());
+
+    for (uint32_t index : candidates)
+    {
+        Ptr<SpectrumPhy> rxPhy = m_receivers[index].phy;
+        if (rxPhy == txParams->txPhy)
+        {
+            continue;
+        }
+        ++m_candidates;
+
+        Time delay = MicroSeconds (0);
+        Ptr<MobilityModel> receiverMobility = m_receivers[index].mobility;
+        Ptr<SpectrumSignalParameters> rxParams = txParams->Copy ();
+
+        if (senderMobility && receiverMobility)
+        {
+            double pathLossDb = 0;
+            if (m_propagationLoss)
+            {
+                pathLossDb = -m_propagationLoss->CalcRxPower (0, senderMobility, receiverMobility);
+            }
+            if (pathLossDb > m_maxLossDb || txPowerDbm - pathLossDb < m_edThresholdDbm)
+            {
+                continue;
+            }
+
+            double pathGainLinear = std::pow (10.0, (-pathLossDb) / 10.0);
+            *(rxParams->psd) *= pathGainLinear;
+
+            if (m_spectrumPropagationLoss)
+            {
+                rxParams->psd = m_spectrumPropagationLoss->CalcRxPowerSpectralDensity (rxParams->psd, senderMobility, receiverMobility);
+            }
+            if (m_propagationDelay)
+            {
+                delay = m_propagationDelay->GetDelay (senderMobility, receiverMobility);
+            }
+        }
+
+        ++m_deliveries;
+        Ptr<NetDevice> netDev = rxPhy->GetDevice ();
+        if (netDev)
+        {
+            Simulator::ScheduleWithContext (netDev->GetNode ()->GetId (), delay,
+                                            &SpatialSpectrumChannel::StartRx, this, rxParams, rxPhy);
+        }
+        else
+        {
+            Simulator::Schedule (delay, &SpatialSpectrumChannel::StartRx, this, rxParams, rxPhy);
+        }
+    }
+}
+
+
+void
+SpatialSpectrumChannel::StartRx (Ptr<SpectrumSignalParameters> params, Ptr<SpectrumPhy> receiver)
+{
+    NS_LOG_FUNCTION (this << params);
+    receiver->StartRx (params);
+}
+
+} // namespace ns3
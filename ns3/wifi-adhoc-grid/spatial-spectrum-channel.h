@@ -0,0 +1,129 @@
+/**
+ * @author Harshil Bhatt
+ * @create date 2026-10-19 21:18:32
+ * @desc
+ *      Spectrum channel with a uniform grid index over receiver positions.
+ *
+ *      SingleModelSpectrumChannel hands every transmission to every other
+ *      PHY, which is O(N^2) events per round of traffic on a big ad-hoc
+ *      grid. This channel only looks at receivers in the grid cells that
+ *      lie within reach of the transmitter, where reach is the distance
+ *      at which the propagation loss model brings the transmit power down
+ *      to the EnergyDetectionThreshold, and skips any candidate whose
+ *      computed receive power is still below that threshold. Everything
+ *      else (loss, delay, receive scheduling) is done exactly as
+ *      SingleModelSpectrumChannel does it, so receivers above the
+ *      threshold see identical signals. Signals below it no longer add to
+ *      interference, so keep the threshold at or under the PHY's receive
+ *      sensitivity.
+ *
+ *      Assumptions:
+ *          - deterministic propagation loss that grows with distance
+ *            (Friis, LogDistance, ThreeLogDistance, ...)
+ *          - isotropic antennas, as SpectrumWifiPhyHelper installs
+ *      A SpectrumPropagationLossModel can only add loss, so the reach
+ *      stays a safe upper bound with one configured.
+ *
+ *      The index is kept up to date through each mobility model's
+ *      CourseChange trace. Nodes that report a non-zero velocity are kept
+ *      out of the grid and checked on every transmission instead, since
+ *      they drift between course changes.
+ */
+
+#ifndef SPATIAL_SPECTRUM_CHANNEL_H
+#define SPATIAL_SPECTRUM_CHANNEL_H
+
+#include <stdint.h>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+#include "ns3/spectrum-channel.h"
+#include "ns3/spectrum-phy.h"
+#include "ns3/spectrum-signal-parameters.h"
+#include "ns3/spectrum-propagation-loss-model.h"
+#include "ns3/propagation-loss-model.h"
+#include "ns3/propagation-delay-model.h"
+#include "ns3/mobility-model.h"
+
+
+namespace ns3 {
+
+class SpatialSpectrumChannel : public SpectrumChannel
+{
+public:
+    static TypeId GetTypeId (void);
+
+    SpatialSpectrumChannel ();
+    virtual ~SpatialSpectrumChannel ();
+
+    // SpectrumChannel
+    virtual void AddPropagationLossModel (Ptr<PropagationLossModel> loss);
+    virtual void AddSpectrumPropagationLossModel (Ptr<SpectrumPropagationLossModel> loss);
+    virtual void SetPropagationDelayModel (Ptr<PropagationDelayModel> delay);
+    virtual Ptr<SpectrumPropagationLossModel> GetSpectrumPropagationLossModel (void);
+    virtual void AddRx (Ptr<SpectrumPhy> phy);
+    virtual void StartTx (Ptr<SpectrumSignalParameters> params);
+
+    // Channel
+    virtual std::size_t GetNDevices (void) const;
+    virtual Ptr<NetDevice> GetDevice (std::size_t i) const;
+
+    /**
+     * \returns receivers considered over all transmissions so far
+     */
+    uint64_t GetCandidates (void) const;
+
+    /**
+     * \returns receptions scheduled over all transmissions so far
+     */
+    uint64_t GetDeliveries (void) const;
+
+private:
+    virtual void DoDispose (void);
+
+    struct Receiver
+    {
+        Ptr<SpectrumPhy> phy;
+        Ptr<MobilityModel> mobility;
+        int64_t cell;       // grid key, or NO_CELL while moving or unplaced
+        uint32_t slot;      // position in its cell or list
+    };
+
+    void StartRx (Ptr<SpectrumSignalParameters> params, Ptr<SpectrumPhy> receiver);
+
+    void Place (uint32_t index);
+    void Unlink (uint32_t index);
+    static void CourseChanged (SpatialSpectrumChannel *channel, uint32_t index,
+                               Ptr<const MobilityModel> mobility);
+
+    int64_t CellKey (int64_t x, int64_t y) const;
+    double Reach (double txPowerDbm);
+
+    static const int64_t NO_CELL;
+
+    std::vector<Receiver> m_receivers;
+    std::unordered_map<int64_t, std::vector<uint32_t> > m_cells;
+    std::vector<uint32_t> m_moving;         // checked on every transmission
+    std::vector<uint32_t> m_unplaced;       // mobility not known yet
+
+    std::map<int32_t, double> m_reach;      // by tx power in 0.1 dB steps
+    Ptr<MobilityModel> m_probeA;
+    Ptr<MobilityModel> m_probeB;
+
+    Ptr<PropagationLossModel> m_propagationLoss;
+    Ptr<SpectrumPropagationLossModel> m_spectrumPropagationLoss;
+    Ptr<PropagationDelayModel> m_propagationDelay;
+
+    double m_maxLossDb;
+    double m_edThresholdDbm;
+    double m_maxReach;
+    double m_cellSize;
+    uint64_t m_candidates;
+    uint64_t m_deliveries;
+};
+
+} // namespace ns3
+
+
+#endif /* SPATIAL_SPECTRUM_CHANNEL_H */
@@ -18,7 +18,31 @@
  *      n0   n1   n2   n3   n4
  *      
  *      the layout is affected by the parameters given to GridPositionAllocator;
- *      by default, GridWidth is 5 and numNodes is 25..
+ *      GridWidth is the square root of numNodes rounded up, by default 5 for
+ *      25 nodes.
+ *
+ *      --channel picks the channel model: "yans" (YansWifiChannel),
+ *      "spectrum" (SingleModelSpectrumChannel with SpectrumWifiPhy) or
+ *      "spatial" (SpatialSpectrumChannel, same as spectrum but only
+ *      delivers to receivers in range, for grids of thousands of nodes).
+ *      --cacheLoss puts a CachedPropagationLossModel in front of Friis; the
+ *      nodes never move, so after the first frame between two nodes their
+ *      loss is looked up rather than recomputed. The run prints the cache
+ *      hit rate and events per second, compare with --cacheLoss=0.
+ *      --benchScheduler runs the scenario under every event scheduler and
+ *      prints events/s and peak memory; --scheduler=auto probes each one
+ *      up to --warmup simulated seconds past the traffic start, so the
+ *      data packets are part of the profile, and runs with the fastest.
+ *      Traffic comes from a TrafficGenerator on sourceNode (--traffic=Cbr,
+ *      Poisson, OnOff or Trace with --trafficTrace=<file>), starting at 30 s
+ *      once OLSR has converged; the TrafficSink on sinkNode prints packets,
+ *      losses and the delay histogram at the end.
+ *      --failures takes nodes' wifi interfaces down and up ("40-50@12":
+ *      n12 down at 40 s, up at 50 s). OLSR finds out by itself once the
+ *      node's HELLOs stop, so nothing is recomputed by hand; the run
+ *      reports the flow's loss and how long it took to get packets
+ *      through again. Send enough packets to see it, e.g.
+ *      >> ./waf --run "wifi-simple-adhoc-grid --numPackets=1000 --interval=0.1 --failures=35@12 --stopTime=80"
  *      
  *      There are a number of command-line options available to control
  *      the default behavior.  The list of available command-line options
@@ -37,11 +61,17 @@
  *      
  */
 
+#include <chrono>
+#include <cmath>
+#include <sstream>
+
 #include "ns3/core-module.h"
 #include "ns3/yans-wifi-helper.h"
 #include "ns3/mobility-helper.h"
 #include "ns3/ipv4-address-helper.h"
 #include "ns3/yans-wifi-channel.h"
+#include "ns3/spectrum-wifi-helper.h"
+#include "ns3/single-model-spectrum-channel.h"
 #include "ns3/mobility-model.h"
 #include "ns3/olsr-helper.h"
 #include "ns3/ipv4-static-routing-helper.h"
@@ -49,59 +79,132 @@
 #include "ns3/internet-stack-helper.h"
 
 #include "wifi-simple-adhoc-grid.h"
+#include "spatial-spectrum-channel.h"
+#include "../columnar-trace-helper.h"
+#include "../cached-propagation-loss-model.h"
+#include "../scheduler-bench.h"
+#include "../traffic-generator.h"
+#include "../link-failure.h"
 
 
 using namespace ns3;
 
 NS_LOG_COMPONENT_DEFINE ("WifiSimpleAdHocGrid");
 
-void init                   (Data &data, int argc, char *argv[], NodeContainer &nodes);
+void init                   (Data &data, int argc, char *argv[]);
+void Build                  (Data &data, Ptr<CachedPropagationLossModel> &lossCache,
+                            Ptr<TrafficSink> &sink, Ptr<LinkFailureSchedule> &failures,
+                            Ptr<OutageMonitor> &outages);
+Ptr<CachedPropagationLossModel>
+     SetupChannel           (Data &data, YansWifiPhyHelper &yansPhy, 
+                            SpectrumWifiPhyHelper &spectrumPhy);
 void SetupWifiNIC           (Data &data, NodeContainer &nodes, NetDeviceContainer &devices,
-                            YansWifiPhyHelper &wifiPhy);
+                            WifiPhyHelper &wifiPhy);
 void SetupMobility          (Data &data, NodeContainer &nodes);                      
 void Routing                (Data &data, NodeContainer &nodes, NetDeviceContainer &devices,
-                            OlsrHelper &olsr);
+                            OlsrHelper &olsr, Ipv4InterfaceContainer &interface);
 void AssignIP               (Ipv4Address NetworkAddress, Ipv4Mask SubnetMask, NetDeviceContainer &devices, 
                             Ipv4InterfaceContainer &interface);
-void Recv                   (Data &data, NodeContainer &nodes, TypeId &tid, int port);
-void Send                   (Data &data, NodeContainer &nodes, TypeId &tid, 
+Ptr<TrafficSink> Recv       (Data &data, NodeContainer &nodes, TypeId &tid, int port);
+Ptr<TrafficGenerator> Send  (Data &data, NodeContainer &nodes, TypeId &tid, 
                             int port, Ipv4InterfaceContainer &interface);
-void tracing                (Data &data, OlsrHelper &olsr, YansWifiPhyHelper &wifiPhy, 
+Ptr<LinkFailureSchedule>
+     Failures               (Data &data, NetDeviceContainer &devices, Ptr<OutageMonitor> outages);
+void tracing                (Data &data, OlsrHelper &olsr, WifiPhyHelper &wifiPhy, 
                             NetDeviceContainer &devices);
-void ReceivePacket          (Ptr<Socket> socket);                            
-static void GenerateTraffic (Ptr<Socket> socket, uint32_t pktSize, uint32_t pktCount, 
-                            Time pktInterval);
 
 int 
 main (int argc, char *argv[])
 {
     Data data;
+    init (data, argc, argv);
+
+    // Probe runs never write traces
+    Data probeData = data;
+    probeData.tracing = false;
+    SchedulerBench::Scenario probe = [probeData] () mutable
+    {
+        Ptr<CachedPropagationLossModel> lossCache;
+        Ptr<TrafficSink> sink;
+        Ptr<LinkFailureSchedule> failures;
+        Ptr<OutageMonitor> outages;
+        Build (probeData, lossCache, sink, failures, outages);
+    };
+    if (data.benchScheduler)
+    {
+        SchedulerBench::Print (SchedulerBench::RunAll (probe), std::cout);
+        return 0;
+    }
+    // Up to the traffic start only OLSR is running, which is not the
+    // event profile of the rest of the run
+    SchedulerBench::Configure (data.scheduler, probe, Seconds (data.trafficStart + data.warmup));
+
+    Ptr<CachedPropagationLossModel> lossCache;
+    Ptr<TrafficSink> sink;
+    Ptr<LinkFailureSchedule> failures;
+    Ptr<OutageMonitor> outages;
+    Build (data, lossCache, sink, failures, outages);
+
+    NS_LOG_UNCOND ("Testing from node " << data.sourceNode << " to " << data.sinkNode << " with grid distance " << data.distance);
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+    Simulator::Run();
+    double wall = std::chrono::duration<double> (std::chrono::steady_clock::now () - start).count ();
+    uint64_t events = Simulator::GetEventCount ();
+    std::cout << events << " events in " << wall << " s (" << events / wall << " events/s)" << std::endl;
+    sink->Report (std::cout);
+    if (failures)
+    {
+        failures->Report (std::cout);
+        outages->Report (std::cout);
+    }
+    if (lossCache)
+    {
+        lossCache->Report (std::cout);
+    }
+    Simulator::Destroy();
+}
+
+
+/**
+ * Build the grid, routing, traffic and tracing; does not run it
+ */
+void
+Build (Data &data, Ptr<CachedPropagationLossModel> &lossCache, Ptr<TrafficSink> &sink,
+       Ptr<LinkFailureSchedule> &failures, Ptr<OutageMonitor> &outages)
+{
     NodeContainer nodes;
-    init (data, argc, argv, nodes);
+    nodes.Create (data.numNodes);
     NetDeviceContainer devices;
-    YansWifiPhyHelper wifiPhy = YansWifiPhyHelper::Default();
+    YansWifiPhyHelper yansPhy = YansWifiPhyHelper::Default();
+    SpectrumWifiPhyHelper spectrumPhy = SpectrumWifiPhyHelper::Default();
+    lossCache = SetupChannel (data, yansPhy, spectrumPhy);
+    WifiPhyHelper &wifiPhy = (data.channel == "yans") ? static_cast<WifiPhyHelper &> (yansPhy) : spectrumPhy;
     SetupWifiNIC (data, nodes, devices, wifiPhy);
     SetupMobility (data, nodes);
     OlsrHelper olsr;
-    Routing (data, nodes, devices, olsr);
+    Ipv4InterfaceContainer interface;
+    Routing (data, nodes, devices, olsr, interface);
+
+    TypeId tid = TypeId::LookupByName ("ns3::UdpSocketFactory");
+    int port = 80; 
+    sink = Recv (data, nodes, tid, port);
+    Ptr<TrafficGenerator> generator = Send (data, nodes, tid, port, interface);
+
+    outages = Create<OutageMonitor> ();
+    std::ostringstream name;
+    name << "n" << data.sourceNode << "->n" << data.sinkNode;
+    outages->Watch (generator, sink, name.str ());
+    failures = Failures (data, devices, outages);
     
     tracing (data, olsr, wifiPhy, devices);
-    
-    Simulator::Schedule (Seconds (30.0), &GenerateTraffic,
-                        data.sourceNode, data.packetSize, data.numPackets, data.interval);
-
-    NS_LOG_UNCOND ("Testing from node " << data.sourceNode << " to " << data.sinkNode << " with grid distance " << data.distance);
-
-    Simulator::Stop (Seconds (33.0));
-    Simulator::Run();
-    Simulator::Destroy();
-
 
+    Simulator::Stop (Seconds (data.stopTime));
 }
 
 
 void
-init (Data &data, int argc, char *argv[], NodeContainer &nodes)
+init (Data &data, int argc, char *argv[])
 {
     CommandLine cmd;
 
@@ -111,23 +214,68 @@ init (Data &data, int argc, char *argv[], NodeContainer &nodes)
     cmd.AddValue ("numPackets", "Number of packets sent",            data.numPackets);
     cmd.AddValue ("interval",   "Interval (s) b/w packets",          data.interval);
     cmd.AddValue ("verbose",    "Turn on all WifiNetDevice Logging", data.verbose);
-    cmd.AddValue ("tracing",    "Turn on ascii and pcap tracing",    data.tracing);
+    cmd.AddValue ("tracing",    "Turn on columnar and pcap tracing", data.tracing);
     cmd.AddValue ("numNodes",   "Number of Nodes",                   data.numNodes);
     cmd.AddValue ("sinkNode",   "Receiver node number",              data.sinkNode);
     cmd.AddValue ("sourceNode", "Sender node number",                data.sourceNode);
+    cmd.AddValue ("channel",    "Channel model: yans, spectrum or spatial", data.channel);
+    cmd.AddValue ("cacheLoss",  "Cache propagation loss per node pair", data.cacheLoss);
+    cmd.AddValue ("scheduler",  "Event scheduler: Map, List, Heap, Calendar, PriorityQueue or auto", data.scheduler);
+    cmd.AddValue ("benchScheduler", "Run under every scheduler and compare", data.benchScheduler);
+    cmd.AddValue ("warmup",     "Simulated seconds past the traffic start each scheduler is probed for", data.warmup);
+    cmd.AddValue ("traffic",    "Traffic mode: Cbr, Poisson, OnOff or Trace", data.traffic);
+    cmd.AddValue ("trafficTrace", "\"<seconds> <bytes>\" file for --traffic=Trace", data.trafficTrace);
+    cmd.AddValue ("failures",   "Interface changes, <down>[-<up>]@<node> in seconds, comma separated", data.failures);
+    cmd.AddValue ("stopTime",   "Simulation end in seconds",         data.stopTime);
 
     cmd.Parse(argc, argv);
     Time interPacketInterval = Seconds (data.interval); 
     // Fix non-unicast data rate to be the same as that of unicast
     Config::SetDefault ("ns3::WifiRemoteStationManager::NonUnicastMode", StringValue (data.phyMode));
+}
 
-    nodes.Create (data.numNodes);
+Ptr<CachedPropagationLossModel>
+SetupChannel (Data &data, YansWifiPhyHelper &yansPhy, SpectrumWifiPhyHelper &spectrumPhy)
+{
+    Ptr<PropagationLossModel> loss = CreateObject<FriisPropagationLossModel> ();
+    Ptr<CachedPropagationLossModel> lossCache;
+    if (data.cacheLoss)
+    {
+        lossCache = CachedPropagationLossModel::Wrap (loss);
+        loss = lossCache;
+    }
 
+    if (data.channel == "yans")
+    {
+        Ptr<YansWifiChannel> channel = CreateObject<YansWifiChannel> ();
+        channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+        channel->SetPropagationLossModel (loss);
+        yansPhy.SetChannel (channel);
+        return (lossCache);
+    }
+
+    Ptr<SpectrumChannel> channel;
+    if (data.channel == "spectrum")
+    {
+        channel = CreateObject<SingleModelSpectrumChannel> ();
+    }
+    else if (data.channel == "spatial")
+    {
+        channel = CreateObject<SpatialSpectrumChannel> ();
+    }
+    else
+    {
+        NS_FATAL_ERROR ("Unknown channel " << data.channel << ", use yans, spectrum or spatial.");
+    }
+    channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+    channel->AddPropagationLossModel (loss);
+    spectrumPhy.SetChannel (channel);
+    return (lossCache);
 }
 
 void
 SetupWifiNIC (Data &data, NodeContainer &nodes, NetDeviceContainer &devices,
-              YansWifiPhyHelper &wifiPhy)
+              WifiPhyHelper &wifiPhy)
 {
     WifiHelper wifi;
     if (data.verbose)
@@ -138,11 +286,6 @@ SetupWifiNIC (Data &data, NodeContainer &nodes, NetDeviceContainer &devices,
     wifiPhy.Set ("RxGain", DoubleValue(-10.0));     // set gain = 0
     wifiPhy.SetPcapDataLinkType (WifiPhyHelper::DLT_IEEE802_11_RADIO);
 
-    YansWifiChannelHelper wifiChannel;
-    wifiChannel.SetPropagationDelay ("ns3::ConstantSpeedPropagationDelayModel");
-    wifiChannel.AddPropagationLoss ("ns3::FriisPropagationLossModel");
-    wifiPhy.SetChannel (wifiChannel.Create());
-
     WifiMacHelper wifiMac;
     wifi.SetStandard (WIFI_PHY_STANDARD_80211b);
     wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager",
@@ -162,7 +305,7 @@ SetupMobility (Data &data, NodeContainer &nodes)
                                    "MinY",       DoubleValue (0.0),
                                    "DeltaX",     DoubleValue (data.distance),
                                    "DeltaY",     DoubleValue (data.distance),
-                                   "GridWidth",  UintegerValue (5),
+                                   "GridWidth",  UintegerValue (std::ceil (std::sqrt (data.numNodes))),
                                    "LayoutType", StringValue ("RowFirst"));
     mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
     mobility.Install (nodes);                                   
@@ -172,7 +315,7 @@ SetupMobility (Data &data, NodeContainer &nodes)
 
 void
 Routing (Data &data, NodeContainer &nodes, NetDeviceContainer &devices,
-        OlsrHelper &olsr)
+        OlsrHelper &olsr, Ipv4InterfaceContainer &interface)
 {
     Ipv4StaticRoutingHelper staticRouting;
 
@@ -185,13 +328,7 @@ Routing (Data &data, NodeContainer &nodes, NetDeviceContainer &devices,
     internet.Install (nodes);
     Ipv4Address NetworkAddress = "10.1.1.0";
     Ipv4Mask SubnetMask = "255.255.255.0";
-    Ipv4InterfaceContainer interface;
     AssignIP (NetworkAddress, SubnetMask, devices, interface);
-
-    TypeId tid = TypeId::LookupByName ("ns3::UdpSocketFactory");
-    int port = 80; 
-    Recv (data, nodes, tid, port);
-    Send (data, nodes, tid, port, interface);
 }
 
 void
@@ -204,59 +341,78 @@ AssignIP (Ipv4Address NetworkAddress, Ipv4Mask SubnetMask, NetDeviceContainer &d
     interface = ipv4.Assign (devices);
 }
 
-void 
+Ptr<TrafficSink>
 Recv (Data &data, NodeContainer &nodes, TypeId &tid, int port)
 {
     Ptr<Socket> recvSink = Socket::CreateSocket (nodes.Get(data.sinkNode), tid);
     InetSocketAddress local = InetSocketAddress (Ipv4Address::GetAny(), port);
     recvSink -> Bind (local);
-    recvSink -> SetRecvCallback (MakeCallback (&ReceivePacket));
+    Ptr<TrafficSink> sink = CreateObject<TrafficSink> ();
+    sink -> Setup (recvSink);
+    nodes.Get(data.sinkNode) -> AddApplication (sink);
+    return (sink);
 }
 
-void
+Ptr<TrafficGenerator>
 Send (Data &data, NodeContainer &nodes, TypeId &tid, int port, Ipv4InterfaceContainer &interface)
 {
     Ptr<Socket> source = Socket::CreateSocket (nodes.Get(data.sourceNode), tid);
     InetSocketAddress remote = InetSocketAddress (interface.GetAddress (data.sinkNode, 0), port);
     source -> Connect (remote);
+
+    Ptr<TrafficGenerator> generator = CreateObject<TrafficGenerator> ();
+    generator -> Setup (source, data.sourceNode);
+    generator -> SetAttribute ("Mode",       StringValue (data.traffic));
+    generator -> SetAttribute ("PacketSize", UintegerValue (data.packetSize));
+    generator -> SetAttribute ("MaxPackets", UintegerValue (data.numPackets));
+    generator -> SetAttribute ("Interval",   TimeValue (Seconds (data.interval)));
+    generator -> SetAttribute ("TraceFile",  StringValue (data.trafficTrace));
+    generator -> SetStartTime (Seconds (data.trafficStart));
+    nodes.Get(data.sourceNode) -> AddApplication (generator);
+    return (generator);
 }
 
-void
-tracing (Data &data, OlsrHelper &olsr, YansWifiPhyHelper &wifiPhy, NetDeviceContainer &devices)
+/**
+ * Schedule data.failures on the nodes' wifi devices; null when there are
+ * none. OLSR notices on its own, so no routes are recomputed
+ */
+Ptr<LinkFailureSchedule>
+Failures (Data &data, NetDeviceContainer &devices, Ptr<OutageMonitor> outages)
 {
-    if (data.tracing)
+    std::vector<FailureSpec> specs = LinkFailureSchedule::ParseSpec (data.failures);
+    if (specs.empty ())
     {
-        AsciiTraceHelper ascii;
-        wifiPhy.EnableAsciiAll (ascii.CreateFileStream ("trace/wifi-simple-adhoc-grid.tr"));
-        wifiPhy.EnablePcap ("trace/wifi-simple-adhoc-grid", devices);
-        // Trace routing tables
-        Ptr<OutputStreamWrapper> routingStream = Create<OutputStreamWrapper> ("trace/wifi-simple-adhoc-grid.routes", std::ios::out);
-        olsr.PrintRoutingTableAllEvery (Seconds (2), routingStream);
-        Ptr<OutputStreamWrapper> neighborStream = Create<OutputStreamWrapper> ("trace/wifi-simple-adhoc-grid.neighbors", std::ios::out);
-        olsr.PrintNeighborCacheAllEvery (Seconds (2), neighborStream);
+        return (0);
     }
-}
 
-void 
-ReceivePacket (Ptr<Socket> socket)
-{
-    while (socket->Recv())
+    Ptr<LinkFailureSchedule> failures = Create<LinkFailureSchedule> (false);
+    failures -> SetOutageMonitor (outages);
+    for (const FailureSpec &f : specs)
     {
-        NS_LOG_UNCOND ("Received one packet!");
+        char *end;
+        unsigned long node = std::strtoul (f.target.c_str (), &end, 10);
+        if (f.target.empty () || *end != '\0' || f.target[0] == '-' || node >= devices.GetN ())
+        {
+            NS_FATAL_ERROR ("Bad failure target \"" << f.target << "\" in " << data.failures
+                            << ", use a node number below " << devices.GetN ());
+        }
+        failures -> Add ("n" + f.target, NetDeviceContainer (devices.Get (node)), Seconds (f.down), Seconds (f.up));
     }
+    return (failures);
 }
 
-static void
-GenerateTraffic (Ptr<Socket> socket, uint32_t pktSize, uint32_t pktCount, Time pktInterval)
+void
+tracing (Data &data, OlsrHelper &olsr, WifiPhyHelper &wifiPhy, NetDeviceContainer &devices)
 {
-    if (pktCount > 0)
-    {
-        socket -> Send (Create<Packet> (pktSize));
-        Simulator::Schedule (pktInterval, &GenerateTraffic, socket, pktSize, pktCount-1, pktInterval);
-    }
-    else
+    if (data.tracing)
     {
-        socket -> Close();
+        ColumnarTraceHelper trace ("trace/wifi-simple-adhoc-grid.ctr");
+        trace.Install (devices);
+        wifiPhy.EnablePcap ("trace/wifi-simple-adhoc-grid", devices);
+        // Trace routing tables
+        Ptr<OutputStreamWrapper> routingStream = Create<OutputStreamWrapper> ("trace/wifi-simple-adhoc-grid.routes", std::ios::out);
+        olsr.PrintRoutingTableAllEvery (Seconds (2), routingStream);
+        Ptr<OutputStreamWrapper> neighborStream = Create<OutputStreamWrapper> ("trace/wifi-simple-adhoc-grid.neighbors", std::ios::out);
+        olsr.PrintNeighborCacheAllEvery (Seconds (2), neighborStream);
     }
-    
 }
@@ -21,6 +21,16 @@ public:
     double interval     = 1.0;      // seconds
     bool verbose        = false;
     bool tracing        = false;
+    std::string channel = "yans";   // yans, spectrum or spatial
+    bool cacheLoss      = true;     // memoize Friis loss per node pair
+    std::string scheduler = "";     // event scheduler, "auto" to probe
+    bool benchScheduler = false;    // compare every scheduler and exit
+    double warmup       = 5.0;      // simulated seconds per auto probe, after trafficStart
+    std::string traffic = "Cbr";    // Cbr, Poisson, OnOff or Trace
+    double trafficStart = 30.0;     // seconds, once OLSR has converged
+    std::string trafficTrace = "";  // "<seconds> <bytes>" lines for Trace
+    std::string failures = "";      // "<down>[-<up>]@<node>,...", that node's NIC goes down
+    double stopTime     = 33.0;     // seconds
 };
 
 
@@ -14,17 +14,45 @@ public:
      * payloadSize    = 1472
      * dataRate       = "100Mbps"
      * tcpVariant     = "TcpNewReno";
-     * phyRate        = "HtMcs7";
+     * phyRate        = "";
      * SimulationTime = 10;
      * pcaptracing    = false;
      * netanim        = false;
+     * sampleInterval = 0.1;
+     * numSta         = 1;
+     * radius         = 1.414;
+     * bulk           = false;
+     * maxAmpduSize   = 65535;
+     * maxAmsduSize   = 0;
+     * standard       = "80211n";
+     * channelWidth   = 20;
+     * guardInterval  = 800;
+     * rateManager    = "ConstantRate";
+     * mcs            = 7;
+     * matrix         = false;
+     * jobs           = 1;
+     * minThroughput  = 0;
      */
 
     uint32_t payloadSize   = 1472;
     std::string dataRate   = "100Mbps";
     std::string tcpVariant = "TcpNewReno";      // https://en.wikipedia.org/wiki/TCP_congestion_control#TCP_New_Reno
-    std::string phyRate    = "HtMcs7";
+    std::string phyRate    = "";                // empty: derived from standard and mcs
     double SimulationTime  = 10;
     bool pcaptracing       = false;
     bool netanim           = false;
+    double sampleInterval  = 0.1;               // seconds between throughput samples
+    uint32_t numSta        = 1;
+    double radius          = 1.414;             // metres from the AP to every STA
+    bool bulk              = false;             // BulkSend instead of OnOff at dataRate
+    uint32_t maxAmpduSize  = 65535;             // bytes, 0 disables A-MPDU
+    uint32_t maxAmsduSize  = 0;                 // bytes, 0 disables A-MSDU
+    std::string standard   = "80211n";          // 80211n, 80211ac or 80211ax
+    uint32_t channelWidth  = 20;                // MHz
+    uint32_t guardInterval = 800;               // ns, 400 is the HT/VHT short GI
+    std::string rateManager = "ConstantRate";   // ConstantRate, MinstrelHt or Ideal
+    uint32_t mcs           = 7;                 // single stream, ConstantRate only
+    bool matrix            = false;             // sweep width, GI and MCS for the peak
+    uint32_t jobs          = 1;                 // matrix runs in parallel
+    double minThroughput   = 0;                 // Mbit/s, below it the run fails; 0 disables
 };
@@ -7,7 +7,7 @@
  *      Run the following for more info on command-line arguments
  *      >> ./waf --run "scratch/<filename> --help"
  * 
- *      This is a simple example to test TCP over 802.11n (with MPDU aggregation enabled).
+ *      This is a simple example to test TCP over 802.11n/ac/ax (with MPDU aggregation enabled).
  * 
  *      Network topology:
  *
@@ -16,8 +16,30 @@
  *        |      |
  *        n1     n2
  *
+ *      With --numSta=N the N stations are spread evenly on a circle of
+ *      --radius metres around the AP, each with its own TCP flow (OnOff at
+ *      --dataRate, or saturating BulkSend with --bulk) to its own sink on
+ *      the AP. Per-STA goodput and Jain's fairness index are printed at the
+ *      end. --maxAmpduSize / --maxAmsduSize set the BE aggregation limits.
+ *
+ *      --standard=80211n|80211ac|80211ax, --channelWidth (20/40/80/160 MHz)
+ *      and --guardInterval (ns: 800/400 for n and ac, 800/1600/3200 for ax)
+ *      pick the PHY. --rateManager=ConstantRate uses --mcs (or --phyRate
+ *      if given), MinstrelHt and Ideal adapt the rate themselves.
+ *
+ *      --matrix sweeps every valid channel width, guard interval and MCS of
+ *      --standard (or of all three with --standard=all) at --radius with
+ *      saturating flows, one forked simulation per point (--jobs at a time),
+ *      and prints the goodput of each and the peak configuration.
+ *
+ *      --minThroughput=<Mbit/s> makes a run below that goodput exit with
+ *      status 1 (off by default; 50 suits the single 802.11n station at
+ *      MCS 7 this example started as).
+ *
  *      In this example, an HT station sends TCP packets to the access point.
- *      We report the total throughput received during a window of 100ms.
+ *      A ThroughputProbe samples the throughput received every
+ *      --sampleInterval (100ms by default) and the mean, moving average and
+ *      percentiles are reported at the end.
  *      The user can specify the application data rate and choose the variant
  *      of TCP i.e. congestion control algorithm to use.
  * 
@@ -28,6 +50,10 @@
  *          4. Throughput = ZERO
  */
 
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+
 #include "ns3/command-line.h"
 #include "ns3/config.h"
 #include "ns3/string.h"
@@ -36,6 +62,7 @@
 #include "ns3/ssid.h"
 #include "ns3/mobility-helper.h"
 #include "ns3/on-off-helper.h"
+#include "ns3/bulk-send-helper.h"
 #include "ns3/yans-wifi-channel.h"
 #include "ns3/mobility-model.h"
 #include "ns3/packet-sink.h"
@@ -47,36 +74,38 @@
 #include "ns3/netanim-module.h"
 
 #include "UserData.h"
+#include "../throughput-probe.h"
+#include "../child-runner.h"
 
 using namespace ns3;
 
 NS_LOG_COMPONENT_DEFINE("wifi-tcp");
 
-void CalculateThroughput();
 void init              (UserData &userData, int argc, char *argv[]);
 void SetupTCP          (std::string &tcpVariant, TypeId &tcpTid, uint32_t &payloadSize);
-void SetupWIFI         (std::string &phyRate, WifiMacHelper &wifiMac, 
+void SetupWIFI         (UserData &userData, WifiMacHelper &wifiMac, 
                        WifiHelper &wifiHelper, YansWifiPhyHelper &wifiPhy);
-void ConfigureNodes    (Ptr<Node> &apWifiNode, Ptr<Node> &staWifiNode, NetDeviceContainer &apDevice, 
+void ConfigureNodes    (Ptr<Node> &apWifiNode, NodeContainer &staNodes, uint32_t numSta, NetDeviceContainer &apDevice, 
                        NetDeviceContainer &staDevice, WifiHelper &wifiHelper, WifiMacHelper &wifiMac, 
                        YansWifiPhyHelper &wifiPhy, NodeContainer &networkNodes);
-void SetupMobility     (Ptr<Node> &apWifiNode, Ptr<Node> &staWifiNode);
+void SetupAggregation  (UserData &userData);
+void SetupPhy          (UserData &userData);
+void SetupMobility     (Ptr<Node> &apWifiNode, NodeContainer &staNodes, double radius);
 void InstallInternet   (Ipv4Address networkAddress, Ipv4Mask SubnetMask, NodeContainer &networkNodes, 
                        NetDeviceContainer &apDevice, NetDeviceContainer &staDevice, Ipv4InterfaceContainer &apInterface,
                        Ipv4InterfaceContainer &staInterface);
-void TcpRxAP           (Ptr<Node> &apWifiNode, int port, ApplicationContainer &sinkApp);
-void TcpTxSta          (Ptr<Node> &staWifiNode, int port, Ipv4InterfaceContainer &apInterface, 
-                       uint32_t &payloadSize, std::string &dataRate, ApplicationContainer &serverApp);
+void TcpRxAP           (Ptr<Node> &apWifiNode, int port, uint32_t numSta, ApplicationContainer &sinkApp,
+                       std::vector<Ptr<PacketSink> > &sinks);
+void TcpTxSta          (NodeContainer &staNodes, int port, Ipv4InterfaceContainer &apInterface, 
+                       uint32_t &payloadSize, std::string &dataRate, bool bulk, ApplicationContainer &serverApp);
 void StartApp          (ApplicationContainer &sinkApp, ApplicationContainer &serverApp);
 void tracing           (UserData &userData, YansWifiPhyHelper &wifiPhy, NetDeviceContainer &apDevice, 
                        NetDeviceContainer &staDevice);
-void AverageThroughput (UserData &userData);
-
-
-
-
-Ptr<PacketSink> sink;
-uint64_t lastTotalRx = 0;
+double AverageThroughput (UserData &userData, std::vector<Ptr<PacketSink> > &sinks, Ptr<ThroughputProbe> probe,
+                         bool report);
+double RunScenario     (UserData userData, bool report);
+void RunMatrix         (UserData &userData);
+bool ValidConfig       (const std::string &standard, uint32_t width, uint32_t gi, uint32_t mcs);
 
 
 
@@ -86,19 +115,44 @@ main (int argc, char *argv[])
     UserData userData;
     init(userData, argc, argv);
 
+    if (userData.matrix)
+    {
+        RunMatrix (userData);
+        return 0;
+    }
+
+    double averageThroughput = RunScenario (userData, true);
+    std::cout << "\nAverage throughput: " << averageThroughput << " Mbit/s" << std::endl;
+    if (averageThroughput < userData.minThroughput)
+    {
+        NS_LOG_ERROR ("Obtained throughput is not in the expected boundaries!");
+        return 1;
+    }
+    return 0;
+}
+
+
+/**
+ * Build the network, run it and return the aggregate goodput in Mbit/s
+ */
+double
+RunScenario (UserData userData, bool report)
+{
     TypeId tcpTid;
     SetupTCP (userData.tcpVariant, tcpTid, userData.payloadSize);
     WifiMacHelper wifiMac;
     WifiHelper wifiHelper;
     YansWifiPhyHelper wifiPhy = YansWifiPhyHelper::Default();
-    SetupWIFI (userData.phyRate, wifiMac, wifiHelper, wifiPhy);
+    SetupWIFI (userData, wifiMac, wifiHelper, wifiPhy);
     Ptr<Node> apWifiNode;
-    Ptr<Node> staWifiNode;
+    NodeContainer staNodes;
     NodeContainer networkNodes;
     NetDeviceContainer apDevice; 
     NetDeviceContainer staDevice;
-    ConfigureNodes(apWifiNode, staWifiNode, apDevice, staDevice, wifiHelper, wifiMac, wifiPhy, networkNodes);
-    SetupMobility(apWifiNode, staWifiNode);
+    ConfigureNodes(apWifiNode, staNodes, userData.numSta, apDevice, staDevice, wifiHelper, wifiMac, wifiPhy, networkNodes);
+    SetupAggregation(userData);
+    SetupPhy(userData);
+    SetupMobility(apWifiNode, staNodes, userData.radius);
     Ipv4InterfaceContainer apInterface; 
     Ipv4InterfaceContainer staInterface;
     InstallInternet("10.1.1.0", "255.255.255.0", networkNodes, apDevice, staDevice, apInterface, staInterface);
@@ -108,45 +162,165 @@ main (int argc, char *argv[])
     int port = 12345; 
     ApplicationContainer sinkApp;
     ApplicationContainer serverApp;
-    TcpRxAP (apWifiNode, port, sinkApp);
-    TcpTxSta (staWifiNode, port, apInterface, userData.payloadSize, userData.dataRate, serverApp);
+    std::vector<Ptr<PacketSink> > sinks;
+    TcpRxAP (apWifiNode, port, userData.numSta, sinkApp, sinks);
+    TcpTxSta (staNodes, port, apInterface, userData.payloadSize, userData.dataRate, userData.bulk, serverApp);
     
     StartApp (sinkApp, serverApp);
-    Simulator::Schedule (Seconds(1.1), &CalculateThroughput);
+    Ptr<ThroughputProbe> probe = Create<ThroughputProbe> (Seconds (userData.sampleInterval));
+    for (uint32_t i = 0; i < sinks.size (); ++i)
+    {
+        probe->Add (sinks[i], "sta" + std::to_string (i));
+    }
+    probe->Start (Seconds (1.0));
     
     tracing(userData, wifiPhy, apDevice, staDevice);
     
     Simulator::Stop (Seconds (userData.SimulationTime + 1));
     Simulator::Run();
-    // Simulator::Destroy(); is called in AverageThroughput()
-    AverageThroughput(userData);
-    return 0;
+    double averageThroughput = AverageThroughput(userData, sinks, probe, report);
+    Simulator::Destroy();
+    return (averageThroughput);
+}
+
+
+struct MatrixPoint
+{
+    std::string standard;
+    uint32_t width;
+    uint32_t gi;
+    uint32_t mcs;
+    bool ok;
+    double goodput;
+};
+
+
+bool
+ValidConfig (const std::string &standard, uint32_t width, uint32_t gi, uint32_t mcs)
+{
+    if (standard == "80211n")
+    {
+        return (width <= 40 && (gi == 800 || gi == 400) && mcs <= 7);
+    }
+    if (standard == "80211ac")
+    {
+        // VhtMcs9 is not defined for one stream at 20 MHz
+        return ((gi == 800 || gi == 400) && mcs <= 9 && !(mcs == 9 && width == 20));
+    }
+    return ((gi == 800 || gi == 1600 || gi == 3200) && mcs <= 11);
 }
 
 
 void
-CalculateThroughput ()
+RunMatrix (UserData &userData)
 {
-    Time now = Simulator::Now ();
-    double cur = (sink -> GetTotalRx () - lastTotalRx) * (double) 8 / 1e5; // Convert Application RX Packets to MBits.
-    std::cout << now.GetSeconds () << "s: \t" << cur << " Mbit/s" << std::endl;
-    lastTotalRx = sink -> GetTotalRx ();
-    Simulator::Schedule (MilliSeconds (100), &CalculateThroughput);
+    std::vector<std::string> standards;
+    if (userData.standard == "all")
+    {
+        standards = { "80211n", "80211ac", "80211ax" };
+    }
+    else
+    {
+        standards.push_back (userData.standard);
+    }
+
+    std::vector<MatrixPoint> points;
+    for (const std::string &standard : standards)
+    {
+        for (uint32_t width : { 20, 40, 80, 160 })
+        {
+            for (uint32_t gi : { 3200, 1600, 800, 400 })
+            {
+                for (uint32_t mcs = 0; mcs <= 11; ++mcs)
+                {
+                    if (ValidConfig (standard, width, gi, mcs))
+                    {
+                        points.push_back ({ standard, width, gi, mcs, false, 0 });
+                    }
+                }
+            }
+        }
+    }
+    std::cout << "Matrix: " << points.size () << " runs at " << userData.radius << " m" << std::endl;
+
+    // each point runs in a forked child so every simulation starts clean,
+    // the goodput comes back through a pipe
+    ChildRunner::Run (points.size (), userData.jobs,
+        [&] (size_t i)
+        {
+            std::cout.setstate (std::ios::failbit);
+            UserData run = userData;
+            run.standard = points[i].standard;
+            run.channelWidth = points[i].width;
+            run.guardInterval = points[i].gi;
+            run.mcs = points[i].mcs;
+            run.rateManager = "ConstantRate";
+            run.phyRate = "";
+            run.bulk = true;
+            run.pcaptracing = false;
+            run.netanim = false;
+            double goodput = RunScenario (run, false);
+            return ChildRunner::Pack (&goodput, 1);
+        },
+        [&] (size_t i, bool ok, const std::string &bytes)
+        {
+            points[i].ok = ok && ChildRunner::Unpack (bytes, &points[i].goodput, 1);
+        });
+
+    std::cout << std::left << std::setw (10) << "standard" << std::right
+              << std::setw (8) << "MHz" << std::setw (8) << "GI ns" << std::setw (6) << "MCS"
+              << std::setw (14) << "Mbit/s" << std::endl;
+    const MatrixPoint *best = NULL;
+    for (const MatrixPoint &point : points)
+    {
+        std::cout << std::left << std::setw (10) << point.standard << std::right
+                  << std::setw (8) << point.width << std::setw (8) << point.gi << std::setw (6) << point.mcs;
+        if (point.ok)
+        {
+            std::cout << std::setw (14) << std::fixed << std::setprecision (2) << point.goodput << std::endl;
+            std::cout.unsetf (std::ios::floatfield);
+        }
+        else
+        {
+            std::cout << std::setw (14) << "failed" << std::endl;
+        }
+        if (point.ok && (best == NULL || point.goodput > best->goodput))
+        {
+            best = &point;
+        }
+    }
+    if (best)
+    {
+        std::cout << "\nPeak at " << userData.radius << " m: " << best->standard << " " << best->width
+                  << " MHz, GI " << best->gi << " ns, MCS " << best->mcs << ": " << best->goodput
+                  << " Mbit/s" << std::endl;
+    }
 }
 
 
-void 
-AverageThroughput(UserData &userData)
+double 
+AverageThroughput(UserData &userData, std::vector<Ptr<PacketSink> > &sinks, Ptr<ThroughputProbe> probe, bool report)
 {
-    double averageThroughput = ((sink->GetTotalRx () * 8) / (1e6 * userData.SimulationTime));
-    
-    Simulator::Destroy();
-    if (averageThroughput < 50)
+    // goodput over the whole run, the probe only sees whole intervals
+    uint64_t totalRx = 0;
+    std::vector<double> goodput;
+    for (Ptr<PacketSink> sink : sinks)
     {
-        NS_LOG_ERROR ("Obtained throughput is not in the expected boundaries!");
-        exit (1);
+        totalRx += sink->GetTotalRx ();
+        goodput.push_back (sink->GetTotalRx () * 8 / (1e6 * userData.SimulationTime));
     }
-    std::cout << "\nAverage throughput: " << averageThroughput << " Mbit/s" << std::endl;
+    double averageThroughput = ((totalRx * 8) / (1e6 * userData.SimulationTime));
+    if (!report)
+    {
+        return (averageThroughput);
+    }
+    std::cout << std::endl;
+    probe->Report (std::cout);
+    std::cout << "\nStations: " << sinks.size ()
+              << "  min goodput: " << *std::min_element (goodput.begin (), goodput.end ()) << " Mbit/s"
+              << "  max goodput: " << *std::max_element (goodput.begin (), goodput.end ()) << " Mbit/s"
+              << "  Jain's fairness index: " << JainIndex (goodput) << std::endl;
+    return (averageThroughput);
 }
 
 
@@ -158,10 +332,23 @@ init(class UserData &userData, int argc, char *argv[])
      * payloadSize    = 1472
      * dataRate       = "100Mbps"
      * tcpVariant     = "TcpNewReno"
-     * phyRate        = "HtMcs7"
+     * phyRate        = ""
      * SimulationTime = 10
      * pcaptracing    = false
      * netanim        = false
+     * sampleInterval = 0.1
+     * numSta         = 1
+     * radius         = 1.414
+     * bulk           = false
+     * maxAmpduSize   = 65535
+     * maxAmsduSize   = 0
+     * standard       = "80211n"
+     * channelWidth   = 20
+     * guardInterval  = 800
+     * rateManager    = "ConstantRate"
+     * mcs            = 7
+     * matrix         = false
+     * jobs           = 1
      */
 
     CommandLine cmd;
@@ -170,11 +357,35 @@ init(class UserData &userData, int argc, char *argv[])
     cmd.AddValue ("tcpVariant",    "Transport protocol to use: TcpNewReno, "
                   "TcpHybla, TcpHighSpeed, TcpHtcp, TcpVegas, TcpScalable, TcpVeno, "
                   "TcpBic, TcpYeah, TcpIllinois, TcpWestwood, TcpWestwoodPlus, TcpLedbat ", userData.tcpVariant);
-    cmd.AddValue("phyRate",        "Physical layer bitrate",     userData.phyRate);
+    cmd.AddValue("phyRate",        "Physical layer bitrate, overrides mcs", userData.phyRate);
     cmd.AddValue("SimulationTime", "Simulation Time in seconds", userData.SimulationTime);
     cmd.AddValue("pcaptracing",    "Enable pcap tracing",        userData.pcaptracing);
     cmd.AddValue("netanim",        "Enable NetAnim",             userData.netanim);
+    cmd.AddValue("sampleInterval", "Seconds between throughput samples", userData.sampleInterval);
+    cmd.AddValue("numSta",         "Number of stations associated to the AP", userData.numSta);
+    cmd.AddValue("radius",         "Distance of the stations from the AP in metres", userData.radius);
+    cmd.AddValue("bulk",           "Saturating BulkSend flows instead of OnOff at dataRate", userData.bulk);
+    cmd.AddValue("maxAmpduSize",   "Maximum A-MPDU size in bytes (0 disables)", userData.maxAmpduSize);
+    cmd.AddValue("maxAmsduSize",   "Maximum A-MSDU size in bytes (0 disables)", userData.maxAmsduSize);
+    cmd.AddValue("standard",       "80211n, 80211ac or 80211ax (all with --matrix)", userData.standard);
+    cmd.AddValue("channelWidth",   "Channel width in MHz: 20, 40, 80 or 160", userData.channelWidth);
+    cmd.AddValue("guardInterval",  "Guard interval in ns: 800/400 (n, ac), 800/1600/3200 (ax)", userData.guardInterval);
+    cmd.AddValue("rateManager",    "ConstantRate, MinstrelHt or Ideal", userData.rateManager);
+    cmd.AddValue("mcs",            "MCS index for ConstantRate", userData.mcs);
+    cmd.AddValue("matrix",         "Sweep width, GI and MCS and report the peak goodput", userData.matrix);
+    cmd.AddValue("jobs",           "Matrix simulations run in parallel", userData.jobs);
+    cmd.AddValue("minThroughput",  "Exit with status 1 below this goodput in Mbit/s (0 disables)", userData.minThroughput);
     cmd.Parse(argc, argv);
+    bool known = userData.standard == "80211n" || userData.standard == "80211ac" || userData.standard == "80211ax"
+                 || (userData.matrix && userData.standard == "all");
+    NS_ABORT_MSG_UNLESS (known, "Unknown standard " << userData.standard);
+    NS_ABORT_MSG_IF (!userData.matrix && !ValidConfig (userData.standard, userData.channelWidth, userData.guardInterval,
+                                                       userData.rateManager == "ConstantRate" ? userData.mcs : 0),
+                     "Channel width, guard interval or MCS not valid for " << userData.standard);
+    NS_ABORT_MSG_IF (userData.rateManager == "MinstrelHt" && userData.standard == "80211ax",
+                     "MinstrelHt does not support 802.11ax rates");
+    // one /24 holds the AP and up to 253 stations
+    NS_ABORT_MSG_IF (userData.numSta < 1 || userData.numSta > 253, "numSta must be between 1 and 253");
     std::cout << "Init Done" << std::endl;
 }     
 
@@ -184,10 +395,10 @@ SetupTCP(std::string &tcpVariant, TypeId &tcpTid, uint32_t &payloadSize)
 {   
     tcpVariant = std::string ("ns3::") + tcpVariant;
 
-    if (tcpVariant.compare ("ns3::tcpWestwoodPlus") == 0)
+    if (tcpVariant.compare ("ns3::TcpWestwoodPlus") == 0)
     {
         // TcpWestwoodplus is not TypeId name; we need TcpWestwood
-        Config::SetDefault ("ns3::TcplProtocol::SocketType", TypeIdValue (TcpWestwood::GetTypeId()));
+        Config::SetDefault ("ns3::TcpL4Protocol::SocketType", TypeIdValue (TcpWestwood::GetTypeId()));
         // default is WESTWOOD; set to WESTWOODPLUS 
         Config::SetDefault ("ns3::TcpWestwood::ProtocolType", EnumValue (TcpWestwood::WESTWOODPLUS));
     }
@@ -205,9 +416,24 @@ SetupTCP(std::string &tcpVariant, TypeId &tcpTid, uint32_t &payloadSize)
 
 
 void
-SetupWIFI (std::string &phyRate, WifiMacHelper &wifiMac, WifiHelper &wifiHelper, YansWifiPhyHelper &wifiPhy)
+SetupWIFI (UserData &userData, WifiMacHelper &wifiMac, WifiHelper &wifiHelper, YansWifiPhyHelper &wifiPhy)
 {
-    wifiHelper.SetStandard(WIFI_PHY_STANDARD_80211n_5GHZ);
+    std::string prefix;
+    if (userData.standard == "80211ac")
+    {
+        wifiHelper.SetStandard(WIFI_PHY_STANDARD_80211ac);
+        prefix = "VhtMcs";
+    }
+    else if (userData.standard == "80211ax")
+    {
+        wifiHelper.SetStandard(WIFI_PHY_STANDARD_80211ax_5GHZ);
+        prefix = "HeMcs";
+    }
+    else
+    {
+        wifiHelper.SetStandard(WIFI_PHY_STANDARD_80211n_5GHZ);
+        prefix = "HtMcs";
+    }
 
     /* Setup legacy channel */
     YansWifiChannelHelper wifiChannel;
@@ -217,20 +443,36 @@ SetupWIFI (std::string &phyRate, WifiMacHelper &wifiMac, WifiHelper &wifiHelper,
     /* Setup Physical Later */
     wifiPhy.SetChannel(wifiChannel.Create());
     wifiPhy.SetErrorRateModel("ns3::YansErrorRateModel");
-    wifiHelper.SetRemoteStationManager ("ns3::ConstantRateWifiManager",
-                                        "DataMode", StringValue(phyRate),
-                                        "ControlMode", StringValue("HtMcs0"));
+    if (userData.rateManager == "MinstrelHt")
+    {
+        wifiHelper.SetRemoteStationManager ("ns3::MinstrelHtWifiManager");
+    }
+    else if (userData.rateManager == "Ideal")
+    {
+        wifiHelper.SetRemoteStationManager ("ns3::IdealWifiManager");
+    }
+    else
+    {
+        NS_ABORT_MSG_UNLESS (userData.rateManager == "ConstantRate", "Unknown rate manager " << userData.rateManager);
+        std::string phyRate = userData.phyRate.empty () ? prefix + std::to_string (userData.mcs) : userData.phyRate;
+        wifiHelper.SetRemoteStationManager ("ns3::ConstantRateWifiManager",
+                                            "DataMode", StringValue(phyRate),
+                                            "ControlMode", StringValue(prefix + "0"));
+    }
     std::cout << "Wifi Setup" << std::endl;
     
 }
 
 
 void
-ConfigureNodes (Ptr<Node> &apWifiNode, Ptr<Node> &staWifiNode, NetDeviceContainer &apDevice, NetDeviceContainer &staDevice, WifiHelper &wifiHelper, WifiMacHelper &wifiMac,  YansWifiPhyHelper &wifiPhy, NodeContainer &networkNodes)
+ConfigureNodes (Ptr<Node> &apWifiNode, NodeContainer &staNodes, uint32_t numSta, NetDeviceContainer &apDevice, NetDeviceContainer &staDevice, WifiHelper &wifiHelper, WifiMacHelper &wifiMac,  YansWifiPhyHelper &wifiPhy, NodeContainer &networkNodes)
 {
-    networkNodes.Create(2);
+    networkNodes.Create(1 + numSta);
     apWifiNode = networkNodes.Get(0);
-    staWifiNode = networkNodes.Get(1);
+    for (uint32_t i = 1; i <= numSta; ++i)
+    {
+        staNodes.Add(networkNodes.Get(i));
+    }
 
     /* Configure AP */
     Ssid ssid  = Ssid ("network");
@@ -243,24 +485,61 @@ ConfigureNodes (Ptr<Node> &apWifiNode, Ptr<Node> &staWifiNode, NetDeviceContaine
     wifiMac.SetType ("ns3::StaWifiMac",
                      "Ssid", SsidValue (ssid));
 
-    staDevice = wifiHelper.Install (wifiPhy, wifiMac, staWifiNode);
+    staDevice = wifiHelper.Install (wifiPhy, wifiMac, staNodes);
     std::cout << "Nodes Configured" << std::endl;
 
 }   
 
+
+void
+SetupAggregation (UserData &userData)
+{
+    // TCP data and ACKs both ride the best effort queue
+    Config::Set ("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/Mac/BE_MaxAmpduSize",
+                 UintegerValue (userData.maxAmpduSize));
+    Config::Set ("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/Mac/BE_MaxAmsduSize",
+                 UintegerValue (userData.maxAmsduSize));
+    std::cout << "Aggregation Setup" << std::endl;
+}
+
+
+void
+SetupPhy (UserData &userData)
+{
+    Config::Set ("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/Phy/ChannelWidth",
+                 UintegerValue (userData.channelWidth));
+    if (userData.standard == "80211ax")
+    {
+        Config::Set ("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/HeConfiguration/GuardInterval",
+                     TimeValue (NanoSeconds (userData.guardInterval)));
+    }
+    else
+    {
+        Config::Set ("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/HtConfiguration/ShortGuardIntervalSupported",
+                     BooleanValue (userData.guardInterval == 400));
+    }
+    std::cout << "Phy Setup" << std::endl;
+}
+
+
 void
-SetupMobility (Ptr<Node> &apWifiNode, Ptr<Node> &staWifiNode)
+SetupMobility (Ptr<Node> &apWifiNode, NodeContainer &staNodes, double radius)
 {
     MobilityHelper mobility;
     Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
 
     positionAlloc -> Add (Vector (0.0, 0.0, 0.0));
-    positionAlloc -> Add (Vector (1.0, 1.0, 0.0));
+    // evenly on a circle, the first one at 45 degrees i.e. (1, 1) for the default radius
+    for (uint32_t i = 0; i < staNodes.GetN (); ++i)
+    {
+        double angle = M_PI / 4 + 2 * M_PI * i / staNodes.GetN ();
+        positionAlloc -> Add (Vector (radius * std::cos (angle), radius * std::sin (angle), 0.0));
+    }
 
     mobility.SetPositionAllocator (positionAlloc);
     mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
     mobility.Install (apWifiNode);
-    mobility.Install (staWifiNode);
+    mobility.Install (staNodes);
     std::cout << "Mobility Setup" << std::endl;
 }
 
@@ -282,26 +561,45 @@ InstallInternet (Ipv4Address networkAddress, Ipv4Mask SubnetMask, NodeContainer
 
 
 void
-TcpRxAP (Ptr<Node> &apWifiNode, int port, ApplicationContainer &sinkApp)
+TcpRxAP (Ptr<Node> &apWifiNode, int port, uint32_t numSta, ApplicationContainer &sinkApp,
+         std::vector<Ptr<PacketSink> > &sinks)
 {
-    PacketSinkHelper sinkHelper ("ns3::TcpSocketFactory", InetSocketAddress (Ipv4Address::GetAny(), port));
-    sinkApp = sinkHelper.Install(apWifiNode);
-    sink = StaticCast<PacketSink> (sinkApp.Get(0));
+    // one sink per station so goodput can be told apart
+    for (uint32_t i = 0; i < numSta; ++i)
+    {
+        PacketSinkHelper sinkHelper ("ns3::TcpSocketFactory", InetSocketAddress (Ipv4Address::GetAny(), port + i));
+        ApplicationContainer app = sinkHelper.Install(apWifiNode);
+        sinks.push_back (StaticCast<PacketSink> (app.Get(0)));
+        sinkApp.Add(app);
+    }
     std::cout << "TCP Receiver Setup at AP" << std::endl;
 }
 
 
 void
-TcpTxSta (Ptr<Node> &staWifiNode, int port, Ipv4InterfaceContainer &apInterface, uint32_t &payloadSize, std::string &dataRate,
-          ApplicationContainer &serverApp)
+TcpTxSta (NodeContainer &staNodes, int port, Ipv4InterfaceContainer &apInterface, uint32_t &payloadSize, std::string &dataRate,
+          bool bulk, ApplicationContainer &serverApp)
 {
-
-    OnOffHelper server ("ns3::TcpSocketFactory", InetSocketAddress (Ipv4Address::GetAny(), port));
-    server.SetAttribute("PacketSize", UintegerValue(payloadSize));
-    server.SetAttribute("OnTime", StringValue("ns3::ConstantRandomVariable[Constant=1]"));
-    server.SetAttribute("OffTime", StringValue("ns3::ConstantRandomVariable[Constant=0]"));
-    server.SetAttribute("DataRate", DataRateValue(DataRate(dataRate)));
-    serverApp = server.Install(staWifiNode);
+    for (uint32_t i = 0; i < staNodes.GetN (); ++i)
+    {
+        InetSocketAddress remote (apInterface.GetAddress (0), port + i);
+        if (bulk)
+        {
+            BulkSendHelper server ("ns3::TcpSocketFactory", remote);
+            server.SetAttribute("SendSize", UintegerValue(payloadSize));
+            server.SetAttribute("MaxBytes", UintegerValue(0));
+            serverApp.Add(server.Install(staNodes.Get (i)));
+        }
+        else
+        {
+            OnOffHelper server ("ns3::TcpSocketFactory", remote);
+            server.SetAttribute("PacketSize", UintegerValue(payloadSize));
+            server.SetAttribute("OnTime", StringValue("ns3::ConstantRandomVariable[Constant=1]"));
+            server.SetAttribute("OffTime", StringValue("ns3::ConstantRandomVariable[Constant=0]"));
+            server.SetAttribute("DataRate", DataRateValue(DataRate(dataRate)));
+            serverApp.Add(server.Install(staNodes.Get (i)));
+        }
+    }
     std::cout << "TCP Transmitter Setup at STA" << std::endl;
 }
 
@@ -0,0 +1,176 @@
+/*
+Created on Mon Oct 19 23:58:51 2026
+
+@author: Harshil
+*/
+
+
+/*  Precomputes the next-hop matrix of a graph (nexthop-matrix.h) and saves
+    it, so a simulation can load it instead of running its own SPF.
+
+    Reads the kruskalMST.cpp edge list from a file (the ns-3 exporter in
+    ns3/p2p-grid/ipv4-nexthop-routing.h writes one) or makes a rows x cols
+    grid with -g, runs Dijkstra from every vertex on -j threads and prints
+    the time taken, then optionally
+        -o <file>   saves the matrix
+        -p s,d      prints the path from s to d by following the matrix
+        -c <k>      checks k random pairs: following the matrix has to
+                    reach d at the distance a single-source Dijkstra finds
+
+    Build and run
+        g++ -O2 -std=c++17 -pthread -o nexthop-matrix nexthop-matrix.cpp
+        ./nexthop-matrix -g 100x100 -j 8 -c 1000
+        ./nexthop-matrix -o grid.nhm grid.graph
+*/
+
+#include <bits/stdc++.h>
+
+#include "nexthop-matrix.h"
+
+using namespace std;
+
+
+static NexthopGraph makeGrid(uint32_t rows, uint32_t cols) {
+    // The graph NexthopTable exports from a PointToPointGrid_Helper grid:
+    // (r, c) is r*cols + c and each vertex adds its right, then its down
+    // link, so the ports match and a saved matrix can be loaded for it
+    NexthopGraph g(rows * cols);
+    for (uint32_t r = 0; r < rows; ++r) {
+        for (uint32_t c = 0; c < cols; ++c) {
+            if (c + 1 < cols)
+                g.addEdge(r * cols + c, r * cols + c + 1, 1);
+            if (r + 1 < rows)
+                g.addEdge(r * cols + c, (r + 1) * cols + c, 1);
+        }
+    }
+    return g;
+}
+
+
+static vector<uint64_t> distances(const NexthopGraph &g, uint32_t src) {
+    vector<uint64_t> dist(g.numVertices(), numeric_limits<uint64_t>::max());
+    set< pair<uint64_t, uint32_t> > setds;
+    dist[src] = 0;
+    setds.insert({0, src});
+    while (!setds.empty()) {
+        uint32_t u = setds.begin()->second;
+        setds.erase(setds.begin());
+        for (const NexthopGraph::Port &p : g.ports(u)) {
+            if (dist[p.vertex] > dist[u] + p.weight) {
+                setds.erase({dist[p.vertex], p.vertex});
+                dist[p.vertex] = dist[u] + p.weight;
+                setds.insert({dist[p.vertex], p.vertex});
+            }
+        }
+    }
+    return dist;
+}
+
+
+// Follows the matrix from s to d; returns false if it loops or dead-ends
+static bool follow(const NexthopGraph &g, const NexthopMatrix &m, uint32_t s, uint32_t d,
+                   uint64_t &cost, vector<uint32_t> *path) {
+    cost = 0;
+    if (path)
+        path->assign(1, s);
+    for (uint32_t steps = 0; s != d; ++steps) {
+        uint8_t port = m.hop(s, d);
+        if (port == NEXTHOP_NONE || port >= g.ports(s).size() || steps > g.numVertices())
+            return false;
+        cost += g.ports(s)[port].weight;
+        s = g.ports(s)[port].vertex;
+        if (path)
+            path->push_back(s);
+    }
+    return true;
+}
+
+
+int main(int argc, char *argv[]) {
+    unsigned threads = 0;
+    const char *output = NULL;
+    const char *grid = NULL;
+    long pathSrc = -1, pathDst = -1;
+    long checks = 0;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "j:o:g:p:c:")) != -1) {
+        switch (opt) {
+            case 'j': threads = atoi(optarg); break;
+            case 'o': output = optarg; break;
+            case 'g': grid = optarg; break;
+            case 'p': sscanf(optarg, "%ld,%ld", &pathSrc, &pathDst); break;
+            case 'c': checks = atol(optarg); break;
+            default: break;
+        }
+    }
+    if ((grid == NULL) == (optind == argc)) {
+        fprintf(stderr, "Script Usage: %s [-j threads] [-o matrix] [-p s,d] [-c checks] "
+                        "<graph file> | -g <rows>x<cols>\n", argv[0]);
+        return 1;
+    }
+
+    NexthopGraph g;
+    if (grid) {
+        unsigned rows, cols;
+        if (sscanf(grid, "%ux%u", &rows, &cols) != 2 || rows < 1 || cols < 1) {
+            fprintf(stderr, "Bad grid %s, use <rows>x<cols>\n", grid);
+            return 1;
+        }
+        g = makeGrid(rows, cols);
+    } else {
+        string error;
+        if (!g.read(argv[optind], error)) {
+            fprintf(stderr, "%s: %s\n", argv[optind], error.c_str());
+            return 1;
+        }
+    }
+
+    NexthopMatrix m;
+    auto start = chrono::steady_clock::now();
+    m.compute(g, threads);
+    double secs = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    printf("%u vertices, %llu edges: matrix in %.3f s, %.1f MB\n", g.numVertices(),
+           (unsigned long long)g.numEdges(), secs, m.memory() / 1048576.0);
+
+    if (output && !m.save(output)) {
+        fprintf(stderr, "Cannot write %s\n", output);
+        return 1;
+    }
+
+    if (pathSrc >= 0) {
+        if (pathSrc >= g.numVertices() || pathDst < 0 || pathDst >= g.numVertices()) {
+            fprintf(stderr, "No such pair %ld,%ld\n", pathSrc, pathDst);
+            return 1;
+        }
+        uint64_t cost;
+        vector<uint32_t> path;
+        if (!follow(g, m, pathSrc, pathDst, cost, &path)) {
+            printf("%ld -> %ld unreachable\n", pathSrc, pathDst);
+        } else {
+            printf("%ld -> %ld cost %llu:", pathSrc, pathDst, (unsigned long long)cost);
+            for (uint32_t v : path)
+                printf(" %u", v);
+            printf("\n");
+        }
+    }
+
+    mt19937 rng(1);
+    long bad = 0;
+    for (long i = 0; i < checks && g.numVertices() > 0; ++i) {
+        uint32_t s = rng() % g.numVertices();
+        uint32_t d = rng() % g.numVertices();
+        vector<uint64_t> dist = distances(g, s);
+        uint64_t cost;
+        bool reached = follow(g, m, s, d, cost, NULL);
+        bool reachable = dist[d] != numeric_limits<uint64_t>::max();
+        if (reached != reachable || (reached && cost != dist[d])) {
+            fprintf(stderr, "Pair %u -> %u: matrix %s cost %llu, Dijkstra %llu\n", s, d,
+                    reached ? "gives" : "fails,", (unsigned long long)cost, (unsigned long long)dist[d]);
+            ++bad;
+        }
+    }
+    if (checks > 0)
+        printf("%ld of %ld pairs checked wrong\n", bad, checks);
+    return bad ? 1 : 0;
+}
@@ -0,0 +1,282 @@
+/*
+Created on Mon Oct 19 23:57:36 2026
+
+@author: Harshil
+*/
+
+
+/*  All-pairs next hops with Dijkstra from every source, the same search as
+    dijkstra.cpp but with a binary heap instead of a set and run on several
+    threads, one source at a time each. Graphs whose edges all weigh the
+    same (a p2p grid) take a breadth-first search instead.
+
+    Graph format is the edge list of kruskalMST.cpp:
+
+        <numVertices> <numEdges>
+        <src> <dest> <weight>       one line per undirected edge
+
+    Ports: the edges of a vertex are numbered in the order they appear in
+    the list, counting both ends. The result is a numVertices^2 matrix of
+    ports, row = source, so hop(s, d) is the port s forwards on towards d;
+    NEXTHOP_NONE for s == d and unreachable pairs. One byte per pair keeps
+    a 10k vertex matrix at 100 MB; vertices need fewer than 255 edges.
+
+    Saved matrices start with a NexthopMatrixHeader, then the rows.
+*/
+
+#ifndef NEXTHOP_MATRIX_H
+#define NEXTHOP_MATRIX_H
+
+#include <stdint.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+
+#define NEXTHOP_MAGIC       "NHMATRX"
+#define NEXTHOP_VERSION     1
+#define NEXTHOP_NONE        0xff
+#define NEXTHOP_MAX_PORTS   NEXTHOP_NONE    // ports 0 .. 254 fit the byte
+
+
+struct NexthopMatrixHeader {
+    char magic[8];          // NEXTHOP_MAGIC, nul terminated
+    uint32_t version;       // NEXTHOP_VERSION
+    uint32_t numVertices;
+};
+
+
+class NexthopGraph {
+    public:
+        struct Port {
+            uint32_t vertex;    // at the other end
+            uint32_t weight;
+        };
+
+        NexthopGraph(uint32_t numVertices = 0) : adj(numVertices) {}
+
+        uint32_t numVertices() const { return adj.size(); }
+
+        uint64_t numEdges() const { return edges; }
+
+        // Every edge has the same weight, a breadth-first search will do
+        bool uniform() const { return uniformWeights; }
+
+        // Both ends get their next port. Returns false, adding nothing,
+        // when either end already has the most ports a byte can number
+        bool addEdge(uint32_t u, uint32_t v, uint32_t w) {
+            if (adj[u].size() + (u == v) >= NEXTHOP_MAX_PORTS || adj[v].size() >= NEXTHOP_MAX_PORTS)
+                return false;
+            adj[u].push_back({v, w});
+            adj[v].push_back({u, w});
+            if (edges == 0)
+                firstWeight = w;
+            else if (w != firstWeight)
+                uniformWeights = false;
+            ++edges;
+            return true;
+        }
+
+        const std::vector<Port> &ports(uint32_t u) const { return adj[u]; }
+
+        // Returns false and leaves error set on a malformed file
+        bool read(const char *path, std::string &error) {
+            FILE *in = fopen(path, "r");
+            if (!in) {
+                error = std::string("cannot open ") + path;
+                return false;
+            }
+            unsigned long numVertices, numEdges;
+            if (fscanf(in, "%lu %lu", &numVertices, &numEdges) != 2) {
+                error = "missing \"<numVertices> <numEdges>\" line";
+                fclose(in);
+                return false;
+            }
+            adj.assign(numVertices, std::vector<Port>());
+            edges = 0;
+            uniformWeights = true;
+            for (unsigned long i = 0; i < numEdges; ++i) {
+                unsigned long u, v, w;
+                if (fscanf(in, "%lu %lu %lu", &u, &v, &w) != 3 || u >= numVertices || v >= numVertices) {
+                    error = "bad edge " + std::to_string(i);
+                    fclose(in);
+                    return false;
+                }
+                if (!addEdge(u, v, w)) {
+                    error = "edge " + std::to_string(i) + " gives a vertex more than "
+                            + std::to_string(NEXTHOP_MAX_PORTS) + " edges";
+                    fclose(in);
+                    return false;
+                }
+            }
+            fclose(in);
+            return true;
+        }
+
+    private:
+        std::vector< std::vector<Port> > adj;
+        uint64_t edges = 0;
+        uint32_t firstWeight = 0;
+        bool uniformWeights = true;
+};
+
+
+class NexthopMatrix {
+    public:
+        uint32_t numVertices() const { return n; }
+
+        // Port of source towards dest, NEXTHOP_NONE if there is none
+        uint8_t hop(uint32_t source, uint32_t dest) const {
+            return hops[uint64_t(source) * n + dest];
+        }
+
+        const uint8_t *row(uint32_t source) const { return &hops[uint64_t(source) * n]; }
+
+        size_t memory() const { return hops.size(); }
+
+        // Dijkstra from every vertex on threads threads (0: all cores).
+        // Every port fits the byte, addEdge refuses any past the limit
+        void compute(const NexthopGraph &g, unsigned threads = 0) {
+            n = g.numVertices();
+            hops.assign(uint64_t(n) * n, NEXTHOP_NONE);
+            if (threads == 0)
+                threads = std::max(1u, std::thread::hardware_concurrency());
+            threads = std::min<unsigned>(threads, std::max<uint32_t>(n, 1));
+
+            std::atomic<uint32_t> next(0);
+            auto worker = [&]() {
+                std::vector<uint64_t> dist;
+                std::vector<uint32_t> queue;
+                uint32_t s;
+                while ((s = next++) < n) {
+                    if (g.uniform())
+                        breadthFirst(g, s, queue);
+                    else
+                        shortestPaths(g, s, dist);
+                }
+            };
+            std::vector<std::thread> pool;
+            for (unsigned t = 1; t < threads; ++t)
+                pool.emplace_back(worker);
+            worker();
+            for (std::thread &t : pool)
+                t.join();
+        }
+
+        bool save(const char *path) const {
+            FILE *out = fopen(path, "wb");
+            if (!out)
+                return false;
+            NexthopMatrixHeader header;
+            memset(&header, 0, sizeof(header));
+            memcpy(header.magic, NEXTHOP_MAGIC, sizeof(NEXTHOP_MAGIC));
+            header.version = NEXTHOP_VERSION;
+            header.numVertices = n;
+            bool ok = fwrite(&header, sizeof(header), 1, out) == 1
+                      && fwrite(hops.data(), 1, hops.size(), out) == hops.size();
+            return fclose(out) == 0 && ok;
+        }
+
+        bool load(const char *path, std::string &error) {
+            FILE *in = fopen(path, "rb");
+            if (!in) {
+                error = std::string("cannot open ") + path;
+                return false;
+            }
+            NexthopMatrixHeader header;
+            if (fread(&header, sizeof(header), 1, in) != 1
+                || strncmp(header.magic, NEXTHOP_MAGIC, sizeof(header.magic)) != 0
+                || header.version != NEXTHOP_VERSION) {
+                error = "not a next-hop matrix";
+                fclose(in);
+                return false;
+            }
+            // The size has to match before trusting numVertices with an
+            // allocation of its square
+            uint64_t cells = uint64_t(header.numVertices) * header.numVertices;
+            if (fseek(in, 0, SEEK_END) != 0 || ftell(in) < 0
+                || uint64_t(ftell(in)) != sizeof(header) + cells
+                || fseek(in, sizeof(header), SEEK_SET) != 0) {
+                error = "size does not match the header, truncated or corrupt";
+                fclose(in);
+                return false;
+            }
+            n = header.numVertices;
+            hops.resize(cells);
+            if (fread(hops.data(), 1, hops.size(), in) != hops.size()) {
+                error = "truncated next-hop matrix";
+                fclose(in);
+                return false;
+            }
+            fclose(in);
+            return true;
+        }
+
+    private:
+        typedef std::pair<uint64_t, uint32_t> Entry;    // (distance, vertex)
+
+        // Shortest paths when every weight is equal, in O(V + E) without
+        // the heap; unreached vertices keep NEXTHOP_NONE
+        void breadthFirst(const NexthopGraph &g, uint32_t src, std::vector<uint32_t> &queue) const {
+            uint8_t *first = const_cast<uint8_t *>(row(src));
+            std::vector<bool> seen(n, false);
+            queue.assign(1, src);
+            seen[src] = true;
+            for (size_t head = 0; head < queue.size(); ++head) {
+                uint32_t u = queue[head];
+                const std::vector<NexthopGraph::Port> &ports = g.ports(u);
+                for (uint32_t p = 0; p < ports.size(); ++p) {
+                    uint32_t v = ports[p].vertex;
+                    if (!seen[v]) {
+                        seen[v] = true;
+                        first[v] = u == src ? p : first[u];
+                        queue.push_back(v);
+                    }
+                }
+            }
+        }
+
+        void shortestPaths(const NexthopGraph &g, uint32_t src, std::vector<uint64_t> &dist) const {
+            const uint64_t INF = std::numeric_limits<uint64_t>::max();
+            dist.assign(n, INF);
+            uint8_t *first = const_cast<uint8_t *>(row(src));   // each thread owns its rows
+
+            std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry> > heap;
+            dist[src] = 0;
+            heap.push(Entry(0, src));
+            while (!heap.empty()) {
+                Entry top = heap.top();
+                heap.pop();
+                uint32_t u = top.second;
+                if (top.first > dist[u])
+                    continue;       // stale, u was settled closer already
+                const std::vector<NexthopGraph::Port> &ports = g.ports(u);
+                for (uint32_t p = 0; p < ports.size(); ++p) {
+                    uint32_t v = ports[p].vertex;
+                    uint64_t d = dist[u] + ports[p].weight;
+                    if (d < dist[v]) {
+                        dist[v] = d;
+                        // Leaving the source the port is the edge itself,
+                        // further on it is whatever reached u
+                        first[v] = u == src ? p : first[u];
+                        heap.push(Entry(d, v));
+                    }
+                }
+            }
+            first[src] = NEXTHOP_NONE;
+        }
+
+        uint32_t n = 0;
+        std::vector<uint8_t> hops;
+};
+
+
+#endif /* NEXTHOP_MATRIX_H */